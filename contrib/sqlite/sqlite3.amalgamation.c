@@ -2080,6 +2080,7 @@ struct PgHdr {
 #define PGHDR_DONT_WRITE        0x020  /* Do not write content to disk */
 
 #define PGHDR_ZERO_COPY         0x040  /* Content was read via xReadZeroCopy and must be released with xReleaseZeroCopy */
+#define PGHDR_RETAINED          0x080  /* Zero-copy content kept while unpinned */
 
 /* Initialize and shutdown the page cache subsystem */
 SQLITE_PRIVATE int sqlite3PcacheInitialize(void);
@@ -2151,6 +2152,11 @@ SQLITE_PRIVATE int sqlite3PcachePageRefcount(PgHdr*);
 /* Return the total number of pages stored in the cache */
 SQLITE_PRIVATE int sqlite3PcachePagecount(PCache*);
 
+/* Set the number of unpinned zero-copy pages the cache may retain, and
+** return the number currently retained. */
+SQLITE_PRIVATE void sqlite3PcacheSetMaxRetainedZeroCopy(PCache*, int);
+SQLITE_PRIVATE int sqlite3PcacheRetainedZeroCopy(PCache*);
+
 #if defined(SQLITE_CHECK_PAGES) || defined(SQLITE_DEBUG)
 /* Iterate through all dirty pages currently stored in the cache. This
 ** interface is only available if SQLITE_CHECK_PAGES is defined when the 
@@ -27047,6 +27053,8 @@ struct PCache {
   void *pStress;                      /* Argument to xStress */
   sqlite3_pcache *pCache;             /* Pluggable cache module */
   PgHdr *pPage1;                      /* Reference to page 1 */
+  int nMaxRetainedZeroCopy;           /* Unpinned zero-copy pages that may keep their content */
+  int nRetainedZeroCopy;              /* Number of pages with PGHDR_RETAINED set */
 };
 
 /*
@@ -27142,6 +27150,23 @@ static void pcacheAddToDirtyList(PgHdr *pPage){
 
 static void unpinZeroCopy(PgHdr* p);
 
+/*
+** Up to PCache.nMaxRetainedZeroCopy pages read with xReadZeroCopy keep
+** their content (and their decoded btree state) while unpinned, and are
+** only released when the page cache recycles or discards them.  A read-only
+** pager discards its whole cache when it begins a read transaction on a
+** changed database, so a retained page is never used with a different
+** snapshot than it was read in.
+*/
+static int pcacheRetainZeroCopy(PgHdr *p){
+  PCache *pCache = p->pCache;
+  if( p->flags & PGHDR_RETAINED ) return 1;
+  if( pCache->nRetainedZeroCopy>=pCache->nMaxRetainedZeroCopy ) return 0;
+  p->flags |= PGHDR_RETAINED;
+  pCache->nRetainedZeroCopy++;
+  return 1;
+}
+
 /*
 ** Wrapper around the pluggable caches xUnpin method. If the cache is
 ** being used for an in-memory database, this function is a no-op.
@@ -27152,7 +27177,7 @@ static void pcacheUnpin(PgHdr *p){
     if( p->pgno==1 ){
       pCache->pPage1 = 0;
     }
-    if( p->flags & PGHDR_ZERO_COPY )
+    if( (p->flags & PGHDR_ZERO_COPY) && !pcacheRetainZeroCopy(p) )
       unpinZeroCopy(p);
     sqlite3GlobalConfig.pcache.xUnpin(pCache->pCache, p, 0);
   }
@@ -27597,6 +27622,21 @@ SQLITE_PRIVATE void sqlite3PcacheSetCachesize(PCache *pCache, int mxPage){
   }
 }
 
+/*
+** Set the number of zero-copy pages that may keep their content while
+** unpinned.  Pages already retained are released as they are recycled.
+*/
+SQLITE_PRIVATE void sqlite3PcacheSetMaxRetainedZeroCopy(PCache *pCache, int nPage){
+  pCache->nMaxRetainedZeroCopy = nPage;
+}
+
+/*
+** Return the number of zero-copy pages whose content is currently held.
+*/
+SQLITE_PRIVATE int sqlite3PcacheRetainedZeroCopy(PCache *pCache){
+  return pCache->nRetainedZeroCopy;
+}
+
 #if defined(SQLITE_CHECK_PAGES) || defined(SQLITE_DEBUG)
 /*
 ** For all dirty pages currently in the cache, invoke the specified
@@ -27915,6 +27955,17 @@ static PgHdr1 *pcache1AllocPage(PCache1 *pCache){
   return p;
 }
 
+/*
+** Release the content of a page that was read with xReadZeroCopy and
+** retained in the cache after being unpinned.
+*/
+static void pcache1ReleaseZeroCopy(PgHdr1 *p){
+  PgHdr *pPg = (PgHdr *)PGHDR1_TO_PAGE(p);
+  if( pPg->pData && (pPg->flags & PGHDR_ZERO_COPY) ){
+    unpinZeroCopy(pPg);
+  }
+}
+
 /*
 ** Free a page object allocated by pcache1AllocPage().
 **
@@ -27925,6 +27976,7 @@ static PgHdr1 *pcache1AllocPage(PCache1 *pCache){
 static void pcache1FreePage(PgHdr1 *p){
   if( ALWAYS(p) ){
     PCache1 *pCache = p->pCache;
+    pcache1ReleaseZeroCopy(p);
     if( pCache->bPurgeable ){
       pCache->pGroup->nCurrentPage--;
     }
@@ -28352,6 +28404,7 @@ static void *pcache1Fetch(sqlite3_pcache *p, unsigned int iKey, int createFlag){
     pPage = pGroup->pLruTail;
     pcache1RemoveFromHash(pPage);
     pcache1PinPage(pPage);
+    pcache1ReleaseZeroCopy(pPage);
     if( (pOtherCache = pPage->pCache)->szPage!=pCache->szPage ){
       pcache1FreePage(pPage);
       pPage = 0;
@@ -31912,7 +31965,44 @@ static void unpinZeroCopy(PgHdr* p) {
   assert (p->pPager->readOnly);
   p->pPager->fd->pMethods->xReleaseZeroCopy(p->pPager->fd, p->pData, p->pPager->pageSize, (p->pgno-1)*(i64)p->pPager->pageSize);
   p->pData = 0;
-  p->flags &= ~PGHDR_ZERO_COPY;
+  if( p->flags & PGHDR_RETAINED ){
+    p->pCache->nRetainedZeroCopy--;
+  }
+  p->flags &= ~(PGHDR_ZERO_COPY|PGHDR_RETAINED);
+}
+
+/*
+** Let each page cache of db retain up to nPage unpinned zero-copy pages.
+** Retained pages keep their xReadZeroCopy buffers, so nPage bounds how
+** much of the VFS's memory one connection can hold.
+*/
+SQLITE_API void sqlite3_retain_zero_copy_pages(sqlite3 *db, int nPage){
+  int i;
+  sqlite3BtreeEnterAll(db);
+  for(i=0; i<db->nDb; i++){
+    Btree *pBt = db->aDb[i].pBt;
+    if( pBt ){
+      sqlite3PcacheSetMaxRetainedZeroCopy(sqlite3BtreePager(pBt)->pPCache, nPage);
+    }
+  }
+  sqlite3BtreeLeaveAll(db);
+}
+
+/*
+** Return the number of zero-copy pages db currently retains while unpinned.
+*/
+SQLITE_API int sqlite3_retained_zero_copy_pages(sqlite3 *db){
+  int i;
+  int nRetained = 0;
+  sqlite3BtreeEnterAll(db);
+  for(i=0; i<db->nDb; i++){
+    Btree *pBt = db->aDb[i].pBt;
+    if( pBt ){
+      nRetained += sqlite3PcacheRetainedZeroCopy(sqlite3BtreePager(pBt)->pPCache);
+    }
+  }
+  sqlite3BtreeLeaveAll(db);
+  return nRetained;
 }
 
 /*
@@ -692,6 +692,16 @@ struct sqlite3_io_methods {
 	int (*xReleaseZeroCopy)(sqlite3_file*, void* data, int iAmt, sqlite3_int64 iOfst);
 };
 
+/*
+** Up to nPage pages of each of db's page caches that were read with
+** xReadZeroCopy stay cached after they are unpinned instead of being
+** released immediately.  They are released with xReleaseZeroCopy when the
+** cache recycles or discards them.  sqlite3_retained_zero_copy_pages()
+** returns the number of such pages db currently holds.
+*/
+SQLITE_API void sqlite3_retain_zero_copy_pages(sqlite3 *db, int nPage);
+SQLITE_API int sqlite3_retained_zero_copy_pages(sqlite3 *db);
+
 /*
 ** CAPI3REF: Standard File Control Opcodes
 **
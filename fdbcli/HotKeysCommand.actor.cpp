@@ -0,0 +1,93 @@
+/*
+ * HotKeysCommand.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbcli/fdbcli.actor.h"
+
+#include "fdbclient/FDBOptions.g.h"
+#include "fdbclient/IClientApi.h"
+#include "fdbclient/SystemData.h"
+
+#include "flow/Arena.h"
+#include "flow/FastRef.h"
+#include "flow/ThreadHelper.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+namespace fdb_cli {
+
+ACTOR Future<bool> hotkeysCommandActor(Reference<IDatabase> db, std::vector<StringRef> tokens) {
+	if (tokens.size() > 3) {
+		printUsage(tokens[0]);
+		return false;
+	}
+	state Key begin = tokens.size() > 1 ? Key(tokens[1]) : Key();
+	state Key end = tokens.size() > 2 ? Key(tokens[2]) : normalKeys.end;
+	if (begin >= end) {
+		fprintf(stderr, "ERROR: `%s' is not before `%s'.\n", printable(begin).c_str(), printable(end).c_str());
+		return false;
+	}
+
+	state Reference<ITransaction> tr = db->createTransaction();
+	loop {
+		try {
+			// Hold the reference to the standalone's memory
+			state ThreadFuture<RangeResult> resultFuture =
+			    tr->getRange(KeyRangeRef(begin.withPrefix(hotKeysRange.begin), end.withPrefix(hotKeysRange.begin)),
+			                 CLIENT_KNOBS->TOO_MANY);
+			RangeResult result = wait(safeThreadFutureToFuture(resultFuture));
+
+			std::vector<std::tuple<double, double, std::string>> hotKeys;
+			for (const auto& kv : result) {
+				json_spirit::mValue statsValue;
+				json_spirit::read_string(kv.value.toString(), statsValue);
+				StatusObjectReader stats(statsValue.get_obj());
+				double readBytesPerSecond = 0, writeBytesPerSecond = 0;
+				stats.get("read_bytes_per_second", readBytesPerSecond);
+				stats.get("write_bytes_per_second", writeBytesPerSecond);
+				hotKeys.emplace_back(
+				    readBytesPerSecond, writeBytesPerSecond, printable(kv.key.removePrefix(hotKeysRange.begin)));
+			}
+			std::sort(hotKeys.begin(), hotKeys.end(), [](const auto& a, const auto& b) {
+				return std::get<0>(a) + std::get<1>(a) > std::get<0>(b) + std::get<1>(b);
+			});
+
+			if (hotKeys.empty()) {
+				printf("No hot keys found.\n");
+			} else {
+				printf("%-16s %-16s %s\n", "Read bytes/s", "Write bytes/s", "Key");
+				for (const auto& [readBytesPerSecond, writeBytesPerSecond, key] : hotKeys) {
+					printf("%-16.0f %-16.0f %s\n", readBytesPerSecond, writeBytesPerSecond, key.c_str());
+				}
+			}
+			return true;
+		} catch (Error& e) {
+			wait(safeThreadFutureToFuture(tr->onError(e)));
+		}
+	}
+}
+
+CommandFactory hotkeysFactory(
+    "hotkeys",
+    CommandHelp("hotkeys [BEGINKEY [ENDKEY]]",
+                "list the keys with the most read and write bandwidth",
+                "Lists the hottest keys in the given range (or in the normal key space if no range is given), as "
+                "estimated by the storage servers over their last measurement interval. The read bandwidth of a range "
+                "read is attributed to the first and last keys it returns."));
+
+} // namespace fdb_cli
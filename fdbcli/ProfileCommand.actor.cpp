@@ -22,6 +22,7 @@
 
 #include "fdbcli/fdbcli.actor.h"
 
+#include "fdbclient/ClientWorkerInterface.h"
 #include "fdbclient/GlobalConfig.actor.h"
 #include "fdbclient/FDBOptions.g.h"
 #include "fdbclient/IClientApi.h"
@@ -35,6 +36,60 @@
 
 namespace fdb_cli {
 
+// Sends a profiler request to the given processes, or to all processes if processes is "all"
+ACTOR static Future<bool> workerProfilerRequest(Reference<ITransaction> tr,
+                                                ProfilerRequest::Type type,
+                                                ProfilerRequest::Action action,
+                                                int duration,
+                                                std::string outputFile,
+                                                std::vector<StringRef> processes) {
+	// Hold the reference to the standalone's memory
+	state ThreadFuture<RangeResult> kvsFuture =
+	    tr->getRange(KeyRangeRef(LiteralStringRef("\xff\xff/worker_interfaces/"),
+	                             LiteralStringRef("\xff\xff/worker_interfaces0")),
+	                 CLIENT_KNOBS->TOO_MANY);
+	RangeResult kvs = wait(safeThreadFutureToFuture(kvsFuture));
+	ASSERT(!kvs.more);
+
+	state bool all = processes.size() == 1 && tokencmp(processes[0], "all");
+	std::set<StringRef> unmatched(processes.begin(), processes.end());
+	state std::vector<std::string> addresses;
+	state std::vector<Future<ErrorOr<Void>>> replies;
+	for (const auto& pair : kvs) {
+		auto ip_port =
+		    (pair.key.endsWith(LiteralStringRef(":tls")) ? pair.key.removeSuffix(LiteralStringRef(":tls")) : pair.key)
+		        .removePrefix(LiteralStringRef("\xff\xff/worker_interfaces/"));
+		if (!all && !unmatched.erase(ip_port)) {
+			continue;
+		}
+		ClientWorkerInterface interf = BinaryReader::fromStringRef<ClientWorkerInterface>(pair.value, IncludeVersion());
+		ProfilerRequest req(type, action, duration);
+		req.outputFile = outputFile;
+		addresses.push_back(printable(ip_port));
+		replies.push_back(errorOr(interf.profiler.getReply(req)));
+	}
+	if (!all && !unmatched.empty()) {
+		for (const auto& process : unmatched) {
+			fprintf(stderr, "ERROR: process '%s' not recognized.\n", printable(process).c_str());
+		}
+		return false;
+	}
+
+	wait(waitForAll(replies));
+	state bool result = true;
+	for (int i = 0; i < replies.size(); i++) {
+		if (replies[i].get().isError()) {
+			fprintf(stderr,
+			        "ERROR: %s: %s: %s\n",
+			        addresses[i].c_str(),
+			        replies[i].get().getError().name(),
+			        replies[i].get().getError().what());
+			result = false;
+		}
+	}
+	return result;
+}
+
 ACTOR Future<bool> profileCommandActor(Database db,
                                        Reference<ITransaction> tr,
                                        std::vector<StringRef> tokens,
@@ -109,6 +164,46 @@ ACTOR Future<bool> profileCommandActor(Database db,
 			fprintf(stderr, "ERROR: Unknown action: %s\n", printable(tokens[2]).c_str());
 			result = false;
 		}
+	} else if (tokencmp(tokens[1], "slowtask") || tokencmp(tokens[1], "alloc")) {
+		state ProfilerRequest::Type type =
+		    tokencmp(tokens[1], "slowtask") ? ProfilerRequest::Type::SLOW_TASK : ProfilerRequest::Type::HEAP;
+		if (tokens.size() >= 4 && tokencmp(tokens[2], "enable")) {
+			bool _result = wait(workerProfilerRequest(tr,
+			                                          type,
+			                                          ProfilerRequest::Action::ENABLE,
+			                                          0,
+			                                          std::string(),
+			                                          std::vector<StringRef>(tokens.begin() + 3, tokens.end())));
+			result = _result;
+		} else if (tokens.size() >= 5 && tokencmp(tokens[2], "disable")) {
+			bool _result = wait(workerProfilerRequest(tr,
+			                                          type,
+			                                          ProfilerRequest::Action::DISABLE,
+			                                          0,
+			                                          tokens[3].toString(),
+			                                          std::vector<StringRef>(tokens.begin() + 4, tokens.end())));
+			result = _result;
+		} else if (tokens.size() >= 6 && tokencmp(tokens[2], "run")) {
+			char* end;
+			int duration = std::strtol((const char*)tokens[3].begin(), &end, 10);
+			if (end != (const char*)tokens[3].end() || duration <= 0) {
+				fprintf(stderr, "ERROR: Failed to parse duration `%s'.\n", printable(tokens[3]).c_str());
+				return false;
+			}
+			bool _result = wait(workerProfilerRequest(tr,
+			                                          type,
+			                                          ProfilerRequest::Action::RUN,
+			                                          duration,
+			                                          tokens[4].toString(),
+			                                          std::vector<StringRef>(tokens.begin() + 5, tokens.end())));
+			result = _result;
+		} else {
+			fprintf(stderr,
+			        "ERROR: Usage: profile %s <enable <PROCESS...>|disable <FILENAME> <PROCESS...>|"
+			        "run <DURATION> <FILENAME> <PROCESS...>>\n",
+			        printable(tokens[1]).c_str());
+			return false;
+		}
 	} else if (tokencmp(tokens[1], "list")) {
 		if (tokens.size() != 2) {
 			fprintf(stderr, "ERROR: Usage: profile list\n");
@@ -136,7 +231,7 @@ ACTOR Future<bool> profileCommandActor(Database db,
 }
 
 CommandFactory profileFactory("profile",
-                              CommandHelp("profile <client|list> <action> <ARGS>",
+                              CommandHelp("profile <client|list|slowtask|alloc> <action> <ARGS>",
                                           "namespace for all the profiling-related commands.",
                                           "Different types support different actions.  Run `profile` to get a list of "
                                           "types, and iteratively explore the help.\n"));
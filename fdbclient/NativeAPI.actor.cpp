@@ -1687,6 +1687,9 @@ DatabaseContext::DatabaseContext(Reference<AsyncVar<Reference<IClusterConnection
 		registerSpecialKeysImpl(SpecialKeySpace::MODULE::METRICS,
 		                        SpecialKeySpace::IMPLTYPE::READONLY,
 		                        std::make_unique<DDStatsRangeImpl>(ddStatsRange));
+		registerSpecialKeysImpl(SpecialKeySpace::MODULE::METRICS,
+		                        SpecialKeySpace::IMPLTYPE::READONLY,
+		                        std::make_unique<HotKeysRangeImpl>(hotKeysRange));
 		registerSpecialKeysImpl(
 		    SpecialKeySpace::MODULE::METRICS,
 		    SpecialKeySpace::IMPLTYPE::READONLY,
@@ -3214,7 +3217,19 @@ TransactionState::TransactionState(Database cx,
                                    SpanContext spanContext,
                                    Reference<TransactionLogInfo> trLogInfo)
   : cx(cx), trLogInfo(trLogInfo), options(cx), taskID(taskID), spanContext(spanContext),
-    readVersionObtainedFromGrvProxy(true), tenant_(tenant), tenantSet(tenant.present()) {}
+    readVersionObtainedFromGrvProxy(true), tenant_(tenant), tenantSet(tenant.present()) {
+	if (tenant.present()) {
+		addTenantTag();
+	}
+}
+
+void TransactionState::addTenantTag() {
+	if (CLIENT_KNOBS->TAG_TENANT_TRANSACTIONS) {
+		TransactionTag tag = tenantTransactionTag(tenant_.get());
+		options.tags.addTag(tag);
+		options.readTags.addTag(tag);
+	}
+}
 
 Reference<TransactionState> TransactionState::cloneAndReset(Reference<TransactionLogInfo> newTrLogInfo,
                                                             bool generateNewSpan) const {
@@ -3277,6 +3292,9 @@ Optional<TenantName> const& TransactionState::tenant() {
 			tenant_ = cx->defaultTenant;
 		}
 		tenantSet = true;
+		if (tenant_.present()) {
+			addTenantTag();
+		}
 		return tenant_;
 	}
 }
@@ -7448,6 +7466,96 @@ ACTOR Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(Da
 	}
 }
 
+// Reads are load balanced across the replicas of a shard, so each replica only measures part of the reads of a key
+// while every replica applies all of its writes. The read rates reported by the replicas are therefore summed, and the
+// largest write rate reported by a replica is used.
+static void mergeHotKeyReplies(std::map<Key, HotKeyMetrics>& merged,
+                               const std::vector<Future<ErrorOr<GetHotKeysReply>>>& replies) {
+	std::map<Key, HotKeyMetrics> shard;
+	for (auto& reply : replies) {
+		if (reply.get().isError()) {
+			continue;
+		}
+		for (auto& metrics : reply.get().get().hotKeys) {
+			auto& m = shard[metrics.key];
+			m.readBytesPerSecond += metrics.readBytesPerSecond;
+			m.writeBytesPerSecond = std::max(m.writeBytesPerSecond, metrics.writeBytesPerSecond);
+		}
+	}
+	merged.insert(shard.begin(), shard.end());
+}
+
+ACTOR Future<Standalone<VectorRef<HotKeyMetrics>>> getHotKeys(Database cx, KeyRange keys, int limit) {
+	state Span span("NAPI:GetHotKeys"_loc);
+	state std::map<Key, HotKeyMetrics> merged;
+	state Key begin = keys.begin;
+	while (begin < keys.end) {
+		state std::vector<KeyRangeLocationInfo> locations =
+		    wait(getKeyRangeLocations(cx,
+		                              TenantInfo(),
+		                              KeyRangeRef(begin, keys.end),
+		                              CLIENT_KNOBS->STORAGE_METRICS_SHARD_LIMIT,
+		                              Reverse::False,
+		                              &StorageServerInterface::getHotKeys,
+		                              span.context,
+		                              Optional<UID>(),
+		                              UseProvisionalProxies::False,
+		                              latestVersion));
+		try {
+			state std::vector<std::vector<Future<ErrorOr<GetHotKeysReply>>>> fReplies(locations.size());
+			state std::vector<Future<Void>> allReplies;
+			for (int i = 0; i < locations.size(); i++) {
+				KeyRangeRef part(std::max<KeyRef>(begin, locations[i].range.begin),
+				                 std::min<KeyRef>(keys.end, locations[i].range.end));
+				GetHotKeysRequest req(part, limit);
+				for (int j = 0; j < locations[i].locations->size(); j++) {
+					fReplies[i].push_back(
+					    locations[i].locations->get(j, &StorageServerInterface::getHotKeys).tryGetReply(req));
+					allReplies.push_back(success(fReplies[i].back()));
+				}
+			}
+			wait(waitForAll(allReplies));
+
+			for (int i = 0; i < locations.size(); i++) {
+				bool answered = false;
+				for (auto& reply : fReplies[i]) {
+					if (reply.get().isError() && reply.get().getError().code() == error_code_wrong_shard_server) {
+						throw wrong_shard_server();
+					}
+					answered = answered || reply.get().present();
+				}
+				if (!answered) {
+					throw all_alternatives_failed();
+				}
+			}
+			for (int i = 0; i < locations.size(); i++) {
+				mergeHotKeyReplies(merged, fReplies[i]);
+			}
+			begin = locations.back().range.end;
+		} catch (Error& e) {
+			if (e.code() != error_code_wrong_shard_server && e.code() != error_code_all_alternatives_failed) {
+				TraceEvent(SevError, "GetHotKeysError").error(e);
+				throw;
+			}
+			cx->invalidateCache(Key(), KeyRangeRef(begin, keys.end));
+			wait(delay(CLIENT_KNOBS->WRONG_SHARD_SERVER_DELAY, TaskPriority::DataDistribution));
+		}
+	}
+
+	std::vector<HotKeyMetrics> sorted;
+	for (auto& [key, metrics] : merged) {
+		sorted.emplace_back(key, metrics.readBytesPerSecond, metrics.writeBytesPerSecond);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const HotKeyMetrics& a, const HotKeyMetrics& b) {
+		return a.totalBytesPerSecond() > b.totalBytesPerSecond();
+	});
+	Standalone<VectorRef<HotKeyMetrics>> result;
+	for (int i = 0; i < sorted.size() && i < limit; i++) {
+		result.push_back_deep(result.arena(), sorted[i]);
+	}
+	return result;
+}
+
 ACTOR Future<std::pair<Optional<StorageMetrics>, int>> waitStorageMetrics(Database cx,
                                                                           KeyRange keys,
                                                                           StorageMetrics min,
@@ -7562,6 +7670,10 @@ Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> DatabaseContext::getReadH
 	return ::getReadHotRanges(Database(Reference<DatabaseContext>::addRef(this)), keys);
 }
 
+Future<Standalone<VectorRef<HotKeyMetrics>>> DatabaseContext::getHotKeys(KeyRange const& keys, int limit) {
+	return ::getHotKeys(Database(Reference<DatabaseContext>::addRef(this)), keys, limit);
+}
+
 ACTOR Future<Standalone<VectorRef<KeyRef>>> getRangeSplitPoints(Reference<TransactionState> trState,
                                                                 KeyRange keys,
                                                                 int64_t chunkSize,
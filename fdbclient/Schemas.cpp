@@ -378,7 +378,21 @@ const KeyRef JSONSchemas::statusSchema = LiteralStringRef(R"statusSchema(
                  "hz":0.0
                }
             },
-            "run_loop_busy":0.2
+            "run_loop_busy":0.2,
+            "endpoint_latencies":{
+               "$map":{
+                  "requests":{
+                     "hz":0.0
+                  },
+                  "errors":{
+                     "hz":0.0
+                  },
+                  "queue_p99_seconds":0.0,
+                  "service_median_seconds":0.0,
+                  "service_p99_seconds":0.0,
+                  "service_max_seconds":0.0
+               }
+            }
          }
       },
       "logs":[
@@ -414,6 +428,11 @@ const KeyRef JSONSchemas::statusSchema = LiteralStringRef(R"statusSchema(
          "batch_performance_limited_by":{
             "reason_server_id":"7f8d623d0cb9966e",
             "reason_id":0,
+            "predicted_seconds_to_limit":1.0,
+            "queue_bytes":0,
+            "queue_target_bytes":0,
+            "input_bytes_per_second":0.0,
+            "durable_bytes_per_second":0.0,
             "name":{
                "$enum":[
                   "workload",
@@ -437,6 +456,11 @@ const KeyRef JSONSchemas::statusSchema = LiteralStringRef(R"statusSchema(
          "performance_limited_by":{
             "reason_server_id":"7f8d623d0cb9966e",
             "reason_id":0,
+            "predicted_seconds_to_limit":1.0,
+            "queue_bytes":0,
+            "queue_target_bytes":0,
+            "input_bytes_per_second":0.0,
+            "durable_bytes_per_second":0.0,
             "name":{
                "$enum":[
                   "workload",
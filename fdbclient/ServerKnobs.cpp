@@ -85,6 +85,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( DISK_QUEUE_FILE_EXTENSION_BYTES,                    10<<20 ); // BUGGIFYd per file within the DiskQueue
 	init( DISK_QUEUE_FILE_SHRINK_BYTES,                      100<<20 ); // BUGGIFYd per file within the DiskQueue
 	init( DISK_QUEUE_MAX_TRUNCATE_BYTES,                     2LL<<30 ); if ( randomize && BUGGIFY ) DISK_QUEUE_MAX_TRUNCATE_BYTES = 0;
+	init( DISK_QUEUE_RECOVERY_READ_BYTES,                      4<<20 ); if ( randomize && BUGGIFY ) DISK_QUEUE_RECOVERY_READ_BYTES = 1<<20;
 	init( TLOG_DEGRADED_DURATION,                                5.0 );
 	init( MAX_CACHE_VERSIONS,                                   10e6 );
 	init( TLOG_IGNORE_POP_AUTO_ENABLE_DELAY,                   300.0 );
@@ -191,6 +192,12 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 		Shard with a read bandwidth smaller than this value will never be too busy to handle the reads.
 	*/
 	init( SHARD_MAX_BYTES_READ_PER_KSEC_JITTER,     0.1 );
+	init( DD_SPLIT_READ_HOT_SHARDS,                            false ); if( randomize && BUGGIFY ) DD_SPLIT_READ_HOT_SHARDS = true;
+	init( DD_READ_HOT_SPLIT_RETRY_DELAY,                        30.0 ); if( randomize && BUGGIFY ) DD_READ_HOT_SPLIT_RETRY_DELAY = 1.0;
+	init( DD_AUTO_CACHE_READ_HOT_RANGES,                       false ); if( randomize && BUGGIFY ) DD_AUTO_CACHE_READ_HOT_RANGES = true;
+	init( DD_AUTO_CACHE_MAX_RANGES,                               10 ); if( randomize && BUGGIFY ) DD_AUTO_CACHE_MAX_RANGES = 1;
+	init( DD_AUTO_CACHE_CHECK_INTERVAL,                         60.0 ); if( randomize && BUGGIFY ) DD_AUTO_CACHE_CHECK_INTERVAL = 5.0;
+	init( DD_AUTO_CACHE_RETIRE_DELAY,                          300.0 ); if( randomize && BUGGIFY ) DD_AUTO_CACHE_RETIRE_DELAY = 10.0;
 	bool buggifySmallBandwidthSplit = randomize && BUGGIFY;
 	init( SHARD_MAX_BYTES_PER_KSEC,                 1LL*1000000*1000 ); if( buggifySmallBandwidthSplit ) SHARD_MAX_BYTES_PER_KSEC = 10LL*1000*1000;
 	/* 1*1MB/sec * 1000sec/ksec
@@ -261,6 +268,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( DD_SHARD_SIZE_GRANULARITY_SIM,                      500000 ); if( randomize && BUGGIFY ) DD_SHARD_SIZE_GRANULARITY_SIM = 0;
 	init( DD_MOVE_KEYS_PARALLELISM,                               15 ); if( randomize && BUGGIFY ) DD_MOVE_KEYS_PARALLELISM = 1;
 	init( DD_FETCH_SOURCE_PARALLELISM,                          1000 ); if( randomize && BUGGIFY ) DD_FETCH_SOURCE_PARALLELISM = 1;
+	init( DD_BATCH_MOVE_MAX_SHARDS,                                1 ); if( randomize && BUGGIFY ) DD_BATCH_MOVE_MAX_SHARDS = deterministicRandom()->randomInt(2, 10);
 	init( DD_MERGE_LIMIT,                                       2000 ); if( randomize && BUGGIFY ) DD_MERGE_LIMIT = 2;
 	init( DD_SHARD_METRICS_TIMEOUT,                             60.0 ); if( randomize && BUGGIFY ) DD_SHARD_METRICS_TIMEOUT = 0.1;
 	init( DD_LOCATION_CACHE_SIZE,                            2000000 ); if( randomize && BUGGIFY ) DD_LOCATION_CACHE_SIZE = 3;
@@ -273,6 +281,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( REMOTE_KV_STORE_MAX_INIT_DURATION,                    10.0 );
 	init( REBALANCE_MAX_RETRIES,                                 100 );
 	init( DD_OVERLAP_PENALTY,                                  10000 );
+	init( DD_TEAM_COLLECTION_INFO_TRACE_DELAY,                   1.0 ); if( randomize && BUGGIFY ) DD_TEAM_COLLECTION_INFO_TRACE_DELAY = 0.0;
 	init( DD_EXCLUDE_MIN_REPLICAS,                                 1 );
 	init( DD_VALIDATE_LOCALITY,                                 true ); if( randomize && BUGGIFY ) DD_VALIDATE_LOCALITY = false;
 	init( DD_CHECK_INVALID_LOCALITY_DELAY,                       60  ); if( randomize && BUGGIFY ) DD_CHECK_INVALID_LOCALITY_DELAY = 1 + deterministicRandom()->random01() * 600;
@@ -314,6 +323,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( SQLITE_CHUNK_SIZE_PAGES,                             25600 );  // 100MB
 	init( SQLITE_CHUNK_SIZE_PAGES_SIM,                          1024 );  // 4MB
 	init( SQLITE_READER_THREADS,                                  64 );  // number of read threads
+	init( SQLITE_READER_RETAIN_ZERO_COPY_PAGES,                false ); if( randomize && BUGGIFY ) SQLITE_READER_RETAIN_ZERO_COPY_PAGES = true;
+	init( SQLITE_READER_CACHE_PAGES,                             500 ); if( randomize && BUGGIFY ) SQLITE_READER_CACHE_PAGES = deterministicRandom()->randomInt(10, 100);
 	init( SQLITE_WRITE_WINDOW_SECONDS,                            -1 );
 	init( SQLITE_CURSOR_MAX_LIFETIME_BYTES,                      1e6 ); if (buggifySmallShards || simulationMediumShards) SQLITE_CURSOR_MAX_LIFETIME_BYTES = MIN_SHARD_BYTES; if( randomize && BUGGIFY ) SQLITE_CURSOR_MAX_LIFETIME_BYTES = 0;
 	init( SQLITE_WRITE_WINDOW_LIMIT,                              -1 );
@@ -363,6 +374,18 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 
 	// KeyValueStoreMemory
 	init( REPLACE_CONTENTS_BYTES,                                1e5 );
+	init( KVS_MEMORY_RECOVERY_BULK_INSERT,                      true ); if( randomize && BUGGIFY ) KVS_MEMORY_RECOVERY_BULK_INSERT = false;
+	init( KVS_MEMORY_RECOVERY_PREFETCH_HEADERS,                 true ); if( randomize && BUGGIFY ) KVS_MEMORY_RECOVERY_PREFETCH_HEADERS = false;
+	init( KVS_MEMORY_ADAPTIVE_SNAPSHOT,                        false ); if( randomize && BUGGIFY ) KVS_MEMORY_ADAPTIVE_SNAPSHOT = true;
+	init( KVS_MEMORY_RECOVERY_BYTES_PER_SECOND,                100e6 );
+	init( KVS_MEMORY_SNAPSHOT_TARGET_RECOVERY_TIME,             60.0 ); if( randomize && BUGGIFY ) KVS_MEMORY_SNAPSHOT_TARGET_RECOVERY_TIME = 0.1 + deterministicRandom()->random01() * 10;
+	init( KVS_MEMORY_SNAPSHOT_MAX_LOG_TO_DATA_RATIO,             4.0 );
+	init( KVS_MEMORY_SNAPSHOT_DISK_BYTES_PER_SECOND,           100e6 ); if( randomize && BUGGIFY ) KVS_MEMORY_SNAPSHOT_DISK_BYTES_PER_SECOND = 1e5;
+	init( KVS_MEMORY_SNAPSHOT_MIN_RATE,                          0.0 );
+	init( KVS_MEMORY_SNAPSHOT_MAX_RATE,                          4.0 );
+	init( KVS_MEMORY_SNAPSHOT_RATE_SMOOTHING,                    5.0 );
+	init( KVS_MEMORY_SNAPSHOT_METRICS_INTERVAL,                 30.0 );
+	init( KVS_MEMORY_SNAPSHOT_IDLE_INTERVAL,                     1.0 );
 
 	// KeyValueStoreRocksDB
 	init( ROCKSDB_BACKGROUND_PARALLELISM,                          4 );
@@ -466,11 +489,18 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( PROXY_COMPUTE_BUCKETS,                                20000 );
 	init( PROXY_COMPUTE_GROWTH_RATE,                             0.01 );
 	init( TXN_STATE_SEND_AMOUNT,                                    4 );
+	init( TXN_STATE_PIPELINED_BROADCAST,                        false ); if( randomize && BUGGIFY ) TXN_STATE_PIPELINED_BROADCAST = deterministicRandom()->coinflip();
 	init( REPORT_TRANSACTION_COST_ESTIMATION_DELAY,               0.1 );
 	init( PROXY_REJECT_BATCH_QUEUED_TOO_LONG,                    true );
 
         bool buggfyUseResolverPrivateMutations = randomize && BUGGIFY && !ENABLE_VERSION_VECTOR_TLOG_UNICAST;
 	init( PROXY_USE_RESOLVER_PRIVATE_MUTATIONS,                 false ); if( buggfyUseResolverPrivateMutations ) PROXY_USE_RESOLVER_PRIVATE_MUTATIONS = deterministicRandom()->coinflip();
+	init( PROXY_USE_KEY_ROUTING_INDEX,                           true ); if( randomize && BUGGIFY ) PROXY_USE_KEY_ROUTING_INDEX = deterministicRandom()->coinflip();
+	init( PROXY_EARLY_CONFLICT_CHECK,                           false ); if( randomize && BUGGIFY ) PROXY_EARLY_CONFLICT_CHECK = deterministicRandom()->coinflip();
+	init( PROXY_EARLY_CONFLICT_WINDOW_VERSIONS,     VERSIONS_PER_SECOND ); if( randomize && BUGGIFY ) PROXY_EARLY_CONFLICT_WINDOW_VERSIONS = deterministicRandom()->randomInt(1, 5 * VERSIONS_PER_SECOND);
+	init( PROXY_EARLY_CONFLICT_FILTER_SLOTS,                    65536 ); if( randomize && BUGGIFY ) PROXY_EARLY_CONFLICT_FILTER_SLOTS = deterministicRandom()->randomInt(1, 16);
+	init( COMMIT_PROXY_HELPER_THREADS,                              0 ); if( randomize && BUGGIFY ) COMMIT_PROXY_HELPER_THREADS = deterministicRandom()->randomInt(1, 4);
+	init( COMMIT_PROXY_HELPER_THREAD_MIN_ITEMS,                  1000 ); if( randomize && BUGGIFY ) COMMIT_PROXY_HELPER_THREAD_MIN_ITEMS = deterministicRandom()->randomInt(1, 10);
 
 	init( RESET_MASTER_BATCHES,                                   200 );
 	init( RESET_RESOLVER_BATCHES,                                 200 );
@@ -489,6 +519,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( KEY_BYTES_PER_SAMPLE,                                  2e4 ); if( fastBalancing ) KEY_BYTES_PER_SAMPLE = 1e3;
 	init( MIN_BALANCE_TIME,                                      0.2 );
 	init( MIN_BALANCE_DIFFERENCE,                                1e6 ); if( fastBalancing ) MIN_BALANCE_DIFFERENCE = 1e4;
+	init( RESOLUTION_BALANCE_USE_LOAD_MODEL,                   false ); if( randomize && BUGGIFY ) RESOLUTION_BALANCE_USE_LOAD_MODEL = true;
+	init( RESOLUTION_BALANCE_LOAD_SMOOTHING,                     0.5 );
+	init( RESOLUTION_BALANCE_MIN_IMBALANCE,                      0.2 ); if( fastBalancing ) RESOLUTION_BALANCE_MIN_IMBALANCE = 0.05;
 	init( SECONDS_BEFORE_NO_FAILURE_DELAY,                  8 * 3600 );
 	init( MAX_TXS_SEND_MEMORY,                                   1e7 ); if( randomize && BUGGIFY ) MAX_TXS_SEND_MEMORY = 1e5;
 	init( MAX_RECOVERY_VERSIONS,           200 * VERSIONS_PER_SECOND );
@@ -609,6 +642,8 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( RATEKEEPER_PRINT_LIMIT_REASON,                       false ); if( randomize && BUGGIFY ) RATEKEEPER_PRINT_LIMIT_REASON = true;
 	init( RATEKEEPER_MIN_RATE,                                   0.0 );
 	init( RATEKEEPER_MAX_RATE,                                   1e9 );
+	init( RATEKEEPER_PREDICTIVE_CONTROL,                       false ); if( randomize && BUGGIFY ) RATEKEEPER_PREDICTIVE_CONTROL = true;
+	init( RATEKEEPER_PREDICTION_HORIZON,                        10.0 ); if( randomize && BUGGIFY ) RATEKEEPER_PREDICTION_HORIZON = deterministicRandom()->randomInt(1, 30);
 
 	bool smallStorageTarget = randomize && BUGGIFY;
 	init( TARGET_BYTES_PER_STORAGE_SERVER,                    1000e6 ); if( smallStorageTarget ) TARGET_BYTES_PER_STORAGE_SERVER = 3000e3;
@@ -697,6 +732,9 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( EMPTY_READ_PENALTY,                                   20 ); // 20 bytes
 	init( DD_SHARD_COMPARE_LIMIT,                               1000 );
 	init( READ_SAMPLING_ENABLED,                                false ); if ( randomize && BUGGIFY ) READ_SAMPLING_ENABLED = true;// enable/disable read sampling
+	init( HOT_KEY_SKETCH_CAPACITY,                              100 ); if ( randomize && BUGGIFY ) HOT_KEY_SKETCH_CAPACITY = 5;
+	init( HOT_KEY_SAMPLE_RATE,                                  0.1 ); if ( randomize && BUGGIFY ) HOT_KEY_SAMPLE_RATE = 1.0;
+	init( HOT_KEY_INTERVAL,                                     10.0 ); if ( randomize && BUGGIFY ) HOT_KEY_INTERVAL = 1.0;
 
 	//Storage Server
 	init( STORAGE_LOGGING_DELAY,                                 5.0 );
@@ -750,6 +788,7 @@ void ServerKnobs::initialize(Randomize randomize, ClientKnobs* clientKnobs, IsSi
 	init( QUICK_GET_KEY_VALUES_LIMIT,                           2000 );
 	init( QUICK_GET_KEY_VALUES_LIMIT_BYTES,                      1e7 );
 	init( STORAGE_SERVER_SHARD_AWARE,                           true );
+	init( STORAGE_SERVER_READ_CACHE_BYTES,                         0 ); if( randomize && BUGGIFY ) STORAGE_SERVER_READ_CACHE_BYTES = deterministicRandom()->randomInt(1, 1e6); // 0 disables the cache
 
 	//Wait Failure
 	init( MAX_OUTSTANDING_WAIT_FAILURE_REQUESTS,                 250 ); if( randomize && BUGGIFY ) MAX_OUTSTANDING_WAIT_FAILURE_REQUESTS = 2;
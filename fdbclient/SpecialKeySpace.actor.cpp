@@ -747,6 +747,41 @@ Future<RangeResult> DDStatsRangeImpl::getRange(ReadYourWritesTransaction* ryw,
 	return ddMetricsGetRangeActor(ryw, kr);
 }
 
+ACTOR Future<RangeResult> hotKeysGetRangeActor(ReadYourWritesTransaction* ryw, KeyRangeRef kr) {
+	state KeyRange keys = kr.removePrefix(hotKeysRange.begin);
+	if (keys.begin >= systemKeys.end) {
+		return RangeResult();
+	}
+	Standalone<VectorRef<HotKeyMetrics>> hotKeys =
+	    wait(ryw->getDatabase()->getHotKeys(KeyRangeRef(keys.begin, std::min(keys.end, systemKeys.end)),
+	                                        CLIENT_KNOBS->HOT_KEYS_LIMIT));
+	// The hot keys are ordered by bandwidth, but a range read must return its keys in order
+	std::vector<HotKeyMetrics> sorted(hotKeys.begin(), hotKeys.end());
+	std::sort(sorted.begin(), sorted.end(), [](const HotKeyMetrics& a, const HotKeyMetrics& b) {
+		return a.key < b.key;
+	});
+	RangeResult result;
+	for (const auto& metrics : sorted) {
+		KeyRef key = metrics.key.withPrefix(hotKeysRange.begin, result.arena());
+		json_spirit::mObject statsObj;
+		statsObj["read_bytes_per_second"] = metrics.readBytesPerSecond;
+		statsObj["write_bytes_per_second"] = metrics.writeBytesPerSecond;
+		std::string statsString =
+		    json_spirit::write_string(json_spirit::mValue(statsObj), json_spirit::Output_options::raw_utf8);
+		ValueRef value(result.arena(), statsString);
+		result.push_back(result.arena(), KeyValueRef(key, value));
+	}
+	return result;
+}
+
+HotKeysRangeImpl::HotKeysRangeImpl(KeyRangeRef kr) : SpecialKeyRangeAsyncImpl(kr) {}
+
+Future<RangeResult> HotKeysRangeImpl::getRange(ReadYourWritesTransaction* ryw,
+                                               KeyRangeRef kr,
+                                               GetRangeLimits limitsHint) const {
+	return hotKeysGetRangeActor(ryw, kr);
+}
+
 Key SpecialKeySpace::getManagementApiCommandOptionSpecialKey(const std::string& command, const std::string& option) {
 	Key prefix = LiteralStringRef("options/").withPrefix(moduleToBoundary[MODULE::MANAGEMENT].begin);
 	auto pair = command + "/" + option;
@@ -363,6 +363,7 @@ const Value storageCacheServerValue(const StorageServerInterface& ssi) {
 
 const KeyRangeRef ddStatsRange = KeyRangeRef(LiteralStringRef("\xff\xff/metrics/data_distribution_stats/"),
                                              LiteralStringRef("\xff\xff/metrics/data_distribution_stats/\xff\xff"));
+const KeyRangeRef hotKeysRange = KeyRangeRef("\xff\xff/metrics/hot_keys/"_sr, "\xff\xff/metrics/hot_keys/\xff\xff"_sr);
 
 //    "\xff/storageCache/[[begin]]" := "[[vector<uint16_t>]]"
 const KeyRangeRef storageCacheKeys(LiteralStringRef("\xff/storageCache/"), LiteralStringRef("\xff/storageCache0"));
@@ -386,6 +387,18 @@ void decodeStorageCacheValue(const ValueRef& value, std::vector<uint16_t>& serve
 	}
 }
 
+//    "\xff/storageCacheAuto/[[begin]]" := "[[end]]"
+const KeyRangeRef autoCachedRangeKeys(LiteralStringRef("\xff/storageCacheAuto/"),
+                                      LiteralStringRef("\xff/storageCacheAuto0"));
+
+const Key autoCachedRangeKeyFor(const KeyRef& begin) {
+	return begin.withPrefix(autoCachedRangeKeys.begin);
+}
+
+KeyRef decodeAutoCachedRangeKey(const KeyRef& key) {
+	return key.removePrefix(autoCachedRangeKeys.begin);
+}
+
 const Value logsValue(const std::vector<std::pair<UID, NetworkAddress>>& logs,
                       const std::vector<std::pair<UID, NetworkAddress>>& oldLogs) {
 	BinaryWriter wr(IncludeVersion(ProtocolVersion::withLogsValue()));
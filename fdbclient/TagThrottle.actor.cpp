@@ -23,11 +23,29 @@
 #include "fdbclient/SystemData.h"
 #include "fdbclient/TagThrottle.actor.h"
 #include "fdbclient/Tuple.h"
+#include "flow/Hash3.h"
 
 #include "flow/actorcompiler.h" // has to be last include
 
 double const ClientTagThrottleLimits::NO_EXPIRATION = std::numeric_limits<double>::max();
 
+const StringRef tenantTransactionTagPrefix = "\xfft"_sr;
+
+// Tenant names that do not fit in a tag keep a readable prefix and are disambiguated by a hash of the full name
+TransactionTag tenantTransactionTag(StringRef tenantName) {
+	int const maxNameLength = CLIENT_KNOBS->MAX_TRANSACTION_TAG_LENGTH - tenantTransactionTagPrefix.size();
+	if (tenantName.size() <= maxNameLength) {
+		return tenantName.withPrefix(tenantTransactionTagPrefix);
+	}
+	std::string hash = format("%08x", hashlittle(tenantName.begin(), tenantName.size(), 0));
+	StringRef truncatedName = tenantName.substr(0, maxNameLength - hash.size());
+	return truncatedName.withPrefix(tenantTransactionTagPrefix).withSuffix(StringRef(hash));
+}
+
+bool isTenantTransactionTag(TransactionTagRef tag) {
+	return tag.startsWith(tenantTransactionTagPrefix);
+}
+
 void TagSet::addTag(TransactionTagRef tag) {
 	ASSERT(CLIENT_KNOBS->MAX_TRANSACTION_TAG_LENGTH < 256); // Tag length is encoded with a single byte
 	ASSERT(CLIENT_KNOBS->MAX_TAGS_PER_TRANSACTION < 256); // Number of tags is encoded with a single byte
@@ -35,7 +53,9 @@ void TagSet::addTag(TransactionTagRef tag) {
 	if (tag.size() > CLIENT_KNOBS->MAX_TRANSACTION_TAG_LENGTH) {
 		throw tag_too_long();
 	}
-	if (tags.size() >= CLIENT_KNOBS->MAX_TAGS_PER_TRANSACTION) {
+	if (!isTenantTransactionTag(tag) &&
+	    std::count_if(tags.begin(), tags.end(), [](auto const& t) { return !isTenantTransactionTag(t); }) >=
+	        CLIENT_KNOBS->MAX_TAGS_PER_TRANSACTION) {
 		throw too_many_tags();
 	}
 
@@ -192,3 +212,30 @@ TEST_CASE("TagSet/toString") {
 	}
 	return Void();
 }
+
+TEST_CASE("TagSet/tenantTags") {
+	TransactionTag shortTag = tenantTransactionTag("tenant"_sr);
+	ASSERT(shortTag == "tenant"_sr.withPrefix(tenantTransactionTagPrefix));
+	ASSERT(isTenantTransactionTag(shortTag) && !isTenantTransactionTag("tenant"_sr));
+
+	// Long tenant names still fit in a tag, and differ if the names differ after the truncated prefix
+	TransactionTag longTag1 = tenantTransactionTag("a_tenant_with_a_long_name_1"_sr);
+	TransactionTag longTag2 = tenantTransactionTag("a_tenant_with_a_long_name_2"_sr);
+	ASSERT(longTag1.size() == CLIENT_KNOBS->MAX_TRANSACTION_TAG_LENGTH && isTenantTransactionTag(longTag1));
+	ASSERT(longTag1 != longTag2);
+
+	// Tenant tags do not count against the limit on the number of tags
+	TagSet tagSet;
+	for (int i = 0; i < CLIENT_KNOBS->MAX_TAGS_PER_TRANSACTION; ++i) {
+		tagSet.addTag(StringRef(format("tag%d", i)));
+	}
+	tagSet.addTag(shortTag);
+	ASSERT(tagSet.size() == CLIENT_KNOBS->MAX_TAGS_PER_TRANSACTION + 1);
+	try {
+		tagSet.addTag("oneTooMany"_sr);
+		ASSERT(false);
+	} catch (Error& e) {
+		ASSERT(e.code() == error_code_too_many_tags);
+	}
+	return Void();
+}
@@ -97,6 +97,7 @@ public:
 	int SHARD_COUNT_LIMIT;
 	double STORAGE_METRICS_UNFAIR_SPLIT_LIMIT;
 	double STORAGE_METRICS_TOO_MANY_SHARDS_DELAY;
+	int HOT_KEYS_LIMIT; // the number of hot keys read from \xff\xff/metrics/hot_keys/
 	double AGGREGATE_HEALTH_METRICS_MAX_STALENESS;
 	double DETAILED_HEALTH_METRICS_MAX_STALENESS;
 	double MID_SHARD_SIZE_MAX_STALENESS;
@@ -251,6 +252,7 @@ public:
 	// transaction tags
 	int MAX_TRANSACTION_TAG_LENGTH;
 	int MAX_TAGS_PER_TRANSACTION;
+	bool TAG_TENANT_TRANSACTIONS; // Tag transactions with their tenant, so that tenants are accounted and throttled
 	int COMMIT_SAMPLE_COST; // The expectation of sampling is every COMMIT_SAMPLE_COST sample once
 	int WRITE_COST_BYTE_FACTOR;
 	int INCOMPLETE_SHARD_PLUS; // The size of (possible) incomplete shard when estimate clear range
@@ -72,6 +72,8 @@ struct ProfilerRequest {
 		GPROF = 1,
 		FLOW = 2,
 		GPROF_HEAP = 3,
+		SLOW_TASK = 4,
+		HEAP = 5,
 	};
 
 	enum class Action : std::int8_t { DISABLE = 0, ENABLE = 1, RUN = 2 };
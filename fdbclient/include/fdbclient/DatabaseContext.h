@@ -313,6 +313,8 @@ public:
 	                                                          Optional<int> const& minSplitBytes = {});
 
 	Future<Standalone<VectorRef<ReadHotRangeWithMetrics>>> getReadHotRanges(KeyRange const& keys);
+	// Returns the keys in keys with the most read and write bandwidth, as measured by the storage servers
+	Future<Standalone<VectorRef<HotKeyMetrics>>> getHotKeys(KeyRange const& keys, int limit);
 
 	// Returns the protocol version reported by the coordinator this client is connected to
 	// If an expected version is given, the future won't return until the protocol version is different than expected
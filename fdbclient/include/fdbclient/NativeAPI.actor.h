@@ -297,6 +297,9 @@ private:
 	Optional<TenantName> tenant_;
 	int64_t tenantId_ = TenantInfo::INVALID_TENANT;
 	bool tenantSet;
+
+	// Tags the transaction with its tenant (see tenantTransactionTag)
+	void addTenantTag();
 };
 
 class Transaction : NonCopyable {
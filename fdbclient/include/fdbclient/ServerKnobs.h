@@ -89,6 +89,7 @@ public:
 	int64_t DISK_QUEUE_FILE_EXTENSION_BYTES; // When we grow the disk queue, by how many bytes should it grow?
 	int64_t DISK_QUEUE_FILE_SHRINK_BYTES; // When we shrink the disk queue, by how many bytes should it shrink?
 	int64_t DISK_QUEUE_MAX_TRUNCATE_BYTES; // A truncate larger than this will cause the file to be replaced instead.
+	int DISK_QUEUE_RECOVERY_READ_BYTES; // Size of each sequential read issued while recovering a DiskQueue
 	double TLOG_DEGRADED_DURATION;
 	int64_t MAX_CACHE_VERSIONS;
 	double TXS_POPPED_MAX_DELAY;
@@ -176,6 +177,12 @@ public:
 	double SHARD_MAX_READ_DENSITY_RATIO;
 	int64_t SHARD_READ_HOT_BANDWIDTH_MIN_PER_KSECONDS;
 	double SHARD_MAX_BYTES_READ_PER_KSEC_JITTER;
+	bool DD_SPLIT_READ_HOT_SHARDS; // Split read hot shards so that their hot pieces can move to less read loaded teams
+	double DD_READ_HOT_SPLIT_RETRY_DELAY; // Delay before retrying to split a read hot shard that could not be split
+	bool DD_AUTO_CACHE_READ_HOT_RANGES; // Assign read hot ranges to storage cache servers, if there are any
+	int DD_AUTO_CACHE_MAX_RANGES; // Maximum number of ranges cached automatically at once
+	double DD_AUTO_CACHE_CHECK_INTERVAL; // How often automatically cached ranges are checked for read hotness
+	double DD_AUTO_CACHE_RETIRE_DELAY; // Automatically cached ranges are uncached after being cold for this long
 	double STORAGE_METRIC_TIMEOUT;
 	double METRIC_DELAY;
 	double ALL_DATA_REMOVED_DELAY;
@@ -207,6 +214,7 @@ public:
 	int64_t DD_SHARD_SIZE_GRANULARITY_SIM;
 	int DD_MOVE_KEYS_PARALLELISM;
 	int DD_FETCH_SOURCE_PARALLELISM;
+	int DD_BATCH_MOVE_MAX_SHARDS; // Adjacent queued health relocations off the same team moved together; 1 disables
 	int DD_MERGE_LIMIT;
 	double DD_SHARD_METRICS_TIMEOUT;
 	int64_t DD_LOCATION_CACHE_SIZE;
@@ -214,6 +222,7 @@ public:
 	double DEBOUNCE_RECRUITING_DELAY;
 	int REBALANCE_MAX_RETRIES;
 	int DD_OVERLAP_PENALTY;
+	double DD_TEAM_COLLECTION_INFO_TRACE_DELAY; // TeamCollectionInfo requests within this delay are traced once
 	int DD_EXCLUDE_MIN_REPLICAS;
 	bool DD_VALIDATE_LOCALITY;
 	int DD_CHECK_INVALID_LOCALITY_DELAY;
@@ -277,6 +286,8 @@ public:
 	int SQLITE_CHUNK_SIZE_PAGES;
 	int SQLITE_CHUNK_SIZE_PAGES_SIM;
 	int SQLITE_READER_THREADS;
+	bool SQLITE_READER_RETAIN_ZERO_COPY_PAGES; // Readers keep decoded zero-copy pages cached until their snapshot changes
+	int SQLITE_READER_CACHE_PAGES; // Page cache size of each reader connection when retaining zero-copy pages
 	int SQLITE_WRITE_WINDOW_LIMIT;
 	double SQLITE_WRITE_WINDOW_SECONDS;
 	int64_t SQLITE_CURSOR_MAX_LIFETIME_BYTES;
@@ -296,6 +307,19 @@ public:
 
 	// KeyValueStoreMemory
 	int64_t REPLACE_CONTENTS_BYTES;
+	bool KVS_MEMORY_RECOVERY_BULK_INSERT; // Apply recovered snapshot items to the container with sorted bulk inserts
+	bool KVS_MEMORY_RECOVERY_PREFETCH_HEADERS; // Read the next op header along with the current op's payload
+	bool KVS_MEMORY_ADAPTIVE_SNAPSHOT; // Pace snapshots by recovery time and spare disk bandwidth instead of 1:1 with
+	                                   // committed bytes
+	double KVS_MEMORY_RECOVERY_BYTES_PER_SECOND; // Assumed log replay throughput, for estimating recovery time
+	double KVS_MEMORY_SNAPSHOT_TARGET_RECOVERY_TIME;
+	double KVS_MEMORY_SNAPSHOT_MAX_LOG_TO_DATA_RATIO;
+	double KVS_MEMORY_SNAPSHOT_DISK_BYTES_PER_SECOND; // Disk write bandwidth shared by commits and snapshots
+	double KVS_MEMORY_SNAPSHOT_MIN_RATE; // Snapshot bytes per committed byte while within targets; 0 pauses
+	double KVS_MEMORY_SNAPSHOT_MAX_RATE;
+	double KVS_MEMORY_SNAPSHOT_RATE_SMOOTHING;
+	double KVS_MEMORY_SNAPSHOT_METRICS_INTERVAL;
+	double KVS_MEMORY_SNAPSHOT_IDLE_INTERVAL; // How often an idle store adds spare disk bandwidth to the snapshot budget
 
 	// KeyValueStoreRocksDB
 	int ROCKSDB_BACKGROUND_PARALLELISM;
@@ -388,9 +412,19 @@ public:
 	int PROXY_COMPUTE_BUCKETS;
 	double PROXY_COMPUTE_GROWTH_RATE;
 	int TXN_STATE_SEND_AMOUNT;
+	bool TXN_STATE_PIPELINED_BROADCAST; // At recovery, forward txnStateStore parts to the rest of the broadcast tree
+	                                    // before applying them, and keep MAX_TXS_SEND_MEMORY of parts in flight
 	double REPORT_TRANSACTION_COST_ESTIMATION_DELAY;
 	bool PROXY_REJECT_BATCH_QUEUED_TOO_LONG;
 	bool PROXY_USE_RESOLVER_PRIVATE_MUTATIONS;
+	bool PROXY_USE_KEY_ROUTING_INDEX; // Route the single key mutations of a batch by merging their sorted keys with the
+	                                  // proxy's flat copy of the shard boundaries
+	bool PROXY_EARLY_CONFLICT_CHECK; // Reject transactions that read keys the proxy committed writes to after their
+	                                 // read versions without resolving them
+	int64_t PROXY_EARLY_CONFLICT_WINDOW_VERSIONS; // How long the proxy remembers the keys it committed writes to
+	int PROXY_EARLY_CONFLICT_FILTER_SLOTS; // Size of the hashed array that filters lookups of recently written keys
+	int COMMIT_PROXY_HELPER_THREADS; // Threads that look up tags and resolvers for large commit batches, 0 to disable
+	int COMMIT_PROXY_HELPER_THREAD_MIN_ITEMS; // Batches with fewer mutations or conflict ranges are handled inline
 
 	int RESET_MASTER_BATCHES;
 	int RESET_RESOLVER_BATCHES;
@@ -405,6 +439,10 @@ public:
 	double COMMIT_SLEEP_TIME;
 	double MIN_BALANCE_TIME;
 	int64_t MIN_BALANCE_DIFFERENCE;
+	bool RESOLUTION_BALANCE_USE_LOAD_MODEL; // Balance resolvers by their conflict detection CPU time, or by their
+	                                        // conflict range counts in simulation, instead of their key samples
+	double RESOLUTION_BALANCE_LOAD_SMOOTHING; // Weight of the latest round in the smoothed resolver loads
+	double RESOLUTION_BALANCE_MIN_IMBALANCE; // Resolver load difference, relative to the mean, that triggers a move
 	double SECONDS_BEFORE_NO_FAILURE_DELAY;
 	int64_t MAX_TXS_SEND_MEMORY;
 	int64_t MAX_RECOVERY_VERSIONS;
@@ -546,6 +584,8 @@ public:
 	bool RATEKEEPER_PRINT_LIMIT_REASON;
 	double RATEKEEPER_MIN_RATE;
 	double RATEKEEPER_MAX_RATE;
+	bool RATEKEEPER_PREDICTIVE_CONTROL; // Limit queues by their predicted time to reach the target instead of the spring
+	double RATEKEEPER_PREDICTION_HORIZON; // Seconds ahead over which a queue may grow to its target
 
 	int64_t TARGET_BYTES_PER_STORAGE_SERVER;
 	int64_t SPRING_BYTES_STORAGE_SERVER;
@@ -659,6 +699,9 @@ public:
 	int64_t EMPTY_READ_PENALTY;
 	int DD_SHARD_COMPARE_LIMIT; // when read-aware DD is enabled, at most how many shards are compared together
 	bool READ_SAMPLING_ENABLED;
+	int HOT_KEY_SKETCH_CAPACITY; // the number of keys each storage server hot key sketch tracks
+	double HOT_KEY_SAMPLE_RATE; // the fraction of reads and writes added to the hot key sketches
+	double HOT_KEY_INTERVAL; // the hot key sketches report the rates over the last interval of this many seconds
 
 	// Storage Server
 	double STORAGE_LOGGING_DELAY;
@@ -712,6 +755,7 @@ public:
 	int QUICK_GET_KEY_VALUES_LIMIT;
 	int QUICK_GET_KEY_VALUES_LIMIT_BYTES;
 	bool STORAGE_SERVER_SHARD_AWARE;
+	int64_t STORAGE_SERVER_READ_CACHE_BYTES; // Size of the storage server's cache of point reads from the storage engine
 
 	// Wait Failure
 	int MAX_OUTSTANDING_WAIT_FAILURE_REQUESTS;
@@ -327,6 +327,15 @@ public:
 	                             GetRangeLimits limitsHint) const override;
 };
 
+// The hottest keys of the range by read and write bandwidth, as measured by the storage servers
+class HotKeysRangeImpl : public SpecialKeyRangeAsyncImpl {
+public:
+	explicit HotKeysRangeImpl(KeyRangeRef kr);
+	Future<RangeResult> getRange(ReadYourWritesTransaction* ryw,
+	                             KeyRangeRef kr,
+	                             GetRangeLimits limitsHint) const override;
+};
+
 class ManagementCommandsOptionsImpl : public SpecialKeyRangeRWImpl {
 public:
 	explicit ManagementCommandsOptionsImpl(KeyRangeRef kr);
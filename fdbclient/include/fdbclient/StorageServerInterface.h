@@ -122,6 +122,7 @@ struct StorageServerInterface {
 	RequestStream<struct FetchCheckpointKeyValuesRequest> fetchCheckpointKeyValues;
 
 	RequestStream<struct UpdateCommitCostRequest> updateCommitCostRequest;
+	RequestStream<struct GetHotKeysRequest> getHotKeys;
 
 private:
 	bool acceptingRequests;
@@ -194,6 +195,7 @@ public:
 				    getValue.getEndpoint().getAdjustedEndpoint(21));
 				updateCommitCostRequest =
 				    RequestStream<struct UpdateCommitCostRequest>(getValue.getEndpoint().getAdjustedEndpoint(22));
+				getHotKeys = RequestStream<struct GetHotKeysRequest>(getValue.getEndpoint().getAdjustedEndpoint(23));
 			}
 		} else {
 			ASSERT(Ar::isDeserializing);
@@ -245,6 +247,7 @@ public:
 		streams.push_back(fetchCheckpoint.getReceiver());
 		streams.push_back(fetchCheckpointKeyValues.getReceiver());
 		streams.push_back(updateCommitCostRequest.getReceiver());
+		streams.push_back(getHotKeys.getReceiver());
 		FlowTransport::transport().addEndpoints(streams);
 	}
 };
@@ -818,6 +821,54 @@ struct ReadHotSubRangeRequest {
 	}
 };
 
+// The estimated read and write bandwidth of a key, as measured by the hot key sketch of a storage server
+struct HotKeyMetrics {
+	KeyRef key;
+	double readBytesPerSecond = 0;
+	double writeBytesPerSecond = 0;
+
+	HotKeyMetrics() = default;
+	HotKeyMetrics(KeyRef key, double readBytesPerSecond, double writeBytesPerSecond)
+	  : key(key), readBytesPerSecond(readBytesPerSecond), writeBytesPerSecond(writeBytesPerSecond) {}
+	HotKeyMetrics(Arena& arena, const HotKeyMetrics& rhs)
+	  : key(arena, rhs.key), readBytesPerSecond(rhs.readBytesPerSecond), writeBytesPerSecond(rhs.writeBytesPerSecond) {}
+
+	double totalBytesPerSecond() const { return readBytesPerSecond + writeBytesPerSecond; }
+	int expectedSize() const { return key.expectedSize() + sizeof(readBytesPerSecond) + sizeof(writeBytesPerSecond); }
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, key, readBytesPerSecond, writeBytesPerSecond);
+	}
+};
+
+struct GetHotKeysReply {
+	constexpr static FileIdentifier file_identifier = 4717394;
+	// In decreasing order of total bandwidth
+	Standalone<VectorRef<HotKeyMetrics>> hotKeys;
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, hotKeys);
+	}
+};
+
+struct GetHotKeysRequest {
+	constexpr static FileIdentifier file_identifier = 12870539;
+	Arena arena;
+	KeyRangeRef keys;
+	int limit;
+	ReplyPromise<GetHotKeysReply> reply;
+
+	GetHotKeysRequest() : limit(0) {}
+	GetHotKeysRequest(KeyRangeRef const& keys, int limit) : keys(arena, keys), limit(limit) {}
+
+	template <class Ar>
+	void serialize(Ar& ar) {
+		serializer(ar, keys, limit, reply, arena);
+	}
+};
+
 struct SplitRangeReply {
 	constexpr static FileIdentifier file_identifier = 11813134;
 	// If the given range can be divided, contains the split points.
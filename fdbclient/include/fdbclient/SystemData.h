@@ -125,6 +125,12 @@ const Key storageCacheKey(const KeyRef& k);
 const Value storageCacheValue(const std::vector<uint16_t>& serverIndices);
 void decodeStorageCacheValue(const ValueRef& value, std::vector<uint16_t>& serverIndices);
 
+//    "\xff/storageCacheAuto/[[begin]]" := "[[end]]"
+// Ranges which data distribution cached because they were read hot, and which it will uncache when they cool down.
+extern const KeyRangeRef autoCachedRangeKeys;
+const Key autoCachedRangeKeyFor(const KeyRef& begin);
+KeyRef decodeAutoCachedRangeKey(const KeyRef& key);
+
 //    "\xff/serverKeys/[[serverID]]/[[begin]]" := "[[serverKeysTrue]]" |" [[serverKeysFalse]]"
 //	An internal mapping of what shards any given server currently has ownership of
 //	Using the serverID as a prefix, then followed by the beginning of the shard range
@@ -149,6 +155,7 @@ extern const ValueRef conflictingKeysTrue, conflictingKeysFalse;
 extern const KeyRangeRef writeConflictRangeKeysRange;
 extern const KeyRangeRef readConflictRangeKeysRange;
 extern const KeyRangeRef ddStatsRange;
+extern const KeyRangeRef hotKeysRange;
 
 extern const KeyRef cacheKeysPrefix;
 
@@ -43,6 +43,13 @@ typedef Standalone<TransactionTagRef> TransactionTag;
 FDB_DECLARE_BOOLEAN_PARAM(ContainsRecommended);
 FDB_DECLARE_BOOLEAN_PARAM(Capitalize);
 
+// Transactions on a tenant are tagged with a tag derived from the tenant name, so that storage servers, commit proxies
+// and ratekeeper account for (and throttle) each tenant the same way as a tag set by the client. Tenant tags do not
+// count towards MAX_TAGS_PER_TRANSACTION.
+extern const StringRef tenantTransactionTagPrefix;
+TransactionTag tenantTransactionTag(StringRef tenantName);
+bool isTenantTransactionTag(TransactionTagRef tag);
+
 class TagSet {
 public:
 	typedef std::vector<TransactionTagRef>::const_iterator const_iterator;
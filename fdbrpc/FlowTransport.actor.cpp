@@ -28,6 +28,7 @@
 #include <memcheck.h>
 #endif
 
+#include <boost/core/demangle.hpp>
 #include <boost/unordered_map.hpp>
 
 #include "fdbrpc/TokenSign.h"
@@ -55,6 +56,7 @@ namespace {
 NetworkAddressList g_currentDeliveryPeerAddress = NetworkAddressList();
 bool g_currentDeliverPeerAddressTrusted = false;
 Future<Void> g_currentDeliveryPeerDisconnect;
+Reference<EndpointLatencyStats> g_currentDeliveryLatencyStats;
 
 } // namespace
 
@@ -74,6 +76,8 @@ public:
 	                       std::vector<std::pair<FlowReceiver*, TaskPriority>> const& streams);
 	NetworkMessageReceiver* get(Endpoint::Token const& token);
 	TaskPriority getPriority(Endpoint::Token const& token);
+	// Returns the latency stats slot of the endpoint token, which must be in the map
+	Reference<EndpointLatencyStats>& latencyStats(Endpoint::Token const& token);
 	void remove(Endpoint::Token const& token, NetworkMessageReceiver* r);
 
 private:
@@ -86,6 +90,7 @@ private:
 			uint32_t nextFree;
 		};
 		NetworkMessageReceiver* receiver = nullptr;
+		Reference<EndpointLatencyStats> latencyStats;
 		Endpoint::Token& token() { return *(Endpoint::Token*)uid; }
 	};
 	int wellKnownEndpointCount;
@@ -193,14 +198,22 @@ TaskPriority EndpointMap::getPriority(Endpoint::Token const& token) {
 	return TaskPriority::UnknownEndpoint;
 }
 
+Reference<EndpointLatencyStats>& EndpointMap::latencyStats(Endpoint::Token const& token) {
+	uint32_t index = token.second();
+	ASSERT(index < data.size() && data[index].receiver);
+	return data[index].latencyStats;
+}
+
 void EndpointMap::remove(Endpoint::Token const& token, NetworkMessageReceiver* r) {
 	uint32_t index = token.second();
 	if (index < wellKnownEndpointCount) {
 		data[index].receiver = nullptr;
+		data[index].latencyStats.clear();
 	} else if (index < data.size() && data[index].token().first() == token.first() &&
 	           ((data[index].token().second() & 0xffffffff00000000LL) | index) == token.second() &&
 	           data[index].receiver == r) {
 		data[index].receiver = 0;
+		data[index].latencyStats.clear();
 		data[index].nextFree = firstFree;
 		firstFree = index;
 	}
@@ -307,6 +320,8 @@ public:
 	Reference<struct Peer> getPeer(NetworkAddress const& address);
 	Reference<struct Peer> getOrOpenPeer(NetworkAddress const& address, bool startConnectionKeeper = true);
 
+	Reference<EndpointLatencyStats> getLatencyStats(Endpoint::Token const& token, NetworkMessageReceiver* receiver);
+
 	// Returns true if given network address 'address' is one of the address we are listening on.
 	bool isLocalAddress(const NetworkAddress& address) const;
 
@@ -341,6 +356,11 @@ public:
 
 	Future<Void> multiVersionCleanup;
 	Future<Void> pingLogger;
+	Future<Void> latencyLogger;
+
+	// The latency stats of every endpoint that has received a request, including endpoints that were since removed
+	// but whose stats have not been logged yet
+	std::vector<Reference<EndpointLatencyStats>> endpointLatencyStats;
 
 	std::unordered_map<Standalone<StringRef>, PublicKey> publicKeys;
 };
@@ -402,12 +422,123 @@ ACTOR Future<Void> pingLatencyLogger(TransportData* self) {
 	}
 }
 
+EndpointLatencyStats::EndpointLatencyStats(std::string typeName)
+  : typeName(typeName), requests(0), errors(0),
+    queueTime(FLOW_KNOBS->ENDPOINT_LATENCY_ERROR_GUARANTEE, 1e-6, 1000.0),
+    serviceTime(FLOW_KNOBS->ENDPOINT_LATENCY_ERROR_GUARANTEE, 1e-6, 1000.0) {}
+
+void EndpointLatencyStats::clear() {
+	requests = 0;
+	errors = 0;
+	queueTime.clear();
+	serviceTime.clear();
+}
+
+// Returns the type of request a receiver accepts. Request streams are NetNotifiedQueue<Request, IsPublic>, so their
+// request type is the first template argument.
+static std::string endpointTypeName(NetworkMessageReceiver* receiver) {
+	std::string name = boost::core::demangle(typeid(*receiver).name());
+	size_t begin = name.find('<');
+	size_t end = name.rfind(',');
+	if (begin == std::string::npos || end == std::string::npos || end < begin) {
+		return name;
+	}
+	return name.substr(begin + 1, end - begin - 1);
+}
+
+Reference<EndpointLatencyStats> TransportData::getLatencyStats(Endpoint::Token const& token,
+                                                               NetworkMessageReceiver* receiver) {
+	Reference<EndpointLatencyStats>& stats = endpoints.latencyStats(token);
+	if (!stats) {
+		stats = makeReference<EndpointLatencyStats>(endpointTypeName(receiver));
+		endpointLatencyStats.push_back(stats);
+	}
+	return stats;
+}
+
+// Logs the request count and latencies of the endpoints of each request type, and the busiest request types for status
+ACTOR Future<Void> endpointLatencyLogger(TransportData* self) {
+	state double lastLogged = now();
+	loop {
+		wait(delay(FLOW_KNOBS->ENDPOINT_LATENCY_LOGGING_INTERVAL));
+		double elapsed = now() - lastLogged;
+		lastLogged = now();
+
+		// Endpoints receiving the same type of request, such as those of two storage servers, are reported together
+		std::map<std::string, std::pair<int, Reference<EndpointLatencyStats>>> byType;
+		for (auto& stats : self->endpointLatencyStats) {
+			if (stats->requests == 0) {
+				continue;
+			}
+			auto& [endpoints, merged] = byType[stats->typeName];
+			if (!merged) {
+				merged = makeReference<EndpointLatencyStats>(stats->typeName);
+			}
+			++endpoints;
+			merged->requests += stats->requests;
+			merged->errors += stats->errors;
+			merged->queueTime.mergeWith(stats->queueTime);
+			merged->serviceTime.mergeWith(stats->serviceTime);
+			stats->clear();
+		}
+		// The stats of a removed endpoint are only referenced here once all of its requests have been replied to
+		self->endpointLatencyStats.erase(std::remove_if(self->endpointLatencyStats.begin(),
+		                                                self->endpointLatencyStats.end(),
+		                                                [](auto const& stats) { return stats->isSoleOwner(); }),
+		                                 self->endpointLatencyStats.end());
+
+		std::vector<Reference<EndpointLatencyStats>> busiest;
+		for (auto& [typeName, entry] : byType) {
+			auto const& [endpoints, merged] = entry;
+			TraceEvent("EndpointLatency")
+			    .detail("Type", typeName)
+			    .detail("Endpoints", endpoints)
+			    .detail("Elapsed", elapsed)
+			    .detail("Requests", merged->requests)
+			    .detail("Errors", merged->errors)
+			    .detail("QueueMedian", merged->queueTime.median())
+			    .detail("QueueP99", merged->queueTime.percentile(0.99))
+			    .detail("QueueMax", merged->queueTime.max())
+			    .detail("Replies", merged->serviceTime.getPopulationSize())
+			    .detail("ServiceMean", merged->serviceTime.mean())
+			    .detail("ServiceMedian", merged->serviceTime.median())
+			    .detail("ServiceP90", merged->serviceTime.percentile(0.90))
+			    .detail("ServiceP99", merged->serviceTime.percentile(0.99))
+			    .detail("ServiceMax", merged->serviceTime.max())
+			    .detail("ErrorGuarantee", merged->serviceTime.getErrorGuarantee())
+			    .detail("ServiceBuckets", merged->serviceTime.bucketsString());
+			busiest.push_back(merged);
+		}
+
+		std::sort(busiest.begin(), busiest.end(), [](auto const& a, auto const& b) {
+			return a->requests > b->requests;
+		});
+		busiest.resize(std::min<size_t>(busiest.size(), FLOW_KNOBS->ENDPOINT_LATENCY_STATUS_TYPES));
+		TraceEvent ev("EndpointLatencyMetrics");
+		ev.detail("Elapsed", elapsed).detail("Types", busiest.size());
+		for (int i = 0; i < busiest.size(); i++) {
+			std::string prefix = format("Endpoint%d", i);
+			ev.detail(std::string(prefix), busiest[i]->typeName)
+			    .detail(prefix + "Requests", busiest[i]->requests)
+			    .detail(prefix + "Errors", busiest[i]->errors)
+			    .detail(prefix + "QueueP99", busiest[i]->queueTime.percentile(0.99))
+			    .detail(prefix + "ServiceMedian", busiest[i]->serviceTime.median())
+			    .detail(prefix + "ServiceP99", busiest[i]->serviceTime.percentile(0.99))
+			    .detail(prefix + "ServiceMax", busiest[i]->serviceTime.max());
+		}
+		ev.trackLatest("EndpointLatencyMetrics");
+	}
+}
+
 TransportData::TransportData(uint64_t transportId, int maxWellKnownEndpoints, IPAllowList const* allowList)
   : warnAlwaysForLargePacket(true), endpoints(maxWellKnownEndpoints), endpointNotFoundReceiver(endpoints),
     pingReceiver(endpoints), numIncompatibleConnections(0), lastIncompatibleMessage(0), transportId(transportId),
     allowList(allowList == nullptr ? IPAllowList() : *allowList) {
 	degraded = makeReference<AsyncVar<bool>>(false);
 	pingLogger = pingLatencyLogger(this);
+	if (FLOW_KNOBS->ENDPOINT_LATENCY_TRACKING) {
+		latencyLogger = endpointLatencyLogger(this);
+	}
 }
 
 #define CONNECT_PACKET_V0 0x0FDB00A444020001LL
@@ -1008,7 +1139,8 @@ ACTOR static void deliver(TransportData* self,
                           NetworkAddress peerAddress,
                           bool isTrustedPeer,
                           InReadSocket inReadSocket,
-                          Future<Void> disconnect) {
+                          Future<Void> disconnect,
+                          double receivedTime) {
 	// We want to run the task at the right priority. If the priority is higher than the current priority (which is
 	// ReadSocket) we can just upgrade. Otherwise we'll context switch so that we don't block other tasks that might run
 	// with a higher priority. ReplyPromiseStream needs to guarantee that messages are received in the order they were
@@ -1025,6 +1157,12 @@ ACTOR static void deliver(TransportData* self,
 		if (!checkCompatible(receiver->peerCompatibilityPolicy(), reader.protocolVersion())) {
 			return;
 		}
+		if (FLOW_KNOBS->ENDPOINT_LATENCY_TRACKING && (destination.token.first() & TOKEN_STREAM_FLAG)) {
+			// Replies are not requests, so only the endpoints of request streams are tracked
+			g_currentDeliveryLatencyStats = self->getLatencyStats(destination.token, receiver);
+			++g_currentDeliveryLatencyStats->requests;
+			g_currentDeliveryLatencyStats->queueTime.addSample(now() - receivedTime);
+		}
 		try {
 			ASSERT(g_currentDeliveryPeerAddress == NetworkAddressList());
 			ASSERT(!g_currentDeliverPeerAddressTrusted);
@@ -1038,10 +1176,12 @@ ACTOR static void deliver(TransportData* self,
 			g_currentDeliveryPeerAddress = NetworkAddressList();
 			g_currentDeliverPeerAddressTrusted = false;
 			g_currentDeliveryPeerDisconnect = Future<Void>();
+			g_currentDeliveryLatencyStats.clear();
 		} catch (Error& e) {
 			g_currentDeliveryPeerAddress = NetworkAddressList();
 			g_currentDeliverPeerAddressTrusted = false;
 			g_currentDeliveryPeerDisconnect = Future<Void>();
+			g_currentDeliveryLatencyStats.clear();
 			TraceEvent(SevError, "ReceiverError")
 			    .error(e)
 			    .detail("Token", destination.token.toString())
@@ -1212,7 +1352,8 @@ static void scanPackets(TransportData* transport,
 			        peerAddress,
 			        isTrustedPeer,
 			        InReadSocket::True,
-			        disconnect);
+			        disconnect,
+			        now());
 		}
 
 		unprocessed_begin = p = p + packetLen;
@@ -1637,6 +1778,10 @@ Future<Void> FlowTransport::loadedDisconnect() {
 	return g_currentDeliveryPeerDisconnect;
 }
 
+Reference<EndpointLatencyStats> FlowTransport::loadedLatencyStats() {
+	return g_currentDeliveryLatencyStats;
+}
+
 void FlowTransport::addPeerReference(const Endpoint& endpoint, bool isStream) {
 	if (!isStream || !endpoint.getPrimaryAddress().isValid() || !endpoint.getPrimaryAddress().isPublic())
 		return;
@@ -1717,7 +1862,8 @@ static void sendLocal(TransportData* self, ISerializeSource const& what, const E
 		        NetworkAddress(),
 		        true,
 		        InReadSocket::False,
-		        Never());
+		        Never(),
+		        now());
 	}
 }
 
@@ -1966,3 +2112,38 @@ void FlowTransport::removePublicKey(StringRef name) {
 void FlowTransport::removeAllPublicKeys() {
 	self->publicKeys.clear();
 }
+
+TEST_CASE("/fdbrpc/DDSketch/percentiles") {
+	state double errorGuarantee = deterministicRandom()->randomChoice(std::vector<double>{ 0.005, 0.01, 0.02, 0.05 });
+	state DDSketch sketch(errorGuarantee, 1e-6, 1000.0);
+	state DDSketch other(errorGuarantee, 1e-6, 1000.0);
+	state std::vector<double> samples;
+
+	// Latencies spread over several orders of magnitude, split between two sketches that are merged
+	for (int i = 0; i < 10000; i++) {
+		double sample = pow(10.0, deterministicRandom()->random01() * 7 - 5);
+		samples.push_back(sample);
+		(i % 2 ? sketch : other).addSample(sample);
+	}
+	sketch.mergeWith(other);
+	std::sort(samples.begin(), samples.end());
+	ASSERT(sketch.getPopulationSize() == samples.size());
+	ASSERT(sketch.min() == samples.front() && sketch.max() == samples.back());
+
+	for (double p : { 0.0, 0.01, 0.25, 0.5, 0.9, 0.99, 0.999, 1.0 }) {
+		double expected = samples[(uint64_t)(p * (samples.size() - 1))];
+		double actual = sketch.percentile(p);
+		ASSERT(fabs(actual - expected) <= expected * errorGuarantee * (1 + 1e-9));
+	}
+
+	// Every value is within the error guarantee of the value of its bucket
+	for (int i = 0; i < 1000; i++) {
+		double value = pow(10.0, deterministicRandom()->random01() * 9 - 6);
+		double bucketValue = sketch.getValue(sketch.getIndex(value));
+		ASSERT(fabs(bucketValue - value) <= value * errorGuarantee * (1 + 1e-9));
+	}
+
+	sketch.clear();
+	ASSERT(sketch.getPopulationSize() == 0 && sketch.percentile(0.5) == 0 && sketch.bucketsString().empty());
+	return Void();
+}
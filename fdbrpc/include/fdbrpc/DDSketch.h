@@ -0,0 +1,157 @@
+/*
+ * DDSketch.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBRPC_DDSKETCH_H
+#define FDBRPC_DDSKETCH_H
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "flow/Error.h"
+#include "flow/flow.h"
+
+// A log-linear histogram as described in https://arxiv.org/pdf/1908.10693.pdf. Every percentile it reports is within
+// a relative error of errorGuarantee of the true percentile. The bucket of a sample is computed with the same cubically
+// interpolated logarithm as contrib/ddsketch_calc.py, so bucket indexes logged by bucketsString() can be converted to
+// values (and merged across processes) with the contrib/ddsketch_* scripts.
+//
+// Unlike a general DDSketch, only samples in [minValue, maxValue] get their own bucket, which keeps the sketch small
+// enough to keep one per endpoint. Smaller samples are counted in the first bucket and larger ones in the last.
+class DDSketch {
+public:
+	DDSketch(double errorGuarantee, double minValue, double maxValue)
+	  : errorGuarantee(errorGuarantee), gamma((1.0 + errorGuarantee) / (1.0 - errorGuarantee)),
+	    multiplier(correctingFactor * log(2) / log(gamma)) {
+		offset = (int)ceil(fastlog(1.0 / EPS) * multiplier);
+		firstIndex = getIndex(minValue);
+		buckets.resize(getIndex(maxValue) - firstIndex + 1, 0);
+		clear();
+	}
+
+	DDSketch& addSample(double sample) {
+		int index = std::clamp(sample > EPS ? getIndex(sample) : firstIndex, firstIndex, lastIndex()) - firstIndex;
+		buckets[index]++;
+		populationSize++;
+		sum += sample;
+		minSample = std::min(minSample, sample);
+		maxSample = std::max(maxSample, sample);
+		return *this;
+	}
+
+	DDSketch& mergeWith(const DDSketch& other) {
+		ASSERT(firstIndex == other.firstIndex && buckets.size() == other.buckets.size());
+		for (int i = 0; i < buckets.size(); i++) {
+			buckets[i] += other.buckets[i];
+		}
+		populationSize += other.populationSize;
+		sum += other.sum;
+		minSample = std::min(minSample, other.minSample);
+		maxSample = std::max(maxSample, other.maxSample);
+		return *this;
+	}
+
+	uint64_t getPopulationSize() const { return populationSize; }
+	double mean() const { return populationSize ? sum / populationSize : 0; }
+	double min() const { return populationSize ? minSample : 0; }
+	double max() const { return populationSize ? maxSample : 0; }
+	double median() const { return percentile(0.5); }
+
+	double percentile(double p) const {
+		ASSERT(p >= 0 && p <= 1);
+		if (!populationSize) {
+			return 0;
+		}
+		uint64_t target = p * (populationSize - 1);
+		uint64_t count = 0;
+		for (int i = 0; i < buckets.size(); i++) {
+			count += buckets[i];
+			if (count > target) {
+				// The bucket value may be slightly outside of the samples seen, so clamp it to what was seen
+				return std::clamp(getValue(i + firstIndex), minSample, maxSample);
+			}
+		}
+		return maxSample;
+	}
+
+	void clear() {
+		std::fill(buckets.begin(), buckets.end(), 0);
+		populationSize = 0;
+		sum = 0;
+		minSample = std::numeric_limits<double>::max();
+		maxSample = 0;
+	}
+
+	// Returns the non-empty buckets as a space separated list of index:count pairs
+	std::string bucketsString() const {
+		std::string s;
+		for (int i = 0; i < buckets.size(); i++) {
+			if (buckets[i]) {
+				if (!s.empty()) {
+					s += ' ';
+				}
+				s += format("%d:%llu", i + firstIndex, (unsigned long long)buckets[i]);
+			}
+		}
+		return s;
+	}
+
+	double getErrorGuarantee() const { return errorGuarantee; }
+
+	int getIndex(double sample) const { return (int)ceil(fastlog(sample) * multiplier) + offset; }
+	double getValue(int index) const { return reverseLog((index - offset) / multiplier) * 2.0 / (1 + gamma); }
+
+private:
+	// log(x) / log(2) approximated by a cubic function of the significand of x. See CubicallyInterpolatedMapping.java
+	// in https://github.com/DataDog/sketches-java/
+	static constexpr double correctingFactor = 1.00988652862227438516; // = 7 / (10 * log(2));
+	static constexpr double A = 6.0 / 35.0, B = -3.0 / 5.0, C = 10.0 / 7.0;
+	static constexpr double EPS = 1e-18;
+
+	static double fastlog(double value) {
+		int e;
+		double s = frexp(value, &e);
+		s = s * 2 - 1;
+		return ((A * s + B) * s + C) * s + e - 1;
+	}
+
+	static double reverseLog(double index) {
+		long exponent = floor(index);
+		// Derived from Cardano's formula
+		double d0 = B * B - 3 * A * C;
+		double d1 = 2 * B * B * B - 9 * A * B * C - 27 * A * A * (index - exponent);
+		double p = cbrt((d1 - sqrt(d1 * d1 - 4 * d0 * d0 * d0)) / 2);
+		double significandPlusOne = -(B + p + d0 / p) / (3 * A) + 1;
+		return ldexp(significandPlusOne / 2, exponent + 1);
+	}
+
+	int lastIndex() const { return firstIndex + buckets.size() - 1; }
+
+	double errorGuarantee, gamma, multiplier;
+	int offset, firstIndex;
+	std::vector<uint32_t> buckets;
+	uint64_t populationSize;
+	double sum, minSample, maxSample;
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include <algorithm>
 
 #include "fdbrpc/ContinuousSample.h"
+#include "fdbrpc/DDSketch.h"
 #include "fdbrpc/HealthMonitor.h"
 #include "flow/genericactors.actor.h"
 #include "flow/network.h"
@@ -138,6 +139,24 @@ public:
 	}
 };
 
+// The requests delivered to a request stream endpoint and their latencies, recorded by FlowTransport for every stream
+// endpoint. Both latencies are in seconds.
+struct EndpointLatencyStats : ReferenceCounted<EndpointLatencyStats> {
+	std::string typeName; // The type of request the endpoint receives
+	int64_t requests;
+	int64_t errors; // Replies that were errors
+	DDSketch queueTime; // From reading a request off the network to delivering it to the endpoint
+	DDSketch serviceTime; // From delivering a request to sending its reply
+
+	explicit EndpointLatencyStats(std::string typeName);
+
+	void addReply(double seconds, bool isError) {
+		serviceTime.addSample(seconds);
+		errors += isError;
+	}
+	void clear();
+};
+
 class TransportData;
 
 struct Peer : public ReferenceCounted<Peer> {
@@ -286,6 +305,8 @@ public:
 
 	Endpoint loadedEndpoint(const UID& token);
 	Future<Void> loadedDisconnect();
+	// The latency stats of the request stream endpoint a message is being delivered to, if any
+	Reference<EndpointLatencyStats> loadedLatencyStats();
 
 	HealthMonitor* healthMonitor();
 
@@ -195,7 +195,7 @@ void load(Ar& ar, ReplyPromise<T>& value) {
 	ar >> token;
 	Endpoint endpoint = FlowTransport::transport().loadedEndpoint(token);
 	value = ReplyPromise<T>(endpoint);
-	networkSender(value.getFuture(), endpoint);
+	networkSender(value.getFuture(), endpoint, FlowTransport::transport().loadedLatencyStats());
 }
 
 template <class T>
@@ -207,7 +207,7 @@ struct serializable_traits<ReplyPromise<T>> : std::true_type {
 			serializer(ar, token);
 			auto endpoint = FlowTransport::transport().loadedEndpoint(token);
 			p = ReplyPromise<T>(endpoint);
-			networkSender(p.getFuture(), endpoint);
+			networkSender(p.getFuture(), endpoint, FlowTransport::transport().loadedLatencyStats());
 		} else {
 			const auto& ep = p.getEndpoint().token;
 			serializer(ar, ep);
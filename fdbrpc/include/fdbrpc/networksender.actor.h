@@ -30,11 +30,16 @@
 #include "flow/flow.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
-// This actor is used by FlowTransport to serialize the response to a ReplyPromise across the network
+// This actor is used by FlowTransport to serialize the response to a ReplyPromise across the network. If the reply is
+// to a request delivered to a request stream, its service time is recorded in latencyStats.
 ACTOR template <class T>
-void networkSender(Future<T> input, Endpoint endpoint) {
+void networkSender(Future<T> input, Endpoint endpoint, Reference<EndpointLatencyStats> latencyStats) {
+	state double deliveredTime = now();
 	try {
 		T value = wait(input);
+		if (latencyStats) {
+			latencyStats->addReply(now() - deliveredTime, false);
+		}
 		FlowTransport::transport().sendUnreliable(SerializeSource<ErrorOr<EnsureTable<T>>>(value), endpoint, false);
 	} catch (Error& err) {
 		// if (err.code() == error_code_broken_promise) return;
@@ -42,6 +47,9 @@ void networkSender(Future<T> input, Endpoint endpoint) {
 			return;
 		}
 		ASSERT(err.code() != error_code_actor_cancelled);
+		if (latencyStats) {
+			latencyStats->addReply(now() - deliveredTime, true);
+		}
 		FlowTransport::transport().sendUnreliable(SerializeSource<ErrorOr<EnsureTable<T>>>(err), endpoint, false);
 	}
 }
@@ -1197,7 +1197,11 @@ ACTOR Future<Void> sendInitialCommitToResolvers(Reference<ClusterRecoveryData> s
 	        ->readRange(txnKeys, BUGGIFY ? 3 : SERVER_KNOBS->DESIRED_TOTAL_BYTES, SERVER_KNOBS->DESIRED_TOTAL_BYTES)
 	        .get();
 	state std::vector<Future<Void>> txnReplies;
+	state std::vector<int64_t> txnBytes;
+	state int txnAcknowledged = 0;
 	state int64_t dataOutstanding = 0;
+	state int64_t dataSent = 0;
+	state double broadcastStart = now();
 
 	state std::vector<Endpoint> endpoints;
 	for (auto& it : self->commitProxies) {
@@ -1225,24 +1229,37 @@ ACTOR Future<Void> sendInitialCommitToResolvers(Reference<ClusterRecoveryData> s
 		req.last = !nextData.size();
 		req.broadcastInfo = endpoints;
 		txnReplies.push_back(broadcastTxnRequest(req, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, false));
-		dataOutstanding += SERVER_KNOBS->TXN_STATE_SEND_AMOUNT * data.arena().getSize();
+		txnBytes.push_back(SERVER_KNOBS->TXN_STATE_SEND_AMOUNT * data.arena().getSize());
+		dataOutstanding += txnBytes.back();
+		dataSent += data.arena().getSize();
 		data = nextData;
 		txnSequence++;
 
-		if (dataOutstanding > SERVER_KNOBS->MAX_TXS_SEND_MEMORY) {
+		if (SERVER_KNOBS->TXN_STATE_PIPELINED_BROADCAST) {
+			// Waits only for the oldest parts, so that the broadcast tree always has parts to apply
+			while (dataOutstanding > SERVER_KNOBS->MAX_TXS_SEND_MEMORY) {
+				wait(txnReplies[txnAcknowledged]);
+				dataOutstanding -= txnBytes[txnAcknowledged++];
+			}
+		} else if (dataOutstanding > SERVER_KNOBS->MAX_TXS_SEND_MEMORY) {
 			wait(waitForAll(txnReplies));
 			txnReplies = std::vector<Future<Void>>();
+			txnBytes = std::vector<int64_t>();
 			dataOutstanding = 0;
 		}
 
 		wait(yield());
 	}
 	wait(waitForAll(txnReplies));
+	self->txnStateBroadcastDuration = now() - broadcastStart;
 	TraceEvent("RecoveryInternal", self->dbgid)
 	    .detail("StatusCode", RecoveryStatus::recovery_transaction)
 	    .detail("Status", RecoveryStatus::names[RecoveryStatus::recovery_transaction])
 	    .detail("RecoveryTxnVersion", self->recoveryTransactionVersion)
 	    .detail("LastEpochEnd", self->lastEpochEnd)
+	    .detail("Parts", txnSequence)
+	    .detail("Bytes", dataSent)
+	    .detail("Duration", self->txnStateBroadcastDuration)
 	    .detail("Step", "SentTxnStateStoreToCommitProxies");
 
 	std::vector<Future<ResolveTransactionBatchReply>> replies;
@@ -1513,6 +1530,7 @@ ACTOR Future<Void> clusterRecoveryCore(Reference<ClusterRecoveryData> self) {
 	    .trackLatest(self->swVersionCheckedEventHolder->trackingKey);
 
 	self->recoveryState = RecoveryState::RECRUITING;
+	state double recruitingStartTime = now();
 
 	state std::vector<StorageServerInterface> seedServers;
 	state std::vector<Standalone<CommitTransactionRef>> initialConfChanges;
@@ -1565,6 +1583,7 @@ ACTOR Future<Void> clusterRecoveryCore(Reference<ClusterRecoveryData> self) {
 	ASSERT_GE(self->resolvers.size(), 1);
 
 	self->recoveryState = RecoveryState::RECOVERY_TRANSACTION;
+	state double recoveryTransactionStartTime = now();
 	TraceEvent(getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_STATE_EVENT_NAME).c_str(), self->dbgid)
 	    .detail("StatusCode", RecoveryStatus::recovery_transaction)
 	    .detail("Status", RecoveryStatus::names[RecoveryStatus::recovery_transaction])
@@ -1694,6 +1713,7 @@ ACTOR Future<Void> clusterRecoveryCore(Reference<ClusterRecoveryData> self) {
 	ASSERT(self->recoveryTransactionVersion != 0);
 
 	self->recoveryState = RecoveryState::WRITING_CSTATE;
+	state double writingCStateStartTime = now();
 	TraceEvent(getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_STATE_EVENT_NAME).c_str(), self->dbgid)
 	    .detail("StatusCode", RecoveryStatus::writing_coordinated_state)
 	    .detail("Status", RecoveryStatus::names[RecoveryStatus::writing_coordinated_state])
@@ -1735,6 +1755,10 @@ ACTOR Future<Void> clusterRecoveryCore(Reference<ClusterRecoveryData> self) {
 	           getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_DURATION_EVENT_NAME).c_str(),
 	           self->dbgid)
 	    .detail("RecoveryDuration", recoveryDuration)
+	    .detail("RecruitingDuration", recoveryTransactionStartTime - recruitingStartTime)
+	    .detail("RecoveryTransactionDuration", writingCStateStartTime - recoveryTransactionStartTime)
+	    .detail("TxnStateBroadcastDuration", self->txnStateBroadcastDuration)
+	    .detail("WritingCStateDuration", now() - writingCStateStartTime)
 	    .trackLatest(self->clusterRecoveryDurationEventHolder->trackingKey);
 
 	TraceEvent(getRecoveryEventName(ClusterRecoveryEventType::CLUSTER_RECOVERY_STATE_EVENT_NAME).c_str(), self->dbgid)
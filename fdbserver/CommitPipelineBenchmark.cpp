@@ -0,0 +1,271 @@
+/*
+ * CommitPipelineBenchmark.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cinttypes>
+#include <map>
+#include <vector>
+
+#include "fdbclient/CommitTransaction.h"
+#include "fdbclient/FDBTypes.h"
+#include "fdbclient/KeyRangeMap.h"
+#include "fdbclient/VersionedMap.h"
+#include "fdbrpc/ReplicationPolicy.h"
+#include "fdbserver/ConflictSet.h"
+#include "fdbserver/Knobs.h"
+#include "fdbserver/LogSystem.h"
+#include "fdbserver/LogSystemConfig.h"
+#include "fdbserver/OTELSpanContextMessage.h"
+#include "flow/Arena.h"
+#include "flow/Platform.h"
+#include "flow/UnitTest.h"
+
+namespace {
+
+// The CPU time and the arena blocks spent by one stage of the commit pipeline
+struct StageCost {
+	const char* name;
+	double cpuSeconds = 0;
+	int64_t arenaBlocks = 0;
+
+	explicit StageCost(const char* name) : name(name) {}
+};
+
+// Charges the CPU time and the arena blocks created while it is in scope to a stage
+struct StageScope {
+	StageCost& cost;
+	double startCpu;
+	int64_t startBlocks;
+
+	explicit StageScope(StageCost& cost)
+	  : cost(cost), startCpu(getProcessorTimeThread()), startBlocks(getArenaBlockCounts().created) {}
+	~StageScope() {
+		cost.cpuSeconds += getProcessorTimeThread() - startCpu;
+		cost.arenaBlocks += getArenaBlockCounts().created - startBlocks;
+	}
+};
+
+// The configuration of a log system of tLogs TLogs that never receive anything, which LogPushData uses to find where
+// messages go
+LogSystemConfig makeLogSystemConfig(int tLogs) {
+	TLogSet tLogSet;
+	for (int i = 0; i < tLogs; i++) {
+		Key zone = StringRef(format("zone%d", i));
+		tLogSet.tLogs.emplace_back(deterministicRandom()->randomUniqueID());
+		tLogSet.tLogLocalities.emplace_back(Optional<Key>(), zone, zone, Optional<Key>());
+	}
+	tLogSet.tLogReplicationFactor = 1;
+	tLogSet.tLogPolicy = makeReference<PolicyOne>();
+	tLogSet.tLogVersion = TLogVersion::V7;
+	tLogSet.isLocal = true;
+	tLogSet.locality = 0;
+	tLogSet.startVersion = 0;
+
+	LogSystemConfig config;
+	config.logSystemType = LogSystemType::tagPartitioned;
+	config.tLogs.push_back(tLogSet);
+	return config;
+}
+
+std::string keyFor(int index) {
+	return format("%08d", index);
+}
+
+} // namespace
+
+// Drives batches of commits through the code that the commit path is built from, in a single process and with stub
+// logs and storage servers, so that changes to the critical path can be measured without a cluster:
+// - the resolver checks the batch with a ConflictBatch, as resolveBatch() does
+// - the proxy tags the mutations of the committed transactions from its key map and writes them into per TLog messages
+//   with LogPushData, as commitBatch() does
+// - every TLog splits its message into per tag messages, as tLogCommit() does
+// - every storage server reads the messages of its tag and applies them to a VersionedMap, as update() does
+// Prints the commits per second of the whole pipeline on one thread, and the CPU time and arena blocks that every
+// stage spends per commit.
+TEST_CASE(":/fdbserver/commitPipeline/performance") {
+	int batches = params.getInt("batches").orDefault(100);
+	int transactionsPerBatch = params.getInt("transactionsPerBatch").orDefault(100);
+	int mutationsPerTransaction = params.getInt("mutationsPerTransaction").orDefault(4);
+	int valueSize = params.getInt("valueSize").orDefault(100);
+	int keyCount = params.getInt("keyCount").orDefault(1e6);
+	int tLogs = params.getInt("tLogs").orDefault(4);
+	int storageServers = params.getInt("storageServers").orDefault(16);
+	int replicas = params.getInt("replicas").orDefault(3);
+	int shards = params.getInt("shards").orDefault(64);
+
+	printf("batches: %d\n", batches);
+	printf("transactionsPerBatch: %d\n", transactionsPerBatch);
+	printf("mutationsPerTransaction: %d\n", mutationsPerTransaction);
+	printf("valueSize: %d\n", valueSize);
+	printf("tLogs: %d\n", tLogs);
+	printf("storageServers: %d\n", storageServers);
+	printf("replicas: %d\n", replicas);
+	ASSERT(replicas <= storageServers);
+
+	LogSystemConfig logSystemConfig = makeLogSystemConfig(tLogs);
+	Reference<ILogSystem> logSystem = ILogSystem::fromLogSystemConfig(UID(), LocalityData(), logSystemConfig);
+	// Every TLog receives the messages of all the tags it has a replica of, but a storage server peeks its tag only
+	// from the TLog that is the best location for it
+	Reference<LogSet> logSet = makeReference<LogSet>(logSystemConfig.tLogs[0]);
+	ConflictSet* conflictSet = newConflictSet();
+
+	// The storage server tags of every shard, as the proxy's keyInfo maps them
+	KeyRangeMap<std::vector<Tag>> keyInfo;
+	for (int i = 0; i < shards; i++) {
+		std::vector<Tag> tags;
+		for (int r = 0; r < replicas; r++) {
+			tags.emplace_back(0, (i + r) % storageServers);
+		}
+		Key begin = i ? Key(StringRef(keyFor(int64_t(keyCount) * i / shards))) : Key();
+		Key end = i + 1 < shards ? Key(StringRef(keyFor(int64_t(keyCount) * (i + 1) / shards))) : allKeys.end;
+		keyInfo.insert(KeyRangeRef(begin, end), tags);
+	}
+
+	std::vector<VersionedMap<KeyRef, ValueRef>> storage(storageServers);
+	std::vector<Arena> storageArenas(storageServers);
+
+	StageCost resolver("Resolver"), proxy("Proxy"), tLog("TLog"), storageServer("StorageServer");
+	int64_t commits = 0, committedMutations = 0, appliedMutations = 0;
+	Version version = 0;
+	double elapsed = 0;
+
+	for (int batch = 0; batch < batches; batch++) {
+		Version prevVersion = version;
+		version += 1000;
+
+		// The client side: transactions that read one key and set mutationsPerTransaction keys
+		Standalone<VectorRef<CommitTransactionRef>> transactions;
+		Arena& arena = transactions.arena();
+		StringRef value(arena, std::string(valueSize, 'v'));
+		for (int t = 0; t < transactionsPerBatch; t++) {
+			CommitTransactionRef tr;
+			tr.read_snapshot = prevVersion;
+			StringRef readKey(arena, keyFor(deterministicRandom()->randomInt(0, keyCount)));
+			tr.read_conflict_ranges.push_back(arena, singleKeyRange(readKey, arena));
+			for (int m = 0; m < mutationsPerTransaction; m++) {
+				StringRef key(arena, keyFor(deterministicRandom()->randomInt(0, keyCount)));
+				tr.mutations.push_back(arena, MutationRef(MutationRef::SetValue, key, value));
+				tr.write_conflict_ranges.push_back(arena, singleKeyRange(key, arena));
+			}
+			transactions.push_back(arena, tr);
+		}
+		double batchStart = timer_monotonic();
+
+		std::vector<int> committed, tooOld;
+		{
+			StageScope scope(resolver);
+			ConflictBatch conflictBatch(conflictSet);
+			for (auto const& tr : transactions) {
+				conflictBatch.addTransaction(tr);
+			}
+			conflictBatch.detectConflicts(
+			    version, version - SERVER_KNOBS->MAX_WRITE_TRANSACTION_LIFE_VERSIONS, committed, &tooOld);
+		}
+		commits += committed.size();
+		committedMutations += committed.size() * mutationsPerTransaction;
+
+		std::vector<Standalone<StringRef>> messages;
+		{
+			StageScope scope(proxy);
+			LogPushData toCommit(logSystem, tLogs);
+			for (int t : committed) {
+				toCommit.addTransactionInfo(SpanContext());
+				for (auto const& m : transactions[t].mutations) {
+					toCommit.addTags(keyInfo.rangeContaining(m.param1).value());
+					toCommit.writeTypedMessage(m);
+				}
+			}
+			messages = toCommit.getAllMessages();
+		}
+
+		// The messages of every tag, in blocks owned by the TLogs
+		std::vector<Standalone<VectorRef<uint8_t>>> blocks;
+		std::map<Tag, std::vector<StringRef>> tagMessages;
+		{
+			StageScope scope(tLog);
+			for (int loc = 0; loc < messages.size(); loc++) {
+				Standalone<StringRef> const& message = messages[loc];
+				Standalone<VectorRef<uint8_t>> block;
+				block.reserve(block.arena(), message.size());
+				ArenaReader rd(message.arena(), message, Unversioned());
+				while (!rd.empty()) {
+					TagsAndMessage tagsAndMessage;
+					tagsAndMessage.loadFromArena(&rd, nullptr);
+					block.append(block.arena(), tagsAndMessage.message.begin(), tagsAndMessage.message.size());
+					StringRef copied(block.end() - tagsAndMessage.message.size(), tagsAndMessage.message.size());
+					for (Tag tag : tagsAndMessage.tags) {
+						if (logSet->bestLocationFor(tag) == loc) {
+							tagMessages[tag].push_back(copied);
+						}
+					}
+				}
+				blocks.push_back(block);
+			}
+		}
+
+		{
+			StageScope scope(storageServer);
+			for (auto const& [tag, tagMessageList] : tagMessages) {
+				VersionedMap<KeyRef, ValueRef>& data = storage[tag.id];
+				Arena& storageArena = storageArenas[tag.id];
+				data.createNewVersion(version);
+				for (StringRef message : tagMessageList) {
+					ArenaReader rd(storageArena, message, AssumeVersion(g_network->protocolVersion()));
+					int32_t messageLength;
+					uint32_t subsequence;
+					uint16_t tagCount;
+					rd >> messageLength >> subsequence >> tagCount;
+					rd.readBytes(tagCount * sizeof(Tag));
+					if (OTELSpanContextMessage::isNextIn(rd)) {
+						OTELSpanContextMessage scm;
+						rd >> scm;
+					} else {
+						MutationRef m;
+						rd >> m;
+						ASSERT(m.type == MutationRef::SetValue);
+						data.insert(KeyRef(storageArena, m.param1), ValueRef(storageArena, m.param2));
+						++appliedMutations;
+					}
+				}
+				data.forgetVersionsBefore(version);
+			}
+		}
+		elapsed += timer_monotonic() - batchStart;
+	}
+	destroyConflictSet(conflictSet);
+
+	// Every mutation reaches each replica of its shard
+	ASSERT(commits > 0);
+	ASSERT_EQ(appliedMutations, committedMutations * replicas);
+	printf("commits: %" PRId64 "\n", commits);
+	printf("commitsPerSecond: %.0f\n", commits / elapsed);
+	TraceEvent e("CommitPipelineBenchmark");
+	e.detail("Commits", commits).detail("CommitsPerSecond", commits / elapsed);
+	for (StageCost const* stage : { &resolver, &proxy, &tLog, &storageServer }) {
+		double cpuPerCommit = stage->cpuSeconds / commits;
+		double arenaBlocksPerCommit = double(stage->arenaBlocks) / commits;
+		printf("%s: cpuMicrosecondsPerCommit %.2f arenaBlocksPerCommit %.2f\n",
+		       stage->name,
+		       cpuPerCommit * 1e6,
+		       arenaBlocksPerCommit);
+		e.detail(format("%sCPUPerCommit", stage->name), cpuPerCommit)
+		    .detail(format("%sArenaBlocksPerCommit", stage->name), arenaBlocksPerCommit);
+	}
+	return Void();
+}
@@ -83,6 +83,14 @@ ACTOR Future<Void> broadcastTxnRequest(TxnStateRequest req, int sendAmount, bool
 	return Void();
 }
 
+ACTOR Future<Void> forwardTxnRequest(TxnStateRequest req, int sendAmount, Future<Void> applied) {
+	state ReplyPromise<Void> reply = req.reply;
+	resetReply(req);
+	wait(applied && broadcastTxnRequest(req, sendAmount, false));
+	reply.send(Void());
+	return Void();
+}
+
 ACTOR void discardCommit(UID id, Future<LogSystemDiskQueueAdapter::CommitMessage> fcm, Future<Void> dummyCommitState) {
 	ASSERT(!dummyCommitState.isReady());
 	LogSystemDiskQueueAdapter::CommitMessage cm = wait(fcm);
@@ -91,9 +99,92 @@ ACTOR void discardCommit(UID id, Future<LogSystemDiskQueueAdapter::CommitMessage
 	ASSERT(dummyCommitState.isReady());
 }
 
+// Calls add(resolver) for every resolver that must check the read conflict range r of a transaction that read at
+// readSnapshot. A resolver may be added more than once.
+template <class AddResolver>
+void forEachReadConflictRangeResolver(const ProxyCommitData* self,
+                                      KeyRangeRef r,
+                                      Version readSnapshot,
+                                      AddResolver const& add) {
+	auto ranges = self->keyResolvers.intersectingRanges(r);
+	for (auto& ir : ranges) {
+		auto& version_resolver = ir.value();
+		for (int i = version_resolver.size() - 1; i >= 0; i--) {
+			add(version_resolver[i].second);
+			if (version_resolver[i].first < readSnapshot)
+				break;
+		}
+	}
+	if (SERVER_KNOBS->PROXY_USE_RESOLVER_PRIVATE_MUTATIONS && systemKeys.intersects(r)) {
+		for (int k = 0; k < self->resolvers.size(); k++) {
+			add(k);
+		}
+	}
+}
+
+// Calls add(resolver) for every resolver that must check the write conflict range r. A resolver may be added more than
+// once.
+template <class AddResolver>
+void forEachWriteConflictRangeResolver(const ProxyCommitData* self, KeyRangeRef r, AddResolver const& add) {
+	auto ranges = self->keyResolvers.intersectingRanges(r);
+	for (auto& ir : ranges) {
+		auto& version_resolver = ir.value();
+		if (!version_resolver.empty()) {
+			add(version_resolver.back().second);
+		}
+	}
+	if (SERVER_KNOBS->PROXY_USE_RESOLVER_PRIVATE_MUTATIONS && systemKeys.intersects(r)) {
+		for (int k = 0; k < self->resolvers.size(); k++) {
+			add(k);
+		}
+	}
+}
+
+// The resolvers of the conflict ranges of a batch as bit masks, when they are looked up on the proxy's helper threads
+// before the resolution requests are built. The masks of the conflict ranges of transaction t start at readOffsets[t]
+// and writeOffsets[t]. Conflict ranges that are added while the requests are built are looked up then.
+struct ConflictRangeResolvers {
+	std::vector<int> readOffsets, writeOffsets;
+	std::vector<uint64_t> readMasks, writeMasks;
+};
+
+ConflictRangeResolvers lookupConflictRangeResolvers(ProxyCommitData* self,
+                                                    const std::vector<CommitTransactionRequest>& trs) {
+	ASSERT(self->resolvers.size() <= 64);
+	ConflictRangeResolvers result;
+	result.readOffsets.resize(trs.size() + 1);
+	result.writeOffsets.resize(trs.size() + 1);
+	for (int t = 0; t < trs.size(); t++) {
+		result.readOffsets[t + 1] = result.readOffsets[t] + trs[t].transaction.read_conflict_ranges.size();
+		result.writeOffsets[t + 1] = result.writeOffsets[t] + trs[t].transaction.write_conflict_ranges.size();
+	}
+	result.readMasks.resize(result.readOffsets.back());
+	result.writeMasks.resize(result.writeOffsets.back());
+
+	self->helperThreads.parallelFor(trs.size(), [&](int begin, int end) {
+		for (int t = begin; t < end; t++) {
+			const CommitTransactionRef& tr = trs[t].transaction;
+			for (int i = 0; i < tr.read_conflict_ranges.size(); i++) {
+				uint64_t& mask = result.readMasks[result.readOffsets[t] + i];
+				forEachReadConflictRangeResolver(
+				    self, tr.read_conflict_ranges[i], tr.read_snapshot, [&](int k) { mask |= uint64_t(1) << k; });
+			}
+			for (int i = 0; i < tr.write_conflict_ranges.size(); i++) {
+				uint64_t& mask = result.writeMasks[result.writeOffsets[t] + i];
+				forEachWriteConflictRangeResolver(
+				    self, tr.write_conflict_ranges[i], [&](int k) { mask |= uint64_t(1) << k; });
+			}
+		}
+	});
+	return result;
+}
+
 struct ResolutionRequestBuilder {
 	const ProxyCommitData* self;
 
+	// Set if the resolvers of the batch's conflict ranges have been looked up already
+	const ConflictRangeResolvers* lookedUpResolvers = nullptr;
+
 	// One request per resolver.
 	std::vector<ResolveTransactionBatchRequest> requests;
 
@@ -131,26 +222,30 @@ struct ResolutionRequestBuilder {
 		return *out;
 	}
 
+	void addResolvers(std::set<int>& resolvers, uint64_t mask) const {
+		for (int k = 0; k < requests.size(); k++) {
+			if (mask & (uint64_t(1) << k)) {
+				resolvers.insert(k);
+			}
+		}
+	}
+
 	// Returns a read conflict index map: [resolver_index][read_conflict_range_index_on_the_resolver]
 	// -> read_conflict_range's original index
-	std::vector<std::vector<int>> addReadConflictRanges(CommitTransactionRef& trIn) {
+	std::vector<std::vector<int>> addReadConflictRanges(CommitTransactionRef& trIn, int transactionNumberInBatch) {
 		std::vector<std::vector<int>> rCRIndexMap(requests.size());
+		int lookedUpBegin = 0, lookedUp = 0;
+		if (lookedUpResolvers) {
+			lookedUpBegin = lookedUpResolvers->readOffsets[transactionNumberInBatch];
+			lookedUp = lookedUpResolvers->readOffsets[transactionNumberInBatch + 1] - lookedUpBegin;
+		}
 		for (int idx = 0; idx < trIn.read_conflict_ranges.size(); ++idx) {
 			const auto& r = trIn.read_conflict_ranges[idx];
-			auto ranges = self->keyResolvers.intersectingRanges(r);
 			std::set<int> resolvers;
-			for (auto& ir : ranges) {
-				auto& version_resolver = ir.value();
-				for (int i = version_resolver.size() - 1; i >= 0; i--) {
-					resolvers.insert(version_resolver[i].second);
-					if (version_resolver[i].first < trIn.read_snapshot)
-						break;
-				}
-			}
-			if (SERVER_KNOBS->PROXY_USE_RESOLVER_PRIVATE_MUTATIONS && systemKeys.intersects(r)) {
-				for (int k = 0; k < self->resolvers.size(); k++) {
-					resolvers.insert(k);
-				}
+			if (idx < lookedUp) {
+				addResolvers(resolvers, lookedUpResolvers->readMasks[lookedUpBegin + idx]);
+			} else {
+				forEachReadConflictRangeResolver(self, r, trIn.read_snapshot, [&](int k) { resolvers.insert(k); });
 			}
 			ASSERT(resolvers.size());
 			for (int resolver : resolvers) {
@@ -162,20 +257,19 @@ struct ResolutionRequestBuilder {
 		return rCRIndexMap;
 	}
 
-	void addWriteConflictRanges(CommitTransactionRef& trIn) {
-		for (auto& r : trIn.write_conflict_ranges) {
-			auto ranges = self->keyResolvers.intersectingRanges(r);
+	void addWriteConflictRanges(CommitTransactionRef& trIn, int transactionNumberInBatch) {
+		int lookedUpBegin = 0, lookedUp = 0;
+		if (lookedUpResolvers) {
+			lookedUpBegin = lookedUpResolvers->writeOffsets[transactionNumberInBatch];
+			lookedUp = lookedUpResolvers->writeOffsets[transactionNumberInBatch + 1] - lookedUpBegin;
+		}
+		for (int idx = 0; idx < trIn.write_conflict_ranges.size(); ++idx) {
+			const auto& r = trIn.write_conflict_ranges[idx];
 			std::set<int> resolvers;
-			for (auto& ir : ranges) {
-				auto& version_resolver = ir.value();
-				if (!version_resolver.empty()) {
-					resolvers.insert(version_resolver.back().second);
-				}
-			}
-			if (SERVER_KNOBS->PROXY_USE_RESOLVER_PRIVATE_MUTATIONS && systemKeys.intersects(r)) {
-				for (int k = 0; k < self->resolvers.size(); k++) {
-					resolvers.insert(k);
-				}
+			if (idx < lookedUp) {
+				addResolvers(resolvers, lookedUpResolvers->writeMasks[lookedUpBegin + idx]);
+			} else {
+				forEachWriteConflictRangeResolver(self, r, [&](int k) { resolvers.insert(k); });
 			}
 			ASSERT(resolvers.size());
 			for (int resolver : resolvers)
@@ -214,10 +308,10 @@ struct ResolutionRequestBuilder {
 			trIn.read_conflict_ranges.push_back(trRequest.arena, KeyRangeRef(databaseLockedKey, databaseLockedKeyEnd));
 		}
 
-		std::vector<std::vector<int>> rCRIndexMap = addReadConflictRanges(trIn);
+		std::vector<std::vector<int>> rCRIndexMap = addReadConflictRanges(trIn, transactionNumberInBatch);
 		txReadConflictRangeIndexMap.push_back(std::move(rCRIndexMap));
 
-		addWriteConflictRanges(trIn);
+		addWriteConflictRanges(trIn, transactionNumberInBatch);
 
 		if (isTXNStateTransaction) {
 			for (int r = 0; r < requests.size(); r++) {
@@ -238,6 +332,12 @@ struct ResolutionRequestBuilder {
 			}
 		transactionResolverMap.emplace_back(std::move(resolversUsed));
 	}
+
+	// Accounts for a transaction of the batch that is not sent to any resolver
+	void skipTransaction() {
+		txReadConflictRangeIndexMap.emplace_back(requests.size());
+		transactionResolverMap.emplace_back();
+	}
 };
 
 ErrorOr<Optional<TenantMapEntry>> getTenantEntry(ProxyCommitData* commitData,
@@ -625,6 +725,10 @@ struct CommitBatchContext {
 
 	std::vector<uint8_t> committed;
 
+	// Transactions rejected before resolution, since they read keys this proxy committed writes to after their read
+	// snapshots. Empty unless PROXY_EARLY_CONFLICT_CHECK is set.
+	std::vector<bool> earlyConflicts;
+
 	Optional<Key> lockedKey;
 	bool locked;
 
@@ -655,6 +759,11 @@ struct CommitBatchContext {
 	std::set<Tag> writtenTags; // final set tags written to in the batch
 	std::set<Tag> writtenTagsPreResolution; // tags written to in the batch not including any changes from the resolver.
 
+	// The key map entries of the single key mutations of the committed transactions and whether they are cached, when
+	// they are looked up on the proxy's helper threads. Those of transaction t start at singleKeyMutationOffsets[t].
+	std::vector<int> singleKeyMutationOffsets;
+	std::vector<std::pair<ServerCacheInfo*, bool>> singleKeyMutationInfo;
+
 	// Cipher keys to be used to encrypt mutations
 	std::unordered_map<EncryptCipherDomainId, Reference<BlobCipherKey>> cipherKeys;
 
@@ -875,6 +984,22 @@ ACTOR Future<Void> preresolutionProcessing(CommitBatchContext* self) {
 	return Void();
 }
 
+// Returns whether transaction tr certainly conflicts with a write this proxy committed after the transaction's read
+// snapshot. The resolvers have seen that write, so they would find the conflict too.
+bool conflictsWithRecentWrite(ProxyCommitData* self, const CommitTransactionRequest& tr, Version commitVersion) {
+	// Leave the reporting of conflicting keys and of transactions too old for the resolvers to them
+	if (tr.transaction.report_conflicting_keys ||
+	    tr.transaction.read_snapshot < commitVersion - SERVER_KNOBS->MAX_WRITE_TRANSACTION_LIFE_VERSIONS) {
+		return false;
+	}
+	for (auto& r : tr.transaction.read_conflict_ranges) {
+		if (self->recentWrites.writtenAfter(r, tr.transaction.read_snapshot)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 ACTOR Future<Void> getResolution(CommitBatchContext* self) {
 	state double resolutionStart = now();
 	// Sending these requests is the fuzzy border between phase 1 and phase 2; it could conceivably overlap with
@@ -885,9 +1010,33 @@ ACTOR Future<Void> getResolution(CommitBatchContext* self) {
 
 	ResolutionRequestBuilder requests(
 	    pProxyCommitData, self->commitVersion, self->prevVersion, pProxyCommitData->version.get(), span);
+	int requestedConflictRanges = 0;
+	for (auto& tr : trs) {
+		requestedConflictRanges +=
+		    tr.transaction.read_conflict_ranges.size() + tr.transaction.write_conflict_ranges.size();
+	}
+	ConflictRangeResolvers lookedUpResolvers;
+	if (pProxyCommitData->helperThreads.shouldSplit(requestedConflictRanges) &&
+	    pProxyCommitData->resolvers.size() <= 64) {
+		lookedUpResolvers = lookupConflictRangeResolvers(pProxyCommitData, trs);
+		requests.lookedUpResolvers = &lookedUpResolvers;
+	}
+	if (SERVER_KNOBS->PROXY_EARLY_CONFLICT_CHECK) {
+		pProxyCommitData->recentWrites.expire(self->commitVersion - SERVER_KNOBS->PROXY_EARLY_CONFLICT_WINDOW_VERSIONS);
+		self->earlyConflicts.resize(trs.size());
+		for (int t = 0; t < trs.size(); t++) {
+			self->earlyConflicts[t] = conflictsWithRecentWrite(pProxyCommitData, trs[t], self->commitVersion);
+		}
+	}
 	int conflictRangeCount = 0;
 	self->maxTransactionBytes = 0;
 	for (int t = 0; t < trs.size(); t++) {
+		if (!self->earlyConflicts.empty() && self->earlyConflicts[t]) {
+			CODE_PROBE(true, "Transaction rejected before resolution");
+			requests.skipTransaction();
+			pProxyCommitData->stats.txnEarlyConflicts++;
+			continue;
+		}
 		requests.addTransaction(trs[t], self->commitVersion, t);
 		conflictRangeCount +=
 		    trs[t].transaction.read_conflict_ranges.size() + trs[t].transaction.write_conflict_ranges.size();
@@ -1051,6 +1200,9 @@ void determineCommittedTransactions(CommitBatchContext* self) {
 		for (int r : self->transactionResolverMap[t]) {
 			commit = std::min(self->resolution[r].committed[self->nextTr[r]++], commit);
 		}
+		if (!self->earlyConflicts.empty() && self->earlyConflicts[t]) {
+			commit = ConflictBatch::TransactionConflict;
+		}
 		self->committed[t] = commit;
 	}
 	for (int r = 0; r < self->resolution.size(); r++)
@@ -1173,15 +1325,142 @@ void writeMutation(CommitBatchContext* self, int64_t tenantId, const MutationRef
 	}
 }
 
+bool isAssignedToStorageServers(CommitBatchContext* self, int transactionNum) {
+	return self->committed[transactionNum] == ConflictBatch::TransactionCommitted &&
+	       (!self->locked || self->trs[transactionNum].isLockAware());
+}
+
+// Finds the key map entries of the single key mutations of a batch by sorting their keys and merging them with the
+// boundaries of the proxy's key routing index, on the helper threads if split
+void routeSortedSingleKeyMutations(CommitBatchContext* self, const std::vector<int>& offsets, bool split) {
+	ProxyCommitData* const pProxyCommitData = self->pProxyCommitData;
+	std::vector<CommitTransactionRequest>& trs = self->trs;
+
+	// The key of every single key mutation, with the index of its entry in singleKeyMutationInfo
+	std::vector<std::pair<KeyRef, int>> keys;
+	keys.reserve(offsets.back());
+	for (int t = 0; t < trs.size(); t++) {
+		if (offsets[t] == offsets[t + 1]) {
+			continue;
+		}
+		const VectorRef<MutationRef>& mutations = trs[t].transaction.mutations;
+		for (int i = 0; i < mutations.size(); i++) {
+			if (isSingleKeyMutation((MutationRef::Type)mutations[i].type)) {
+				keys.emplace_back(mutations[i].param1, offsets[t] + i);
+			}
+		}
+	}
+	std::sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+	// Picks up all of the shard moves applied since the last batch in a single rebuild, before the helper threads
+	// search the index
+	pProxyCommitData->keyRouting.refresh();
+	auto route = [&](int begin, int end) {
+		if (begin == end) {
+			return;
+		}
+		const KeyRoutingIndex<ServerCacheInfo>& index = pProxyCommitData->keyRouting;
+		int range = index.find(keys[begin].first);
+		auto cached = pProxyCommitData->cacheInfo.rangeContaining(keys[begin].first);
+		auto lastCached = pProxyCommitData->cacheInfo.lastItem();
+		for (int k = begin; k < end; k++) {
+			range = index.findFrom(range, keys[k].first);
+			while (cached != lastCached && keys[k].first >= cached.end()) {
+				++cached;
+			}
+			self->singleKeyMutationInfo[keys[k].second] = { &index.value(range), cached.value() };
+		}
+	};
+	if (split) {
+		pProxyCommitData->helperThreads.parallelFor(keys.size(), route);
+	} else {
+		route(0, keys.size());
+	}
+}
+
+// Looks up the key map entries of the single key mutations of a batch before they are assigned, through the key
+// routing index or on the proxy's helper threads for large batches. The key map is only changed by the metadata
+// mutations of a batch, which are applied before its mutations are assigned and after the previous batch was logged,
+// so the entries stay valid while the mutations are assigned.
+void lookupSingleKeyMutations(CommitBatchContext* self) {
+	ProxyCommitData* const pProxyCommitData = self->pProxyCommitData;
+	std::vector<CommitTransactionRequest>& trs = self->trs;
+
+	std::vector<int> offsets(trs.size() + 1);
+	for (int t = 0; t < trs.size(); t++) {
+		offsets[t + 1] = offsets[t] + (isAssignedToStorageServers(self, t) ? trs[t].transaction.mutations.size() : 0);
+	}
+	bool split = pProxyCommitData->helperThreads.shouldSplit(offsets.back());
+	if (!split && !SERVER_KNOBS->PROXY_USE_KEY_ROUTING_INDEX) {
+		return;
+	}
+
+	self->singleKeyMutationInfo.assign(offsets.back(), { nullptr, false });
+	if (SERVER_KNOBS->PROXY_USE_KEY_ROUTING_INDEX) {
+		routeSortedSingleKeyMutations(self, offsets, split);
+	} else {
+		pProxyCommitData->helperThreads.parallelFor(trs.size(), [&](int begin, int end) {
+			for (int t = begin; t < end; t++) {
+				if (offsets[t] == offsets[t + 1]) {
+					continue;
+				}
+				const VectorRef<MutationRef>& mutations = trs[t].transaction.mutations;
+				for (int i = 0; i < mutations.size(); i++) {
+					const MutationRef& m = mutations[i];
+					if (isSingleKeyMutation((MutationRef::Type)m.type)) {
+						ServerCacheInfo& info = pProxyCommitData->keyInfo.rangeContaining(m.param1).value();
+						self->singleKeyMutationInfo[offsets[t] + i] = { &info, pProxyCommitData->cacheInfo[m.param1] };
+					}
+				}
+			}
+		});
+	}
+	self->singleKeyMutationOffsets = std::move(offsets);
+}
+
+// Returns the tags of the single key mutation m, the mutationNum-th of the transaction being assigned, and whether it
+// is also written to the cache tag
+std::pair<const std::vector<Tag>*, bool> singleKeyMutationTags(CommitBatchContext* self,
+                                                               int mutationNum,
+                                                               const MutationRef& m) {
+	ProxyCommitData* const pProxyCommitData = self->pProxyCommitData;
+	if (self->singleKeyMutationInfo.empty()) {
+		return { &pProxyCommitData->tagsForKey(m.param1), pProxyCommitData->cacheInfo[m.param1] };
+	}
+	auto& [info, cached] =
+	    self->singleKeyMutationInfo[self->singleKeyMutationOffsets[self->transactionNum] + mutationNum];
+	info->populateTags();
+	return { &info->tags, cached };
+}
+
+// Records the writes of the transactions of the batch that will be committed, for the early conflict checks of later
+// batches
+void recordCommittedWrites(CommitBatchContext* self) {
+	if (!SERVER_KNOBS->PROXY_EARLY_CONFLICT_CHECK) {
+		return;
+	}
+	for (int t = 0; t < self->trs.size(); t++) {
+		if (!isAssignedToStorageServers(self, t)) {
+			continue;
+		}
+		for (auto& r : self->trs[t].transaction.write_conflict_ranges) {
+			if (r.singleKeyRange()) {
+				self->pProxyCommitData->recentWrites.add(r.begin, self->commitVersion);
+			}
+		}
+	}
+}
+
 /// This second pass through committed transactions assigns the actual mutations to the appropriate storage servers'
 /// tags
 ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 	state ProxyCommitData* const pProxyCommitData = self->pProxyCommitData;
 	state std::vector<CommitTransactionRequest>& trs = self->trs;
 
+	lookupSingleKeyMutations(self);
+
 	for (; self->transactionNum < trs.size(); self->transactionNum++) {
-		if (!(self->committed[self->transactionNum] == ConflictBatch::TransactionCommitted &&
-		      (!self->locked || trs[self->transactionNum].isLockAware()))) {
+		if (!isAssignedToStorageServers(self, self->transactionNum)) {
 			continue;
 		}
 
@@ -1211,7 +1490,8 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 			// if necessary.  Serialize (splits of) the mutation into the message buffer and add the tags.
 
 			if (isSingleKeyMutation((MutationRef::Type)m.type)) {
-				auto& tags = pProxyCommitData->tagsForKey(m.param1);
+				auto tagsAndCached = singleKeyMutationTags(self, mutationNum, m);
+				auto& tags = *tagsAndCached.first;
 
 				// sample single key mutation based on cost
 				// the expectation of sampling is every COMMIT_SAMPLE_COST sample once
@@ -1244,7 +1524,7 @@ ACTOR Future<Void> assignMutationsToStorageServers(CommitBatchContext* self) {
 
 				DEBUG_MUTATION("ProxyCommit", self->commitVersion, m, pProxyCommitData->dbgid).detail("To", tags);
 				self->toCommit.addTags(tags);
-				if (pProxyCommitData->cacheInfo[m.param1]) {
+				if (tagsAndCached.second) {
 					self->toCommit.addTag(cacheTag);
 				}
 				writeMutation(self, tenantId, m);
@@ -1403,6 +1683,8 @@ ACTOR Future<Void> postResolution(CommitBatchContext* self) {
 		    "CommitDebug", debugID.get().first(), "CommitProxyServer.commitBatch.ApplyMetadaToCommittedTxn");
 	}
 
+	recordCommittedWrites(self);
+
 	// Second pass
 	wait(assignMutationsToStorageServers(self));
 
@@ -2386,6 +2668,8 @@ ACTOR Future<Void> processCompleteTransactionStateRequest(TransactionStateResolv
 		                       /* initialCommit= */ true);
 	} // loop
 
+	pContext->pCommitData->keyRouting.rebuild();
+
 	auto lockedKey = pContext->pTxnStateStore->readValue(databaseLockedKey).get();
 	pContext->pCommitData->locked = lockedKey.present() && lockedKey.get().size();
 	pContext->pCommitData->metadataVersion = pContext->pTxnStateStore->readValue(metadataVersionKey).get();
@@ -2416,6 +2700,13 @@ ACTOR Future<Void> processTransactionStateRequestPart(TransactionStateResolveCon
 	}
 	pContext->receivedSequences.insert(request.sequence);
 
+	// The rest of the broadcast tree can apply the part while it is applied here, rather than once every commit proxy
+	// above it has
+	state Promise<Void> applied;
+	if (SERVER_KNOBS->TXN_STATE_PIPELINED_BROADCAST) {
+		pContext->pActors->send(forwardTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, applied.getFuture()));
+	}
+
 	// Although we may receive the CommitTransactionRequest for the recovery transaction before all of the
 	// TxnStateRequest, we will not get a resolution result from any resolver until the master has submitted its initial
 	// (sequence 0) resolution request, which it doesn't do until we have acknowledged all TxnStateRequests
@@ -2434,7 +2725,11 @@ ACTOR Future<Void> processTransactionStateRequestPart(TransactionStateResolveCon
 		pContext->processed = true;
 	}
 
-	pContext->pActors->send(broadcastTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, true));
+	if (SERVER_KNOBS->TXN_STATE_PIPELINED_BROADCAST) {
+		applied.send(Void());
+	} else {
+		pContext->pActors->send(broadcastTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, true));
+	}
 	wait(yield());
 	return Void();
 }
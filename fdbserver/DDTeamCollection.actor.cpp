@@ -127,6 +127,12 @@ public:
 		return Void();
 	}
 
+	ACTOR static Future<Void> traceTeamCollectionInfoAfterDelay(DDTeamCollection const* self) {
+		wait(delay(SERVER_KNOBS->DD_TEAM_COLLECTION_INFO_TRACE_DELAY, TaskPriority::DataDistribution));
+		self->traceTeamCollectionInfoNow();
+		return Void();
+	}
+
 	ACTOR static Future<Void> interruptableBuildTeams(DDTeamCollection* self) {
 		if (!self->addSubsetComplete.isSet()) {
 			wait(addSubsetOfEmergencyTeams(self));
@@ -3564,9 +3570,14 @@ void DDTeamCollection::resetLocalitySet() {
 		it.second->localityEntry =
 		    storageServerMap->add(it.second->getLastKnownInterface().locality, &it.second->getId());
 	}
+	localitySetStale = false;
 }
 
-bool DDTeamCollection::satisfiesPolicy(const std::vector<Reference<TCServerInfo>>& team, int amount) const {
+bool DDTeamCollection::satisfiesPolicy(const std::vector<Reference<TCServerInfo>>& team, int amount) {
+	if (localitySetStale) {
+		resetLocalitySet();
+	}
+
 	std::vector<LocalityEntry> forcedEntries, resultEntries;
 	if (amount == -1) {
 		amount = team.size();
@@ -4106,35 +4117,36 @@ int DDTeamCollection::addBestMachineTeams(int machineTeamsToBuild) {
 	// Step 1: Create machineLocalityMap which will be used in building machine team
 	rebuildMachineLocalityMap();
 
+	// Index the machines by machine team count once and keep the index current as machine teams are added, instead
+	// of scanning all machines for every machine team built
+	TeamCountIndex<TCMachineInfo> healthyMachines, candidateMachines;
+	for (auto& machine : machine_info) {
+		// Skip invalid machine whose representative server is not in server_info
+		ASSERT_WE_THINK(server_info.find(machine.second->serversOnMachine[0]->getId()) != server_info.end());
+		// Skip unhealthy machines
+		if (!isMachineHealthy(machine.second))
+			continue;
+		// Invariant: We only create correct size machine teams.
+		// When configuration (e.g., team size) is changed, the DDTeamCollection will be destroyed and rebuilt
+		// so that the invariant will not be violated.
+		healthyMachines.insert(machine.second, machine.second->machineTeams.size());
+		// Skip machine with incomplete locality
+		if (!isValidLocality(configuration.storagePolicy,
+		                     machine.second->serversOnMachine[0]->getLastKnownInterface().locality)) {
+			continue;
+		}
+		candidateMachines.insert(machine.second, machine.second->machineTeams.size());
+	}
+	int targetMachineTeams = targetMachineTeamNumPerMachine();
+
 	// Add a team in each iteration
-	while (addedMachineTeams < machineTeamsToBuild || notEnoughMachineTeamsForAMachine()) {
+	while (addedMachineTeams < machineTeamsToBuild ||
+	       (!healthyMachines.empty() && healthyMachines.leastCount() < targetMachineTeams)) {
 		// Step 2: Get least used machines from which we choose machines as a machine team
-		std::vector<Reference<TCMachineInfo>> leastUsedMachines; // A less used machine has less number of teams
-		int minTeamCount = std::numeric_limits<int>::max();
-		for (auto& machine : machine_info) {
-			// Skip invalid machine whose representative server is not in server_info
-			ASSERT_WE_THINK(server_info.find(machine.second->serversOnMachine[0]->getId()) != server_info.end());
-			// Skip unhealthy machines
-			if (!isMachineHealthy(machine.second))
-				continue;
-			// Skip machine with incomplete locality
-			if (!isValidLocality(configuration.storagePolicy,
-			                     machine.second->serversOnMachine[0]->getLastKnownInterface().locality)) {
-				continue;
-			}
-
-			// Invariant: We only create correct size machine teams.
-			// When configuration (e.g., team size) is changed, the DDTeamCollection will be destroyed and rebuilt
-			// so that the invariant will not be violated.
-			int teamCount = machine.second->machineTeams.size();
-
-			if (teamCount < minTeamCount) {
-				leastUsedMachines.clear();
-				minTeamCount = teamCount;
-			}
-			if (teamCount == minTeamCount) {
-				leastUsedMachines.push_back(machine.second);
-			}
+		// A less used machine has less number of teams
+		std::vector<Reference<TCMachineInfo>> leastUsedMachines;
+		if (!candidateMachines.empty()) {
+			leastUsedMachines = candidateMachines.leastUsed();
 		}
 
 		std::vector<UID*> team;
@@ -4226,6 +4238,10 @@ int DDTeamCollection::addBestMachineTeams(int machineTeamsToBuild) {
 
 			addMachineTeam(machines);
 			addedMachineTeams++;
+			for (auto& machine : machines) {
+				healthyMachines.update(machine, machine->machineTeams.size());
+				candidateMachines.update(machine, machine->machineTeams.size());
+			}
 		} else {
 			traceAllInfo(true);
 			TraceEvent(SevWarn, "DataDistributionBuildTeams", distributorId)
@@ -4239,34 +4255,28 @@ int DDTeamCollection::addBestMachineTeams(int machineTeamsToBuild) {
 	return addedMachineTeams;
 }
 
-Reference<TCServerInfo> DDTeamCollection::findOneLeastUsedServer() const {
-	std::vector<Reference<TCServerInfo>> leastUsedServers;
-	int minTeams = std::numeric_limits<int>::max();
+void DDTeamCollection::indexServersByTeamCount(TeamCountIndex<TCServerInfo>& healthy,
+                                               TeamCountIndex<TCServerInfo>& candidates) const {
 	for (auto& [serverID, server] : server_info) {
 		// Only pick healthy server, which is not failed or excluded.
 		if (server_status.get(serverID).isUnhealthy())
 			continue;
+		healthy.insert(server, server->getTeams().size());
 		if (!isValidLocality(configuration.storagePolicy, server->getLastKnownInterface().locality))
 			continue;
-
-		int numTeams = server->getTeams().size();
-		if (numTeams < minTeams) {
-			minTeams = numTeams;
-			leastUsedServers.clear();
-		}
-		if (minTeams == numTeams) {
-			leastUsedServers.push_back(server);
-		}
+		candidates.insert(server, server->getTeams().size());
 	}
+}
 
-	if (leastUsedServers.empty()) {
+Reference<TCServerInfo> DDTeamCollection::findOneLeastUsedServer(TeamCountIndex<TCServerInfo>& candidates) const {
+	if (candidates.empty()) {
 		// If we cannot find a healthy server with valid locality
 		TraceEvent("NoHealthyAndValidLocalityServers")
 		    .detail("Servers", server_info.size())
 		    .detail("UnhealthyServers", unhealthyServers);
 		return Reference<TCServerInfo>();
 	} else {
-		return deterministicRandom()->randomChoice(leastUsedServers);
+		return deterministicRandom()->randomChoice(candidates.leastUsed());
 	}
 }
 
@@ -4462,19 +4472,22 @@ int DDTeamCollection::getHealthyMachineTeamCount() const {
 	return healthyTeamCount;
 }
 
-bool DDTeamCollection::notEnoughMachineTeamsForAMachine() const {
+int DDTeamCollection::targetMachineTeamNumPerMachine() const {
 	// If we want to remove the machine team with most machine teams, we use the same logic as
 	// notEnoughTeamsForAServer
-	int targetMachineTeamNumPerMachine =
-	    SERVER_KNOBS->TR_FLAG_REMOVE_MT_WITH_MOST_TEAMS
-	        ? (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * (configuration.storageTeamSize + 1)) / 2
-	        : SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER;
+	// If SERVER_KNOBS->TR_FLAG_REMOVE_MT_WITH_MOST_TEAMS is false,
+	// The desired machine team number is not the same with the desired server team number
+	// in notEnoughTeamsForAServer() below, because the machineTeamRemover() does not
+	// remove a machine team with the most number of machine teams.
+	return SERVER_KNOBS->TR_FLAG_REMOVE_MT_WITH_MOST_TEAMS
+	           ? (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * (configuration.storageTeamSize + 1)) / 2
+	           : SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER;
+}
+
+bool DDTeamCollection::notEnoughMachineTeamsForAMachine() const {
+	int targetMachineTeams = targetMachineTeamNumPerMachine();
 	for (auto& [_, machine] : machine_info) {
-		// If SERVER_KNOBS->TR_FLAG_REMOVE_MT_WITH_MOST_TEAMS is false,
-		// The desired machine team number is not the same with the desired server team number
-		// in notEnoughTeamsForAServer() below, because the machineTeamRemover() does not
-		// remove a machine team with the most number of machine teams.
-		if (machine->machineTeams.size() < targetMachineTeamNumPerMachine && isMachineHealthy(machine)) {
+		if (machine->machineTeams.size() < targetMachineTeams && isMachineHealthy(machine)) {
 			return true;
 		}
 	}
@@ -4482,7 +4495,7 @@ bool DDTeamCollection::notEnoughMachineTeamsForAMachine() const {
 	return false;
 }
 
-bool DDTeamCollection::notEnoughTeamsForAServer() const {
+int DDTeamCollection::targetTeamNumPerServer() const {
 	// We build more teams than we finally want so that we can use serverTeamRemover() actor to remove the teams
 	// whose member belong to too many teams. This allows us to get a more balanced number of teams per server.
 	// We want to ensure every server has targetTeamNumPerServer teams.
@@ -4490,10 +4503,15 @@ bool DDTeamCollection::notEnoughTeamsForAServer() const {
 	// (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER + ideal_num_of_teams_per_server) / 2
 	// ideal_num_of_teams_per_server is (#teams * storageTeamSize) / #servers, which is
 	// (#servers * DESIRED_TEAMS_PER_SERVER * storageTeamSize) / #servers.
-	int targetTeamNumPerServer = (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * (configuration.storageTeamSize + 1)) / 2;
-	ASSERT_GT(targetTeamNumPerServer, 0);
+	int targetTeams = (SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * (configuration.storageTeamSize + 1)) / 2;
+	ASSERT_GT(targetTeams, 0);
+	return targetTeams;
+}
+
+bool DDTeamCollection::notEnoughTeamsForAServer() const {
+	int targetTeams = targetTeamNumPerServer();
 	for (auto& [serverID, server] : server_info) {
-		if (server->getTeams().size() < targetTeamNumPerServer && !server_status.get(serverID).isUnhealthy()) {
+		if (server->getTeams().size() < targetTeams && !server_status.get(serverID).isUnhealthy()) {
 			return true;
 		}
 	}
@@ -4534,7 +4552,13 @@ int DDTeamCollection::addTeamsBestOf(int teamsToBuild, int desiredTeams, int max
 		}
 	}
 
-	while (addedTeams < teamsToBuild || notEnoughTeamsForAServer()) {
+	// Index the servers by team count once and keep the index current as teams are added, instead of scanning all
+	// servers for every team built
+	TeamCountIndex<TCServerInfo> healthyServers, candidateServers;
+	indexServersByTeamCount(healthyServers, candidateServers);
+	int targetTeams = targetTeamNumPerServer();
+
+	while (addedTeams < teamsToBuild || (!healthyServers.empty() && healthyServers.leastCount() < targetTeams)) {
 		// Step 1: Create 1 best machine team
 		std::vector<UID> bestServerTeam;
 		int bestScore = std::numeric_limits<int>::max();
@@ -4542,7 +4566,7 @@ int DDTeamCollection::addTeamsBestOf(int teamsToBuild, int desiredTeams, int max
 		bool earlyQuitBuild = false;
 		for (int i = 0; i < maxAttempts && i < 100; ++i) {
 			// Step 2: Choose 1 least used server and then choose 1 least used machine team from the server
-			Reference<TCServerInfo> chosenServer = findOneLeastUsedServer();
+			Reference<TCServerInfo> chosenServer = findOneLeastUsedServer(candidateServers);
 			if (!chosenServer.isValid()) {
 				TraceEvent(SevWarn, "NoValidServer").detail("Primary", primary);
 				earlyQuitBuild = true;
@@ -4623,6 +4647,11 @@ int DDTeamCollection::addTeamsBestOf(int teamsToBuild, int desiredTeams, int max
 		// Step 4: Add the server team
 		addTeam(bestServerTeam.begin(), bestServerTeam.end(), IsInitialTeam::False);
 		addedTeams++;
+		for (auto& serverID : bestServerTeam) {
+			auto& server = server_info[serverID];
+			healthyServers.update(server, server->getTeams().size());
+			candidateServers.update(server, server->getTeams().size());
+		}
 	}
 
 	healthyMachineTeamCount = getHealthyMachineTeamCount();
@@ -4654,6 +4683,12 @@ int DDTeamCollection::addTeamsBestOf(int teamsToBuild, int desiredTeams, int max
 }
 
 void DDTeamCollection::traceTeamCollectionInfo() const {
+	if (!teamCollectionInfoTracer.isValid() || teamCollectionInfoTracer.isReady()) {
+		teamCollectionInfoTracer = DDTeamCollectionImpl::traceTeamCollectionInfoAfterDelay(this);
+	}
+}
+
+void DDTeamCollection::traceTeamCollectionInfoNow() const {
 	int totalHealthyServerCount = calculateHealthyServerCount();
 	int desiredServerTeams = SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * totalHealthyServerCount;
 	int maxServerTeams = SERVER_KNOBS->MAX_TEAMS_PER_SERVER * totalHealthyServerCount;
@@ -4951,21 +4986,18 @@ void DDTeamCollection::removeServer(UID removedServer) {
 		server_info[*it]->removeTeamsContainingServer(removedServer);
 	}
 
-	// Step: Remove all teams that contain removedServer
-	// SOMEDAY: can we avoid walking through all teams, since we have an index of teams in which removedServer
-	// participated
+	// Step: Remove all teams that contain removedServer, which are the teams in removedServer's index of teams
+	// Copy them, because removeTeam() also removes the team from the index
+	std::vector<Reference<TCTeamInfo>> teamsToRemove = removedServerInfo->getTeams();
 	int removedCount = 0;
-	for (int t = 0; t < teams.size(); t++) {
-		if (std::count(teams[t]->getServerIDs().begin(), teams[t]->getServerIDs().end(), removedServer)) {
-			TraceEvent("ServerTeamRemoved")
-			    .detail("Primary", primary)
-			    .detail("TeamServerIDs", teams[t]->getServerIDsStr())
-			    .detail("TeamID", teams[t]->getTeamID());
-			// removeTeam also needs to remove the team from the machine team info.
-			removeTeam(teams[t]);
-			t--;
-			removedCount++;
-		}
+	for (auto& team : teamsToRemove) {
+		TraceEvent("ServerTeamRemoved")
+		    .detail("Primary", primary)
+		    .detail("TeamServerIDs", team->getServerIDsStr())
+		    .detail("TeamID", team->getTeamID());
+		// removeTeam also needs to remove the team from the machine team info.
+		removeTeam(team);
+		removedCount++;
 	}
 
 	if (removedCount == 0) {
@@ -5027,8 +5059,10 @@ void DDTeamCollection::removeServer(UID removedServer) {
 	}
 	server_status.clear(removedServer);
 
-	// FIXME: add remove support to localitySet so we do not have to recreate it
-	resetLocalitySet();
+	// LocalitySet cannot remove entries, so the set has to be recreated without the removed server. Defer that to the
+	// next policy check, so that removing many servers (e.g. a failed zone) recreates it once instead of once per
+	// server. Servers added meanwhile are added to the stale set and picked up by the rebuild.
+	localitySetStale = true;
 
 	doBuildTeams = true;
 	restartTeamBuilder.trigger();
@@ -5188,7 +5222,8 @@ public:
 
 	static std::unique_ptr<DDTeamCollection> testMachineTeamCollection(int teamSize,
 	                                                                   Reference<IReplicationPolicy> policy,
-	                                                                   int processCount) {
+	                                                                   int processCount,
+	                                                                   bool verbose = true) {
 		Database database = DatabaseContext::create(
 		    makeReference<AsyncVar<ClientDBInfo>>(), Never(), LocalityData(), EnableLocalityLoadBalance::False);
 
@@ -5224,11 +5259,13 @@ public:
 			int zone_id = process_id / 10;
 			int machine_id = process_id / 5;
 
-			printf("testMachineTeamCollection: process_id:%d zone_id:%d machine_id:%d ip_addr:%s\n",
-			       process_id,
-			       zone_id,
-			       machine_id,
-			       interface.address().toString().c_str());
+			if (verbose) {
+				printf("testMachineTeamCollection: process_id:%d zone_id:%d machine_id:%d ip_addr:%s\n",
+				       process_id,
+				       zone_id,
+				       machine_id,
+				       interface.address().toString().c_str());
+			}
 			interface.locality.set(LiteralStringRef("processid"), Standalone<StringRef>(std::to_string(process_id)));
 			interface.locality.set(LiteralStringRef("machineid"), Standalone<StringRef>(std::to_string(machine_id)));
 			interface.locality.set(LiteralStringRef("zoneid"), Standalone<StringRef>(std::to_string(zone_id)));
@@ -5241,7 +5278,9 @@ public:
 		}
 
 		int totalServerIndex = collection->constructMachinesFromServers();
-		printf("testMachineTeamCollection: construct machines for %d servers\n", totalServerIndex);
+		if (verbose) {
+			printf("testMachineTeamCollection: construct machines for %d servers\n", totalServerIndex);
+		}
 
 		return collection;
 	}
@@ -5289,6 +5328,54 @@ public:
 		return Void();
 	}
 
+	// Builds all teams of processCount synthetic storage servers, then removes 1% of the servers and rebuilds the
+	// teams they were on, and reports the CPU time of both
+	static void AddTeamsBestOf_Scale(int processCount) {
+		int teamSize = 3;
+		int desiredTeams = SERVER_KNOBS->DESIRED_TEAMS_PER_SERVER * processCount;
+		int maxTeams = SERVER_KNOBS->MAX_TEAMS_PER_SERVER * processCount;
+		Reference<IReplicationPolicy> policy =
+		    makeReference<PolicyAcross>(teamSize, "zoneid", makeReference<PolicyOne>());
+		std::unique_ptr<DDTeamCollection> collection =
+		    testMachineTeamCollection(teamSize, policy, processCount, false);
+
+		double start = getProcessorTimeThread();
+		int built = collection->addTeamsBestOf(desiredTeams, desiredTeams, maxTeams);
+		double buildSeconds = getProcessorTimeThread() - start;
+		ASSERT(built > 0);
+
+		std::vector<UID> serverIDs;
+		for (auto& [serverID, _] : collection->server_info) {
+			serverIDs.push_back(serverID);
+		}
+		std::vector<UID> removed;
+		for (int i = 0; i < std::max(1, processCount / 100); i++) {
+			removed.push_back(deterministicRandom()->randomChoice(serverIDs));
+		}
+		start = getProcessorTimeThread();
+		int rebuilt = 0;
+		for (auto& serverID : removed) {
+			if (collection->server_info.count(serverID)) {
+				collection->removeServer(serverID);
+			}
+		}
+		int teamCount = collection->teams.size();
+		if (teamCount < desiredTeams) {
+			rebuilt = collection->addTeamsBestOf(desiredTeams - teamCount, desiredTeams, maxTeams);
+		}
+		double rebuildSeconds = getProcessorTimeThread() - start;
+
+		printf("AddTeamsBestOf/Scale: servers:%d machines:%zu teams:%d build:%.3fs removed:%zu rebuilt:%d "
+		       "remove+rebuild:%.3fs\n",
+		       processCount,
+		       collection->machine_info.size(),
+		       built,
+		       buildSeconds,
+		       removed.size(),
+		       rebuilt,
+		       rebuildSeconds);
+	}
+
 	static void AddAllTeams_isExhaustive() {
 		Reference<IReplicationPolicy> policy = makeReference<PolicyAcross>(3, "zoneid", makeReference<PolicyOne>());
 		int processSize = 10;
@@ -5821,6 +5908,19 @@ TEST_CASE("DataDistribution/AddTeamsBestOf/NotUseMachineID") {
 	return Void();
 }
 
+// A benchmark rather than a test, run on demand with e.g. -r unittests -f DataDistribution/AddTeamsBestOf/Scale
+// --test-servers 5000
+TEST_CASE("DataDistribution/AddTeamsBestOf/Scale") {
+	std::vector<int> processCounts = { 1000, 2000, 5000, 10000 };
+	if (params.getInt("servers").present()) {
+		processCounts = { (int)params.getInt("servers").get() };
+	}
+	for (int processCount : processCounts) {
+		DDTeamCollectionUnitTest::AddTeamsBestOf_Scale(processCount);
+	}
+	return Void();
+}
+
 TEST_CASE("DataDistribution/AddAllTeams/isExhaustive") {
 	DDTeamCollectionUnitTest::AddAllTeams_isExhaustive();
 	return Void();
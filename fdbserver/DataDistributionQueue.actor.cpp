@@ -135,6 +135,7 @@ struct RelocateData {
 	bool cancellable;
 	TraceInterval interval;
 	std::shared_ptr<DataMove> dataMove;
+	std::vector<KeyRange> shards; // The adjacent shards batched into this relocation, empty if it was not batched
 
 	RelocateData()
 	  : priority(-1), boundaryPriority(-1), healthPriority(-1), reason(RelocateReason::OTHER), startTime(-1),
@@ -1087,6 +1088,76 @@ struct DDQueue {
 		    .detail("SourceBusyness", busyString);
 	}
 
+	// Extends rd, which is being launched, with the queued relocations of the shards directly after it that are waiting
+	// to move off the same source team at the same priority, e.g. because a server of that team is being excluded or
+	// wiggled. The batch gets one destination team and counts once against the source servers' busyness, and
+	// dataDistributionRelocator() moves its shards concurrently. The absorbed relocations are appended to batched.
+	void batchAdjacentRelocations(RelocateData& rd, std::vector<RelocateData>& batched) {
+		std::vector<UID> src = rd.src;
+		std::sort(src.begin(), src.end());
+		std::vector<KeyRange> shards = { rd.keys };
+
+		while (shards.size() < SERVER_KNOBS->DD_BATCH_MOVE_MAX_SHARDS && rd.keys.end < allKeys.end) {
+			auto next = queueMap.rangeContaining(rd.keys.end);
+			const RelocateData& nrd = next->value();
+			if (nrd.keys != next->range() || nrd.priority != rd.priority || nrd.isRestore() || nrd.src.empty() ||
+			    !queue[nrd.src[0]].count(nrd)) {
+				break;
+			}
+
+			std::vector<UID> nextSrc = nrd.src;
+			std::sort(nextSrc.begin(), nextSrc.end());
+			if (nextSrc != src) {
+				break;
+			}
+
+			// Do not cancel relocations in flight for the next shard to batch it
+			bool inFlightAtNext = false;
+			auto intersectingInFlight = inFlight.intersectingRanges(nrd.keys);
+			for (auto it = intersectingInFlight.begin(); it != intersectingInFlight.end(); ++it) {
+				if (inFlightActors.liveActorAt(it->range().begin)) {
+					inFlightAtNext = true;
+					break;
+				}
+			}
+			if (inFlightAtNext) {
+				break;
+			}
+
+			RelocateData absorbed = nrd;
+			for (int i = 0; i < absorbed.src.size(); i++) {
+				ASSERT(queue[absorbed.src[i]].erase(absorbed));
+			}
+			queuedRelocations--;
+			TraceEvent(SevVerbose, "QueuedRelocationsChanged")
+			    .detail("DataMoveID", absorbed.dataMoveId)
+			    .detail("RandomID", absorbed.randomId)
+			    .detail("Total", queuedRelocations);
+			finishRelocation(absorbed.priority, absorbed.healthPriority);
+
+			for (int i = 0; i < rd.completeSources.size(); i++) {
+				const auto& nextComplete = absorbed.completeSources;
+				if (std::find(nextComplete.begin(), nextComplete.end(), rd.completeSources[i]) == nextComplete.end()) {
+					swapAndPop(&rd.completeSources, i--);
+				}
+			}
+			rd.wantsNewServers |= absorbed.wantsNewServers;
+			rd.keys = KeyRangeRef(rd.keys.begin, absorbed.keys.end);
+			shards.push_back(absorbed.keys);
+			batched.push_back(absorbed);
+		}
+
+		if (shards.size() > 1) {
+			CODE_PROBE(true, "Batched adjacent relocations into one data move");
+			DebugRelocationTraceEvent("BatchedRelocations", distributorId)
+			    .detail("KeyBegin", rd.keys.begin)
+			    .detail("KeyEnd", rd.keys.end)
+			    .detail("Priority", rd.priority)
+			    .detail("Shards", shards.size());
+			rd.shards = std::move(shards);
+		}
+	}
+
 	void launchQueuedWork(KeyRange keys, const DDEnabledState* ddEnabledState) {
 		// combine all queued work in the key range and check to see if there is anything to launch
 		std::set<RelocateData, std::greater<RelocateData>> combined;
@@ -1127,8 +1198,12 @@ struct DDQueue {
 		int startedHere = 0;
 		double startTime = now();
 		// kick off relocators from items in the queue as need be
+		std::vector<RelocateData> batched;
 		std::set<RelocateData, std::greater<RelocateData>>::iterator it = combined.begin();
 		for (; it != combined.end(); it++) {
+			if (std::find(batched.begin(), batched.end(), *it) != batched.end()) {
+				continue; // Already launched as part of an earlier relocation
+			}
 			RelocateData rd(*it);
 
 			// Check if there is an inflight shard that is overlapped with the queued relocateShard (rd)
@@ -1192,6 +1267,11 @@ struct DDQueue {
 				for (int i = 0; i < rd.src.size(); i++) {
 					ASSERT(queue[rd.src[i]].erase(rd));
 				}
+
+				if (SERVER_KNOBS->DD_BATCH_MOVE_MAX_SHARDS > 1 && !SERVER_KNOBS->SHARD_ENCODE_LOCATION_METADATA &&
+				    rd.healthPriority >= 0) {
+					batchAdjacentRelocations(rd, batched);
+				}
 			}
 
 			Future<Void> fCleanup =
@@ -1352,6 +1432,72 @@ static std::string destServersString(std::vector<std::pair<Reference<IDataDistri
 	return std::move(ss).str();
 }
 
+// Moves the keys of rd to destIds. A batched relocation moves each of its shards with its own MoveKeys, so that the
+// metadata transactions of the shards are pipelined and the destination servers fetch the shards concurrently;
+// dataMovementComplete is then signalled once the data of every shard has been transferred.
+ACTOR Future<Void> moveShards(DDQueue* self,
+                              RelocateData rd,
+                              std::vector<UID> destIds,
+                              std::vector<UID> healthyIds,
+                              Promise<Void> dataMovementComplete,
+                              UID relocationIntervalId,
+                              const DDEnabledState* ddEnabledState) {
+	state std::vector<KeyRange> shards;
+	for (const auto& shard : rd.shards) {
+		if (shard.intersects(rd.keys)) {
+			shards.push_back(shard & rd.keys);
+		}
+	}
+
+	// The relocation was not batched, or only one shard of the batch lies in its range
+	if (shards.size() < 2) {
+		wait(moveKeys(self->cx,
+		              rd.dataMoveId,
+		              rd.keys,
+		              destIds,
+		              healthyIds,
+		              self->lock,
+		              dataMovementComplete,
+		              &self->startMoveKeysParallelismLock,
+		              &self->finishMoveKeysParallelismLock,
+		              self->teamCollections.size() > 1,
+		              relocationIntervalId,
+		              ddEnabledState,
+		              CancelConflictingDataMoves::False));
+		return Void();
+	}
+
+	state std::vector<Future<Void>> moves;
+	state std::vector<Future<Void>> transferred;
+	for (const auto& keys : shards) {
+		Promise<Void> shardMovementComplete;
+		transferred.push_back(brokenPromiseToNever(shardMovementComplete.getFuture()));
+		moves.push_back(moveKeys(self->cx,
+		                         rd.dataMoveId,
+		                         keys,
+		                         destIds,
+		                         healthyIds,
+		                         self->lock,
+		                         shardMovementComplete,
+		                         &self->startMoveKeysParallelismLock,
+		                         &self->finishMoveKeysParallelismLock,
+		                         self->teamCollections.size() > 1,
+		                         relocationIntervalId,
+		                         ddEnabledState,
+		                         CancelConflictingDataMoves::False));
+	}
+
+	state Future<Void> allMoved = waitForAll(moves);
+	choose {
+		when(wait(allMoved)) {}
+		when(wait(waitForAll(transferred))) {
+			dataMovementComplete.send(Void());
+			wait(allMoved);
+		}
+	}
+	return Void();
+}
+
 // This actor relocates the specified keys to a good place.
 // The inFlightActor key range map stores the actor for each RelocateData
 ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
@@ -1468,11 +1614,14 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 						    rd.healthPriority == SERVER_KNOBS->PRIORITY_TEAM_0_LEFT)
 							inflightPenalty = SERVER_KNOBS->INFLIGHT_PENALTY_ONE_LEFT;
 
+						// The read hot pieces of a split shard go to the team with the least read load
+						bool readSplit = rd.reason == RelocateReason::READ_SPLIT;
 						auto req = GetTeamRequest(WantNewServers(rd.wantsNewServers),
-						                          WantTrueBest(isValleyFillerPriority(rd.priority)),
+						                          WantTrueBest(isValleyFillerPriority(rd.priority) || readSplit),
 						                          PreferLowerDiskUtil::True,
 						                          TeamMustHaveShards::False,
-						                          ForReadBalance(rd.reason == RelocateReason::REBALANCE_READ),
+						                          ForReadBalance(rd.reason == RelocateReason::REBALANCE_READ ||
+						                                         readSplit),
 						                          PreferLowerReadUtil::True,
 						                          inflightPenalty);
 
@@ -1646,19 +1795,8 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 			state Error error = success();
 			state Promise<Void> dataMovementComplete;
 			// Move keys from source to destination by changing the serverKeyList and keyServerList system keys
-			state Future<Void> doMoveKeys = moveKeys(self->cx,
-			                                         rd.dataMoveId,
-			                                         rd.keys,
-			                                         destIds,
-			                                         healthyIds,
-			                                         self->lock,
-			                                         dataMovementComplete,
-			                                         &self->startMoveKeysParallelismLock,
-			                                         &self->finishMoveKeysParallelismLock,
-			                                         self->teamCollections.size() > 1,
-			                                         relocateShardInterval.pairID,
-			                                         ddEnabledState,
-			                                         CancelConflictingDataMoves::False);
+			state Future<Void> doMoveKeys = moveShards(
+			    self, rd, destIds, healthyIds, dataMovementComplete, relocateShardInterval.pairID, ddEnabledState);
 			state Future<Void> pollHealth =
 			    signalledTransferComplete ? Never()
 			                              : delay(SERVER_KNOBS->HEALTH_POLL_TIME, TaskPriority::DataDistributionLaunch);
@@ -1671,19 +1809,13 @@ ACTOR Future<Void> dataDistributionRelocator(DDQueue* self,
 								healthyIds.insert(healthyIds.end(), extraIds.begin(), extraIds.end());
 								extraIds.clear();
 								ASSERT(totalIds == destIds.size()); // Sanity check the destIDs before we move keys
-								doMoveKeys = moveKeys(self->cx,
-								                      rd.dataMoveId,
-								                      rd.keys,
-								                      destIds,
-								                      healthyIds,
-								                      self->lock,
-								                      Promise<Void>(),
-								                      &self->startMoveKeysParallelismLock,
-								                      &self->finishMoveKeysParallelismLock,
-								                      self->teamCollections.size() > 1,
-								                      relocateShardInterval.pairID,
-								                      ddEnabledState,
-								                      CancelConflictingDataMoves::False);
+								doMoveKeys = moveShards(self,
+								                        rd,
+								                        destIds,
+								                        healthyIds,
+								                        Promise<Void>(),
+								                        relocateShardInterval.pairID,
+								                        ddEnabledState);
 							} else {
 								self->fetchKeysComplete.insert(rd);
 								if (SERVER_KNOBS->SHARD_ENCODE_LOCATION_METADATA) {
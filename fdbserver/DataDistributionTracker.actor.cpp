@@ -23,6 +23,8 @@
 #include "fdbserver/DataDistribution.actor.h"
 #include "fdbserver/Knobs.h"
 #include "fdbclient/DatabaseContext.h"
+#include "fdbclient/ManagementAPI.actor.h"
+#include "fdbclient/ReadYourWrites.h"
 #include "flow/ActorCollection.h"
 #include "flow/FastRef.h"
 #include "flow/Trace.h"
@@ -88,6 +90,7 @@ struct DataDistributionTracker {
 
 	// Read hot detection
 	PromiseStream<KeyRange> readHotShard;
+	PromiseStream<KeyRange> readHotRangeToCache;
 
 	// The reference to trackerCancelled must be extracted by actors,
 	// because by the time (trackerCancelled == true) this memory cannot
@@ -345,6 +348,9 @@ ACTOR Future<Void> readHotDetector(DataDistributionTracker* self) {
 						    .detail("ReadDensityThreshold", SERVER_KNOBS->SHARD_MAX_READ_DENSITY_RATIO)
 						    .detail("KeyRangeBegin", keyRange.keys.begin)
 						    .detail("KeyRangeEnd", keyRange.keys.end);
+						if (SERVER_KNOBS->DD_AUTO_CACHE_READ_HOT_RANGES && keyRange.keys.end <= normalKeys.end) {
+							self->readHotRangeToCache.send(keyRange.keys);
+						}
 					}
 					break;
 				} catch (Error& e) {
@@ -359,6 +365,159 @@ ACTOR Future<Void> readHotDetector(DataDistributionTracker* self) {
 	}
 }
 
+// Caches range and records it in autoCachedRangeKeys in one transaction, so that nobody can cache an overlapping range
+// in between. Does nothing if any part of range is cached already, or if there are no storage cache servers to cache
+// it. Returns whether range was cached.
+ACTOR Future<bool> autoCacheRange(Database cx, KeyRange range) {
+	state Reference<ReadYourWritesTransaction> tr = makeReference<ReadYourWritesTransaction>(cx);
+	loop {
+		try {
+			tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr->setOption(FDBTransactionOptions::LOCK_AWARE);
+			state Future<RangeResult> cacheServers = tr->getRange(storageCacheServerKeys, 1);
+			// The last boundary at or before range.begin, and every boundary inside the range
+			state Key beginKey = storageCacheKey(range.begin);
+			state Future<RangeResult> before =
+			    tr->getRange(KeyRangeRef(storageCachePrefix, keyAfter(beginKey)), 1, Snapshot::False, Reverse::True);
+			state Future<RangeResult> inside =
+			    tr->getRange(KeyRangeRef(keyAfter(beginKey), storageCacheKey(range.end)), 1);
+			wait(success(cacheServers) && success(before) && success(inside));
+			if (cacheServers.get().empty() || !inside.get().empty()) {
+				return false;
+			}
+			std::vector<uint16_t> serverIndices;
+			if (!before.get().empty()) {
+				decodeStorageCacheValue(before.get()[0].value, serverIndices);
+			}
+			if (!serverIndices.empty()) {
+				return false;
+			}
+
+			tr->set(autoCachedRangeKeyFor(range.begin), range.end);
+			wait(ManagementAPI::changeCachedRangeInTransaction(tr, range, true));
+			wait(tr->commit());
+			return true;
+		} catch (Error& e) {
+			wait(tr->onError(e));
+		}
+	}
+}
+
+// Uncaches range and removes it from autoCachedRangeKeys in one transaction. If the cache boundaries of range are no
+// longer the two autoCacheRange() wrote, someone has changed the caching of an overlapping range since, so range is
+// only forgotten and stays cached as they left it. Returns whether range was uncached.
+ACTOR Future<bool> autoUncacheRange(Database cx, KeyRange range) {
+	state Reference<ReadYourWritesTransaction> tr = makeReference<ReadYourWritesTransaction>(cx);
+	loop {
+		try {
+			tr->setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+			tr->setOption(FDBTransactionOptions::LOCK_AWARE);
+			state Key beginKey = storageCacheKey(range.begin);
+			state Key endKey = storageCacheKey(range.end);
+			RangeResult boundaries = wait(tr->getRange(KeyRangeRef(beginKey, keyAfter(endKey)), 3));
+			state bool untouched = false;
+			if (boundaries.size() == 2 && boundaries[0].key == beginKey && boundaries[1].key == endKey) {
+				std::vector<uint16_t> beginIndices, endIndices;
+				decodeStorageCacheValue(boundaries[0].value, beginIndices);
+				decodeStorageCacheValue(boundaries[1].value, endIndices);
+				untouched = !beginIndices.empty() && endIndices.empty();
+			}
+
+			tr->clear(autoCachedRangeKeyFor(range.begin));
+			if (untouched) {
+				wait(ManagementAPI::changeCachedRangeInTransaction(tr, range, false));
+			}
+			wait(tr->commit());
+			return untouched;
+		} catch (Error& e) {
+			wait(tr->onError(e));
+		}
+	}
+}
+
+// Assigns read hot ranges to the storage cache servers and retires them once they have stopped being read hot for
+// DD_AUTO_CACHE_RETIRE_DELAY. Ranges are recorded in autoCachedRangeKeys in the transaction that caches them and
+// forgotten in the one that uncaches them, so that a new data distributor can take over ranges cached by its
+// predecessor.
+ACTOR Future<Void> readHotRangeCacheManager(DataDistributionTracker* self) {
+	// Range begin => (range, last time the range was seen read hot)
+	state std::map<Key, std::pair<KeyRange, double>> autoCached;
+	state Future<Void> checkTimer = delay(SERVER_KNOBS->DD_AUTO_CACHE_CHECK_INTERVAL);
+	state Transaction tr(self->cx);
+	state KeyRange candidate;
+	state std::vector<KeyRange> cachedRanges;
+	state int i = 0;
+
+	try {
+		loop {
+			try {
+				tr.setOption(FDBTransactionOptions::ACCESS_SYSTEM_KEYS);
+				tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+				RangeResult existing = wait(tr.getRange(autoCachedRangeKeys, CLIENT_KNOBS->TOO_MANY));
+				ASSERT(!existing.more);
+				for (auto& kv : existing) {
+					KeyRange range(KeyRangeRef(decodeAutoCachedRangeKey(kv.key), kv.value));
+					autoCached[range.begin] = std::make_pair(range, now());
+				}
+				break;
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+
+		loop choose {
+			when(KeyRange range = waitNext(self->readHotRangeToCache.getFuture())) {
+				candidate = range;
+				auto it = autoCached.upper_bound(candidate.begin);
+				if (it != autoCached.begin() && std::prev(it)->second.first.intersects(candidate)) {
+					std::prev(it)->second.second = now();
+				} else if (it != autoCached.end() && it->second.first.intersects(candidate)) {
+					it->second.second = now();
+				} else if (autoCached.size() < (size_t)SERVER_KNOBS->DD_AUTO_CACHE_MAX_RANGES) {
+					bool cached = wait(autoCacheRange(self->cx, candidate));
+					if (cached) {
+						autoCached[candidate.begin] = std::make_pair(candidate, now());
+						CODE_PROBE(true, "Data distribution cached a read hot range");
+						TraceEvent("DDAutoCacheRange", self->distributorId)
+						    .detail("Begin", candidate.begin)
+						    .detail("End", candidate.end)
+						    .detail("CachedRanges", autoCached.size());
+					}
+				}
+			}
+			when(wait(checkTimer)) {
+				cachedRanges.clear();
+				for (auto& it : autoCached) {
+					cachedRanges.push_back(it.second.first);
+				}
+				for (i = 0; i < cachedRanges.size(); i++) {
+					Standalone<VectorRef<ReadHotRangeWithMetrics>> hot =
+					    wait(self->cx->getReadHotRanges(cachedRanges[i]));
+					double lastHot = autoCached[cachedRanges[i].begin].second;
+					if (!hot.empty()) {
+						autoCached[cachedRanges[i].begin].second = now();
+					} else if (now() - lastHot > SERVER_KNOBS->DD_AUTO_CACHE_RETIRE_DELAY) {
+						bool uncached = wait(autoUncacheRange(self->cx, cachedRanges[i]));
+						autoCached.erase(cachedRanges[i].begin);
+						CODE_PROBE(uncached, "Data distribution uncached a range that is no longer read hot");
+						CODE_PROBE(!uncached, "Data distribution left an auto cached range changed by someone else");
+						TraceEvent("DDAutoUncacheRange", self->distributorId)
+						    .detail("Begin", cachedRanges[i].begin)
+						    .detail("End", cachedRanges[i].end)
+						    .detail("Uncached", uncached)
+						    .detail("CachedRanges", autoCached.size());
+					}
+				}
+				checkTimer = delay(SERVER_KNOBS->DD_AUTO_CACHE_CHECK_INTERVAL);
+			}
+		}
+	} catch (Error& e) {
+		if (e.code() != error_code_actor_cancelled)
+			self->output.sendError(e); // Propagate failure to dataDistributionTracker
+		throw e;
+	}
+}
+
 /*
 ACTOR Future<Void> extrapolateShardBytes( Reference<AsyncVar<Optional<int64_t>>> inBytes,
 Reference<AsyncVar<Optional<int64_t>>> outBytes ) { state std::deque< std::pair<double,int64_t> > past; loop { wait(
@@ -490,14 +649,37 @@ ACTOR Future<Void> shardSplitter(DataDistributionTracker* self,
 	splitMetrics.bytesPerKSecond =
 	    keys.begin >= keyServersKeys.begin ? splitMetrics.infinity : SERVER_KNOBS->SHARD_SPLIT_BYTES_PER_KSEC;
 	splitMetrics.iosPerKSecond = splitMetrics.infinity;
-	splitMetrics.bytesReadPerKSecond = splitMetrics.infinity; // Don't split by readBandwidth
+	if (reason == RelocateReason::READ_SPLIT) {
+		// Split the read bandwidth in (at least) two so that the hot keys end up in a piece of their own
+		splitMetrics.bytesReadPerKSecond =
+		    std::max(metrics.bytesReadPerKSecond / 2, SERVER_KNOBS->SHARD_READ_HOT_BANDWIDTH_MIN_PER_KSECONDS);
+	} else {
+		splitMetrics.bytesReadPerKSecond = splitMetrics.infinity; // Don't split by readBandwidth
+	}
 
 	state Standalone<VectorRef<KeyRef>> splitKeys = wait(getSplitKeys(self, keys, splitMetrics, metrics));
 	// fprintf(stderr, "split keys:\n");
 	// for( int i = 0; i < splitKeys.size(); i++ ) {
 	//	fprintf(stderr, "   %s\n", printable(splitKeys[i]).c_str());
 	//}
-	int numShards = splitKeys.size() - 1;
+	state int numShards = splitKeys.size() - 1;
+	state int skipRange = numShards > 1 ? deterministicRandom()->randomInt(0, numShards) : 0;
+
+	if (reason == RelocateReason::READ_SPLIT && numShards > 1) {
+		// Leave the coldest piece where it is, so that the read hot pieces are the ones moved to other teams
+		state std::vector<Future<StorageMetrics>> pieceMetrics;
+		for (int i = 0; i < numShards; i++) {
+			pieceMetrics.push_back(
+			    self->cx->getStorageMetrics(KeyRangeRef(splitKeys[i], splitKeys[i + 1]), CLIENT_KNOBS->TOO_MANY));
+		}
+		wait(waitForAll(pieceMetrics));
+		for (int i = 0; i < numShards; i++) {
+			if (pieceMetrics[i].get().bytesReadPerKSecond < pieceMetrics[skipRange].get().bytesReadPerKSecond) {
+				skipRange = i;
+			}
+		}
+		CODE_PROBE(true, "Read hot shard split");
+	}
 
 	TraceEvent("RelocateShardStartSplit", self->distributorId)
 	    .suppressFor(1.0)
@@ -510,10 +692,11 @@ ACTOR Future<Void> shardSplitter(DataDistributionTracker* self,
 	            : bandwidthStatus == BandwidthStatusNormal ? "Normal"
 	                                                       : "Low")
 	    .detail("BytesPerKSec", metrics.bytesPerKSecond)
+	    .detail("BytesReadPerKSec", metrics.bytesReadPerKSecond)
+	    .detail("Reason", reason.toString())
 	    .detail("NumShards", numShards);
 
 	if (numShards > 1) {
-		int skipRange = deterministicRandom()->randomInt(0, numShards);
 		// The queue can't deal with RelocateShard requests which split an existing shard into three pieces, so
 		// we have to send the unskipped ranges in this order (nibbling in from the edges of the old range)
 		for (int i = 0; i < skipRange; i++)
@@ -535,8 +718,10 @@ ACTOR Future<Void> shardSplitter(DataDistributionTracker* self,
 
 		self->sizeChanges.add(changeSizes(self, keys, shardSize->get().get().metrics.bytes));
 	} else {
-		wait(delay(1.0, TaskPriority::DataDistribution)); // In case the reason the split point was off was due to a
-		                                                  // discrepancy between storage servers
+		// In case the reason the split point was off was due to a discrepancy between storage servers. A read hot shard
+		// whose reads are concentrated on a single key cannot be split, so do not keep retrying it quickly.
+		wait(delay(reason == RelocateReason::READ_SPLIT ? SERVER_KNOBS->DD_READ_HOT_SPLIT_RETRY_DELAY : 1.0,
+		           TaskPriority::DataDistribution));
 	}
 	return Void();
 }
@@ -627,6 +812,8 @@ Future<Void> shardMerger(DataDistributionTracker* self,
 		// If we just recently get the current shard's metrics (i.e., less than DD_LOW_BANDWIDTH_DELAY ago), it means
 		// the shard's metric may not be stable yet. So we cannot continue merging in this direction.
 		if (endingStats.bytes >= shardBounds.min.bytes || getBandwidthStatus(endingStats) != BandwidthStatusLow ||
+		    (SERVER_KNOBS->DD_SPLIT_READ_HOT_SHARDS &&
+		     getReadBandwidthStatus(endingStats) == ReadBandwidthStatusHigh) ||
 		    now() - lastLowBandwidthStartTime < SERVER_KNOBS->DD_LOW_BANDWIDTH_DELAY ||
 		    shardsMerged >= SERVER_KNOBS->DD_MERGE_LIMIT) {
 			// The merged range is larger than the min bounds so we cannot continue merging in this direction.
@@ -696,8 +883,13 @@ ACTOR Future<Void> shardEvaluator(DataDistributionTracker* self,
 	auto bandwidthStatus = getBandwidthStatus(stats);
 	bool sizeSplit = stats.bytes > shardBounds.max.bytes,
 	     writeSplit = bandwidthStatus == BandwidthStatusHigh && keys.begin < keyServersKeys.begin;
-	bool shouldSplit = sizeSplit || writeSplit;
-	bool shouldMerge = stats.bytes < shardBounds.min.bytes && bandwidthStatus == BandwidthStatusLow;
+	bool readSplit = SERVER_KNOBS->DD_SPLIT_READ_HOT_SHARDS && !sizeSplit && !writeSplit &&
+	                 keys.begin < keyServersKeys.begin && getReadBandwidthStatus(stats) == ReadBandwidthStatusHigh;
+	bool shouldSplit = sizeSplit || writeSplit || readSplit;
+	// Don't merge away the pieces of a read hot shard that was split
+	bool shouldMerge = stats.bytes < shardBounds.min.bytes && bandwidthStatus == BandwidthStatusLow &&
+	                   !(SERVER_KNOBS->DD_SPLIT_READ_HOT_SHARDS &&
+	                     getReadBandwidthStatus(stats) == ReadBandwidthStatusHigh);
 
 	// Every invocation must set this or clear it
 	if (shouldMerge && !self->anyZeroHealthyTeams->get()) {
@@ -728,7 +920,9 @@ ACTOR Future<Void> shardEvaluator(DataDistributionTracker* self,
 		onChange = onChange || shardMerger(self, keys, shardSize);
 	}
 	if (shouldSplit) {
-		RelocateReason reason = writeSplit ? RelocateReason::WRITE_SPLIT : RelocateReason::SIZE_SPLIT;
+		RelocateReason reason = writeSplit  ? RelocateReason::WRITE_SPLIT
+		                        : readSplit ? RelocateReason::READ_SPLIT
+		                                    : RelocateReason::SIZE_SPLIT;
 		onChange = onChange || shardSplitter(self, keys, shardSize, shardBounds, reason);
 	}
 
@@ -1019,6 +1213,8 @@ ACTOR Future<Void> dataDistributionTracker(Reference<InitialDataDistribution> in
 	                                   *trackerCancelled);
 	state Future<Void> loggingTrigger = Void();
 	state Future<Void> readHotDetect = readHotDetector(&self);
+	state Future<Void> readHotCacheManager =
+	    SERVER_KNOBS->DD_AUTO_CACHE_READ_HOT_RANGES ? readHotRangeCacheManager(&self) : Never();
 	state Reference<EventCacheHolder> ddTrackerStatsEventHolder = makeReference<EventCacheHolder>("DDTrackerStats");
 	try {
 		wait(trackInitialShards(&self, initData));
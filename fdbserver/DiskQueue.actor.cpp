@@ -768,10 +768,12 @@ public:
 			}
 		}
 
-		// Read up to 1MB into readingBuffer
-		int len = std::min<int64_t>((files[readingFile].size / sizeof(Page) - readingPage) * sizeof(Page),
-		                            BUGGIFY_WITH_PROB(1.0) ? sizeof(Page) * deterministicRandom()->randomInt(1, 4)
-		                                                   : (1 << 20));
+		// Read up to DISK_QUEUE_RECOVERY_READ_BYTES (rounded down to whole pages) into readingBuffer
+		int len = std::min<int64_t>(
+		    (files[readingFile].size / sizeof(Page) - readingPage) * sizeof(Page),
+		    BUGGIFY_WITH_PROB(1.0)
+		        ? sizeof(Page) * deterministicRandom()->randomInt(1, 4)
+		        : std::max<int64_t>(1, SERVER_KNOBS->DISK_QUEUE_RECOVERY_READ_BYTES / sizeof(Page)) * sizeof(Page));
 		readingBuffer.clear();
 		readingBuffer.alignReserve(sizeof(Page), len);
 		void* p = readingBuffer.append(len);
@@ -281,22 +281,40 @@ class GlobalTagThrottlerImpl {
 		}
 	}
 
+	// Tenant tags are added to transactions automatically, and so usually have no quota. They still get a fair share of
+	// a busy storage server: the same weight as the average tag with a quota on that storage server.
+	static bool hasFairShare(TransactionTagRef tag) { return isTenantTransactionTag(tag); }
+
 	// Of all tags meaningfully performing workload on the given storage server,
 	// returns the ratio of total quota allocated to the specified tag
 	double getQuotaRatio(TransactionTagRef tag, UID storageServerId, OpType opType) const {
 		double sumQuota{ 0.0 };
 		double tagQuota{ 0.0 };
+		int tagsWithQuota{ 0 };
+		int tagsWithFairShare{ 0 };
+		bool tagHasFairShare{ false };
 		auto const tagsAffectingStorageServer = getTagsAffectingStorageServer(storageServerId);
 		for (const auto& t : tagsAffectingStorageServer) {
 			auto const tQuota = getQuota(t, opType, LimitType::TOTAL);
-			sumQuota += tQuota.orDefault(0);
-			if (tag.compare(tag) == 0) {
+			if (tQuota.present()) {
+				sumQuota += tQuota.get();
+				++tagsWithQuota;
+			} else if (hasFairShare(t)) {
+				++tagsWithFairShare;
+			}
+			if (t.compare(tag) == 0) {
 				tagQuota = tQuota.orDefault(0);
+				tagHasFairShare = !tQuota.present() && hasFairShare(t);
 			}
 		}
+		double const fairShareQuota = tagsWithQuota > 0 ? sumQuota / tagsWithQuota : 1.0;
+		if (tagHasFairShare) {
+			tagQuota = fairShareQuota;
+		}
 		if (tagQuota == 0.0) {
 			return 0;
 		}
+		sumQuota += tagsWithFairShare * fairShareQuota;
 		ASSERT_GT(sumQuota, 0.0);
 		return tagQuota / sumQuota;
 	}
@@ -399,12 +417,20 @@ class GlobalTagThrottlerImpl {
 		Optional<double> desiredTps;
 		desiredTps = getMin(readDesiredTps, writeDesiredTps);
 
+		// A tag with a fair share but no quota is only limited while it shares a busy storage server
+		bool const fairShareOnly = !desiredTps.present() && hasFairShare(tag);
+		if (fairShareOnly) {
+			desiredTps = limitingTps;
+		}
+
 		if (!desiredTps.present()) {
 			return {};
 		}
 
-		isReadBusy = readLimitingTps.present() && readLimitingTps.get() < readDesiredTps.orDefault(0);
-		isWriteBusy = writeLimitingTps.present() && writeLimitingTps.get() < writeDesiredTps.orDefault(0);
+		isReadBusy = readLimitingTps.present() &&
+		             (fairShareOnly || readLimitingTps.get() < readDesiredTps.orDefault(0));
+		isWriteBusy = writeLimitingTps.present() &&
+		              (fairShareOnly || writeLimitingTps.get() < writeDesiredTps.orDefault(0));
 
 		auto const readReservedTps = getTps(tag, OpType::READ, LimitType::RESERVED, averageTransactionReadCost);
 		auto const writeReservedTps = getTps(tag, OpType::WRITE, LimitType::RESERVED, averageTransactionWriteCost);
@@ -426,7 +452,7 @@ class GlobalTagThrottlerImpl {
 		tagStats.desiredTps = desiredTps.get();
 		tagStats.limitingTps = limitingTps;
 		tagStats.targetTps = targetTps.get();
-		tagStats.reservedTps = reservedTps.get();
+		tagStats.reservedTps = reservedTps.orDefault(0);
 
 		return targetTps;
 	}
@@ -1083,6 +1109,28 @@ TEST_CASE("/GlobalTagThrottler/MultiTagActiveThrottling3") {
 	return Void();
 }
 
+// Tenant tags without a quota share a busy storage server equally
+TEST_CASE("/GlobalTagThrottler/TenantFairShare") {
+	state GlobalTagThrottler globalTagThrottler(Database{}, UID{});
+	state GlobalTagThrottlerTesting::StorageServerCollection storageServers(10, 5);
+	TransactionTag testTag1 = tenantTransactionTag("tenant1"_sr);
+	TransactionTag testTag2 = tenantTransactionTag("tenant2"_sr);
+	std::vector<Future<Void>> futures;
+	futures.push_back(GlobalTagThrottlerTesting::runClient(
+	    &globalTagThrottler, &storageServers, testTag1, 20.0, 6.0, GlobalTagThrottlerTesting::OpType::READ));
+	futures.push_back(GlobalTagThrottlerTesting::runClient(
+	    &globalTagThrottler, &storageServers, testTag2, 10.0, 6.0, GlobalTagThrottlerTesting::OpType::READ));
+	state Future<Void> monitor =
+	    GlobalTagThrottlerTesting::monitor(&globalTagThrottler, [testTag1, testTag2](auto& gtt) {
+		    return GlobalTagThrottlerTesting::targetRateIsNear(gtt, testTag1, (50 / 6.0) / 2) &&
+		           GlobalTagThrottlerTesting::targetRateIsNear(gtt, testTag2, (50 / 6.0) / 2) &&
+		           gtt.busyReadTagCount() == 2;
+	    });
+	futures.push_back(GlobalTagThrottlerTesting::updateGlobalTagThrottler(&globalTagThrottler, &storageServers));
+	wait(timeoutError(waitForAny(futures) || monitor, 300.0));
+	return Void();
+}
+
 TEST_CASE("/GlobalTagThrottler/ReservedReadQuota") {
 	state GlobalTagThrottler globalTagThrottler(Database{}, UID{});
 	state GlobalTagThrottlerTesting::StorageServerCollection storageServers(10, 5);
@@ -0,0 +1,175 @@
+/*
+ * HotKeySketch.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/SystemData.h"
+#include "fdbserver/HotKeySketch.h"
+#include "fdbserver/Knobs.h"
+#include "flow/UnitTest.h"
+
+HotKeySketch::HotKeySketch(int capacity) : capacity(std::max(capacity, 1)) {}
+
+void HotKeySketch::add(KeyRef key, int64_t cost) {
+	if (cost <= 0) {
+		return;
+	}
+	total += cost;
+
+	auto it = counters.find(key);
+	if (it == counters.end()) {
+		Counter counter;
+		if (counters.size() >= capacity) {
+			// Replace the key with the smallest cost, which bounds the cost the new key may have had before now
+			auto victim = byCost.begin();
+			counter.cost = counter.error = victim->first;
+			counters.erase(counters.find(victim->second));
+			byCost.erase(victim);
+		}
+		it = counters.emplace(key, counter).first;
+	} else {
+		byCost.erase(std::make_pair(it->second.cost, KeyRef(it->first)));
+	}
+	it->second.cost += cost;
+	byCost.emplace(it->second.cost, it->first);
+}
+
+int64_t HotKeySketch::estimate(KeyRef key) const {
+	auto it = counters.find(key);
+	return it == counters.end() ? 0 : it->second.cost;
+}
+
+std::vector<std::pair<KeyRef, HotKeySketch::Counter>> HotKeySketch::getTop(KeyRangeRef keys, int limit) const {
+	std::vector<std::pair<KeyRef, Counter>> top;
+	for (auto it = byCost.rbegin(); it != byCost.rend() && top.size() < limit; ++it) {
+		if (keys.contains(it->second)) {
+			top.emplace_back(it->second, counters.find(it->second)->second);
+		}
+	}
+	return top;
+}
+
+void HotKeySketch::clear() {
+	total = 0;
+	counters.clear();
+	byCost.clear();
+}
+
+HotKeyTracker::HotKeyTracker()
+  : reads(SERVER_KNOBS->HOT_KEY_SKETCH_CAPACITY), writes(SERVER_KNOBS->HOT_KEY_SKETCH_CAPACITY),
+    previousReads(SERVER_KNOBS->HOT_KEY_SKETCH_CAPACITY), previousWrites(SERVER_KNOBS->HOT_KEY_SKETCH_CAPACITY),
+    intervalStart(now()) {}
+
+void HotKeyTracker::sample(HotKeySketch& sketch, KeyRef key, int64_t bytes) {
+	if (SERVER_KNOBS->HOT_KEY_SAMPLE_RATE <= 0) {
+		return;
+	}
+	// Weight the sampled operations so that the sketch estimates the bytes of all operations
+	if (deterministicRandom()->random01() < SERVER_KNOBS->HOT_KEY_SAMPLE_RATE) {
+		sketch.add(key, std::max<int64_t>(1, (int64_t)(bytes / std::min(SERVER_KNOBS->HOT_KEY_SAMPLE_RATE, 1.0))));
+	}
+}
+
+void HotKeyTracker::startNewInterval() {
+	double elapsed = now() - intervalStart;
+	if (elapsed <= 0) {
+		return;
+	}
+	std::swap(previousReads, reads);
+	std::swap(previousWrites, writes);
+	reads.clear();
+	writes.clear();
+	previousElapsed = elapsed;
+	intervalStart = now();
+}
+
+Standalone<VectorRef<HotKeyMetrics>> HotKeyTracker::getHotKeys(KeyRangeRef keys, int limit) const {
+	Standalone<VectorRef<HotKeyMetrics>> result;
+	if (previousElapsed <= 0 || limit <= 0) {
+		return result;
+	}
+
+	// A key hot for writes alone may be missing from the read sketch and vice versa, so merge all keys of both
+	std::map<KeyRef, HotKeyMetrics> merged;
+	for (auto& [key, counter] : previousReads.getTop(keys, SERVER_KNOBS->HOT_KEY_SKETCH_CAPACITY)) {
+		merged[key].readBytesPerSecond = counter.cost / previousElapsed;
+	}
+	for (auto& [key, counter] : previousWrites.getTop(keys, SERVER_KNOBS->HOT_KEY_SKETCH_CAPACITY)) {
+		merged[key].writeBytesPerSecond = counter.cost / previousElapsed;
+	}
+
+	std::vector<HotKeyMetrics> sorted;
+	sorted.reserve(merged.size());
+	for (auto& [key, metrics] : merged) {
+		sorted.emplace_back(key, metrics.readBytesPerSecond, metrics.writeBytesPerSecond);
+	}
+	std::sort(sorted.begin(), sorted.end(), [](const HotKeyMetrics& a, const HotKeyMetrics& b) {
+		return a.totalBytesPerSecond() > b.totalBytesPerSecond();
+	});
+	for (int i = 0; i < sorted.size() && i < limit; i++) {
+		result.push_back_deep(result.arena(), sorted[i]);
+	}
+	return result;
+}
+
+TEST_CASE("/fdbserver/HotKeySketch/heavyHitters") {
+	int capacity = deterministicRandom()->randomInt(10, 50);
+	HotKeySketch sketch(capacity);
+	std::map<Key, int64_t> exact;
+
+	// A few keys receive most of the cost, and the rest is spread over many more keys than the sketch can track
+	int hotKeys = deterministicRandom()->randomInt(1, capacity / 2);
+	for (int i = 0; i < 20000; i++) {
+		Key key = deterministicRandom()->random01() < 0.5
+		              ? Key(format("hot%04d", deterministicRandom()->randomInt(0, hotKeys)))
+		              : Key(format("cold%06d", deterministicRandom()->randomInt(0, 10000)));
+		int64_t cost = deterministicRandom()->randomInt(1, 100);
+		sketch.add(key, cost);
+		exact[key] += cost;
+	}
+	ASSERT(sketch.size() == capacity);
+
+	int64_t total = 0;
+	for (auto& [key, cost] : exact) {
+		total += cost;
+	}
+	ASSERT(sketch.getTotal() == total);
+
+	// Every key with more than total / capacity cost is tracked, and no tracked key is underestimated
+	auto top = sketch.getTop(allKeys, capacity);
+	ASSERT(top.size() == capacity);
+	for (int i = 0; i < top.size(); i++) {
+		ASSERT(i == 0 || top[i - 1].second.cost >= top[i].second.cost);
+		int64_t actual = exact[top[i].first];
+		ASSERT(top[i].second.cost >= actual);
+		ASSERT(top[i].second.cost - top[i].second.error <= actual);
+	}
+	for (auto& [key, cost] : exact) {
+		if (cost > total / capacity) {
+			ASSERT(sketch.estimate(key) >= cost);
+		}
+	}
+
+	auto hotOnly = sketch.getTop(KeyRangeRef("hot"_sr, "hou"_sr), capacity);
+	ASSERT(hotOnly.size() == hotKeys);
+
+	sketch.clear();
+	ASSERT(sketch.size() == 0 && sketch.getTotal() == 0);
+	ASSERT(sketch.getTop(allKeys, capacity).empty());
+	return Void();
+}
@@ -0,0 +1,82 @@
+/*
+ * KeyRoutingIndex.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "fdbserver/KeyRoutingIndex.h"
+
+#include "flow/UnitTest.h"
+
+uint64_t keyHead(KeyRef key) {
+	uint64_t head = 0;
+	for (int i = 0; i < 8 && i < key.size(); i++) {
+		head |= uint64_t(key[i]) << (56 - 8 * i);
+	}
+	return head;
+}
+
+namespace {
+
+// Short keys from a small alphabet, so that many keys share their heads or are prefixes of each other. All of them sort
+// before the end of the map.
+Key randomRoutingKey() {
+	int length = deterministicRandom()->randomInt(0, 12);
+	std::string key;
+	for (int i = 0; i < length; i++) {
+		key += "\x00\x01\xfe"[deterministicRandom()->randomInt(0, 3)];
+	}
+	return Key(key);
+}
+
+} // namespace
+
+TEST_CASE("/fdbserver/KeyRoutingIndex/randomized") {
+	KeyRangeMap<int> map;
+	KeyRoutingIndex<int> index(&map);
+	for (int i = 0; i < 1000; i++) {
+		Key a = randomRoutingKey(), b = randomRoutingKey();
+		if (a == b) {
+			continue;
+		}
+		KeyRange range = KeyRangeRef(std::min(a, b), std::max(a, b));
+		map.insert(range, i + 1);
+		index.invalidate();
+		// Like a commit batch, several boundary changes may be picked up by a single refresh
+		if (deterministicRandom()->random01() < 0.7) {
+			continue;
+		}
+		index.refresh();
+		ASSERT_EQ(index.size(), map.size());
+
+		std::vector<Key> keys;
+		for (int j = 0; j < 20; j++) {
+			keys.push_back(randomRoutingKey());
+		}
+		std::sort(keys.begin(), keys.end());
+		int found = 0;
+		for (auto const& key : keys) {
+			auto expected = map.rangeContaining(key);
+			ASSERT(index.begin(index.find(key)) == expected.begin());
+			found = index.findFrom(found, key);
+			ASSERT(index.begin(found) == expected.begin());
+			ASSERT_EQ(&index.value(found), &expected.value());
+		}
+	}
+	return Void();
+}
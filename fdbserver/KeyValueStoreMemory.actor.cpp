@@ -21,6 +21,7 @@
 #include "fdbclient/Knobs.h"
 #include "fdbclient/Notified.h"
 #include "fdbclient/SystemData.h"
+#include "fdbrpc/Smoother.h"
 #include "fdbserver/DeltaTree.h"
 #include "fdbserver/GetEncryptCipherKeys.h"
 #include "fdbserver/IDiskQueue.h"
@@ -29,6 +30,7 @@
 #include "fdbserver/RadixTree.h"
 #include "flow/ActorCollection.h"
 #include "flow/Knobs.h"
+#include "flow/UnitTest.h"
 #include "flow/actorcompiler.h" // This must be the last #include.
 
 #define OP_DISK_OVERHEAD (sizeof(OpHeader) + 1)
@@ -44,7 +46,8 @@ public:
 	                    bool disableSnapshot,
 	                    bool replaceContent,
 	                    bool exactRecovery,
-	                    bool enableEncryption);
+	                    bool enableEncryption,
+	                    bool idleSnapshots);
 
 	// IClosable
 	Future<Void> getError() const override { return log->getError(); }
@@ -177,11 +180,15 @@ public:
 				return Void();
 			}
 
-			if (bytesWritten > 0 || committedWriteBytes > notifiedCommittedWriteBytes.get()) {
+			if (bytesWritten > 0 || committedWriteBytes > notifiedCommittedWriteBytes.get() ||
+			    (int64_t)snapshotBudgetBytes > notifiedSnapshotBudgetBytes.get()) {
 				committedWriteBytes += bytesWritten + overheadWriteBytes +
 				                       OP_DISK_OVERHEAD; // OP_DISK_OVERHEAD is for the following log_op(OpCommit)
-				notifiedCommittedWriteBytes.set(committedWriteBytes); // This set will cause snapshot items to be
-				                                                      // written, so it must happen before the OpCommit
+				advanceSnapshotBudget(committedWriteBytes - notifiedCommittedWriteBytes.get());
+				notifiedCommittedWriteBytes.set(committedWriteBytes);
+				notifiedSnapshotBudgetBytes.set((int64_t)snapshotBudgetBytes); // This set will cause snapshot items to
+				                                                               // be written, so it must happen before
+				                                                               // the OpCommit
 				log_op(OpCommit, StringRef(), StringRef());
 				overheadWriteBytes = log->getCommitOverhead();
 			}
@@ -375,6 +382,19 @@ private:
 	int64_t committedWriteBytes;
 	int64_t overheadWriteBytes;
 	NotifiedVersion notifiedCommittedWriteBytes;
+	// The number of bytes the snapshot actor may have written.  Equal to notifiedCommittedWriteBytes unless
+	// KVS_MEMORY_ADAPTIVE_SNAPSHOT is enabled, in which case it is paced by advanceSnapshotBudget().
+	NotifiedVersion notifiedSnapshotBudgetBytes;
+	double snapshotBudgetBytes;
+	double snapshotRate; // Snapshot bytes budgeted per committed byte
+	Smoother commitWriteRate;
+	// Bytes logged since this store was opened (or recovered), and the values of that counter at currentSnapshotEnd
+	// and previousSnapshotEnd.  These approximate the log size in bytes for any IDiskQueue implementation.
+	int64_t loggedBytes;
+	int64_t currentSnapshotEndBytes;
+	int64_t previousSnapshotEndBytes;
+	Future<Void> snapshotMetricsLogger;
+	Future<Void> idleSnapshotter;
 	Key recoveredSnapshotKey; // After recovery, the next key in the currently uncompleted snapshot
 	IDiskQueue::location
 	    currentSnapshotEnd; // The end of the most recently completed snapshot (this snapshot cannot be discarded)
@@ -401,28 +421,42 @@ private:
 	TextAndHeaderCipherKeys cipherKeys;
 	Future<Void> refreshCipherKeysActor;
 
+	// Only containers with a real batched insert may be committed with sequential = true
+	static constexpr bool supportsBulkInsert = std::is_same<Container, IKeyValueContainer>::value;
+
 	int64_t commit_queue(OpQueue& ops, bool log, bool sequential = false) {
 		int64_t total = 0, count = 0;
 		IDiskQueue::location log_location = 0;
+		// The largest key in dataSets.  A clear which begins after it cannot affect any pending set, so it does not
+		// need to flush dataSets first.  This keeps snapshot items, which are interleaved with clears of the gaps
+		// between them, in a single sorted batch.
+		StringRef maxPendingKey;
 
 		for (auto o = ops.begin(); o != ops.end(); ++o) {
 			++count;
 			total += o->p1.size() + o->p2.size() + OP_DISK_OVERHEAD;
 			if (o->op == OpSet) {
-				if (sequential) {
+				if (sequential && (dataSets.empty() || o->p1 > maxPendingKey)) {
 					KeyValueMapPair pair(o->p1, o->p2);
+					maxPendingKey = pair.key;
 					dataSets.emplace_back(pair, pair.arena.getSize() + data.getElementBytes());
 				} else {
+					// The batched insert links every pair next to the previous one, so it needs strictly increasing
+					// keys.  Recovered commits may set keys in any order, or more than once.
+					if (sequential) {
+						data.insert(dataSets);
+						dataSets.clear();
+					}
 					data.insert(o->p1, o->p2);
 				}
 			} else if (o->op == OpClear) {
-				if (sequential) {
+				if (sequential && !dataSets.empty() && o->p1 <= maxPendingKey) {
 					data.insert(dataSets);
 					dataSets.clear();
 				}
 				data.erase(data.lower_bound(o->p1), data.lower_bound(o->p2));
 			} else if (o->op == OpClearToEnd) {
-				if (sequential) {
+				if (sequential && !dataSets.empty() && o->p1 <= maxPendingKey) {
 					data.insert(dataSets);
 					dataSets.clear();
 				}
@@ -468,6 +502,7 @@ private:
 	IDiskQueue::location log_op(OpType op, StringRef v1, StringRef v2) {
 		// Metadata op types to be excluded from encryption.
 		static std::unordered_set<OpType> metaOps = { OpSnapshotEnd, OpSnapshotAbort, OpCommit, OpRollback };
+		loggedBytes += v1.size() + v2.size() + OP_DISK_OVERHEAD;
 		if (!enableEncryption || metaOps.count(op) > 0) {
 			OpHeader h = { (int)op, v1.size(), v2.size() };
 			log->push(StringRef((const uint8_t*)&h, sizeof(h)));
@@ -502,10 +537,13 @@ private:
 
 	// In case the op data is not encrypted, simply read the operands and the zero fill flag.
 	// Otherwise, decrypt the op type and data.
+	// If nextHeader is not null, the header of the following op is read in the same readNext() call and returned
+	// through it.  It will be shorter than an OpHeader if the end of the log was reached.
 	ACTOR static Future<Standalone<StringRef>> readOpData(KeyValueStoreMemory* self,
 	                                                      OpHeader* h,
 	                                                      bool* isZeroFilled,
-	                                                      int* zeroFillSize) {
+	                                                      int* zeroFillSize,
+	                                                      Standalone<StringRef>* nextHeader) {
 		// Metadata op types to be excluded from encryption.
 		static std::unordered_set<OpType> metaOps = { OpSnapshotEnd, OpSnapshotAbort, OpCommit, OpRollback };
 		if (metaOps.count((OpType)h->op) == 0) {
@@ -517,8 +555,17 @@ private:
 			// encryption header, plus the real (encrypted) op type
 			remainingBytes += BlobCipherEncryptHeader::headerSize + sizeof(int);
 		}
-		state Standalone<StringRef> data = wait(self->log->readNext(remainingBytes));
-		ASSERT(data.size() <= remainingBytes);
+		state int readBytes = remainingBytes + (nextHeader != nullptr ? sizeof(OpHeader) : 0);
+		state Standalone<StringRef> data = wait(self->log->readNext(readBytes));
+		ASSERT(data.size() <= readBytes);
+		if (nextHeader != nullptr) {
+			if (data.size() > remainingBytes) {
+				*nextHeader = Standalone<StringRef>(data.substr(remainingBytes), data.arena());
+				data.contents() = data.substr(0, remainingBytes);
+			} else {
+				*nextHeader = Standalone<StringRef>();
+			}
+		}
 		*zeroFillSize = remainingBytes - data.size();
 		if (*zeroFillSize == 0) {
 			*isZeroFilled = (data[data.size() - 1] == 0);
@@ -566,34 +613,59 @@ private:
 			state Standalone<StringRef> lastSnapshotKey;
 			state bool isZeroFilled;
 
+			// Snapshot items are written in key order, so applying each recovered commit as one sorted batch lets
+			// the container be built with hinted bulk inserts instead of a full descent per key.
+			state bool bulkInsert = supportsBulkInsert && SERVER_KNOBS->KVS_MEMORY_RECOVERY_BULK_INSERT;
+			state bool prefetchHeaders = SERVER_KNOBS->KVS_MEMORY_RECOVERY_PREFETCH_HEADERS;
+			state Standalone<StringRef> header;
+			state bool headerPrefetched = false;
+			state double recoveryStartTime = timer_monotonic();
+			state double readTime = 0;
+			state double applyTime = 0;
+			state double readStart;
+			state int64_t bytesRead = 0;
+
 			TraceEvent("KVSMemRecoveryStarted", self->id).detail("SnapshotEndLocation", uncommittedSnapshotEnd);
 
 			try {
 				loop {
-					{
-						Standalone<StringRef> data = wait(self->log->readNext(sizeof(OpHeader)));
-						if (data.size() != sizeof(OpHeader)) {
-							if (data.size()) {
-								CODE_PROBE(true, "zero fill partial header in KeyValueStoreMemory");
-								memset(&h, 0, sizeof(OpHeader));
-								memcpy(&h, data.begin(), data.size());
-								zeroFillSize = sizeof(OpHeader) - data.size() + h.len1 + h.len2 + 1;
-								if (h.op == OpEncrypted) {
-									// encryption header, plus the real (encrypted) op type
-									zeroFillSize += BlobCipherEncryptHeader::headerSize + sizeof(int);
-								}
+					if (!headerPrefetched) {
+						readStart = timer_monotonic();
+						Standalone<StringRef> nextHeader = wait(self->log->readNext(sizeof(OpHeader)));
+						readTime += timer_monotonic() - readStart;
+						header = nextHeader;
+					}
+					headerPrefetched = false;
+					bytesRead += header.size();
+					if (header.size() != sizeof(OpHeader)) {
+						if (header.size()) {
+							CODE_PROBE(true, "zero fill partial header in KeyValueStoreMemory");
+							memset(&h, 0, sizeof(OpHeader));
+							memcpy(&h, header.begin(), header.size());
+							zeroFillSize = sizeof(OpHeader) - header.size() + h.len1 + h.len2 + 1;
+							if (h.op == OpEncrypted) {
+								// encryption header, plus the real (encrypted) op type
+								zeroFillSize += BlobCipherEncryptHeader::headerSize + sizeof(int);
 							}
-							TraceEvent("KVSMemRecoveryComplete", self->id)
-							    .detail("Reason", "Non-header sized data read")
-							    .detail("DataSize", data.size())
-							    .detail("ZeroFillSize", zeroFillSize)
-							    .detail("SnapshotEndLocation", uncommittedSnapshotEnd)
-							    .detail("NextReadLoc", self->log->getNextReadLocation());
-							break;
 						}
-						h = *(OpHeader*)data.begin();
+						TraceEvent("KVSMemRecoveryComplete", self->id)
+						    .detail("Reason", "Non-header sized data read")
+						    .detail("DataSize", header.size())
+						    .detail("ZeroFillSize", zeroFillSize)
+						    .detail("SnapshotEndLocation", uncommittedSnapshotEnd)
+						    .detail("NextReadLoc", self->log->getNextReadLocation());
+						break;
 					}
-					state Standalone<StringRef> data = wait(readOpData(self, &h, &isZeroFilled, &zeroFillSize));
+					h = *(OpHeader*)header.begin();
+
+					// The read location after an OpSnapshotEnd is recorded below, so the following header must not
+					// have been consumed yet when that op is processed.
+					headerPrefetched = prefetchHeaders && h.op != OpSnapshotEnd;
+					readStart = timer_monotonic();
+					state Standalone<StringRef> data = wait(
+					    readOpData(self, &h, &isZeroFilled, &zeroFillSize, headerPrefetched ? &header : nullptr));
+					readTime += timer_monotonic() - readStart;
+					bytesRead += data.size();
 					if (zeroFillSize > 0) {
 						TraceEvent("KVSMemRecoveryComplete", self->id)
 						    .detail("Reason", "data specified by header does not exist")
@@ -665,7 +737,9 @@ private:
 						} else if (h.op == OpClearToEnd) { // clear all data from begin key to end
 							recoveryQueue.clear_to_end(p1, &data.arena());
 						} else if (h.op == OpCommit) { // commit previous transaction
-							self->commit_queue(recoveryQueue, false);
+							double applyStart = timer_monotonic();
+							self->commit_queue(recoveryQueue, false, bulkInsert);
+							applyTime += timer_monotonic() - applyStart;
 							++dbgCommitCount;
 							self->recoveredSnapshotKey = uncommittedNextKey;
 							self->previousSnapshotEnd = uncommittedPrevSnapshotEnd;
@@ -716,6 +790,9 @@ private:
 				self->log_op(OpRollback, StringRef(), StringRef()); // rollback previous transaction
 
 				self->committedDataSize = self->data.sumTo(self->data.end());
+				// Everything read was logged after the popped location, which is at or before previousSnapshotEnd
+				self->loggedBytes = bytesRead;
+				self->currentSnapshotEndBytes = self->previousSnapshotEndBytes = 0;
 
 				TraceEvent("KVSMemRecovered", self->id)
 				    .detail("SnapshotItems", dbgSnapshotItemCount)
@@ -724,6 +801,15 @@ private:
 				    .detail("Commits", dbgCommitCount)
 				    .detail("TimeTaken", now() - startt);
 
+				TraceEvent("KVSMemRecoveryMetrics", self->id)
+				    .detail("Elapsed", timer_monotonic() - recoveryStartTime)
+				    .detail("ReadTime", readTime)
+				    .detail("ApplyTime", applyTime)
+				    .detail("BytesRead", bytesRead)
+				    .detail("DataSize", self->committedDataSize)
+				    .detail("BulkInsert", bulkInsert)
+				    .detail("PrefetchHeaders", prefetchHeaders);
+
 				self->semiCommit();
 
 				// Make sure cipher keys are ready before recovery finishes.
@@ -745,9 +831,100 @@ private:
 		}
 	}
 
+	// Bytes that recovery would have to replay if the process restarted now
+	int64_t recoveryLogBytes() const { return loggedBytes - previousSnapshotEndBytes; }
+
+	double estimatedRecoveryTime() const {
+		return recoveryLogBytes() / SERVER_KNOBS->KVS_MEMORY_RECOVERY_BYTES_PER_SECOND;
+	}
+
+	// Adds the snapshot budget earned by newWriteBytes committed bytes.  Normally the snapshot writes exactly as many
+	// bytes as are committed.  With KVS_MEMORY_ADAPTIVE_SNAPSHOT, the snapshot only uses the disk bandwidth that
+	// commits leave over while the log is within its recovery time and size targets, and is forced to at least keep
+	// pace with commits (and to catch up in proportion to the overshoot) once it is not.
+	void advanceSnapshotBudget(int64_t newWriteBytes) {
+		if (!SERVER_KNOBS->KVS_MEMORY_ADAPTIVE_SNAPSHOT) {
+			snapshotRate = 1.0;
+			snapshotBudgetBytes += newWriteBytes;
+			return;
+		}
+
+		commitWriteRate.addDelta(newWriteBytes);
+		double commitBytesPerSecond = commitWriteRate.smoothRate();
+		double spareBytesPerSecond =
+		    std::max(0.0, SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_DISK_BYTES_PER_SECOND - commitBytesPerSecond);
+		double rate = commitBytesPerSecond > 0 ? spareBytesPerSecond / commitBytesPerSecond
+		                                       : SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_MAX_RATE;
+		rate = std::clamp(rate, SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_MIN_RATE, SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_MAX_RATE);
+
+		double behind = std::max(estimatedRecoveryTime() / SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_TARGET_RECOVERY_TIME,
+		                         recoveryLogBytes() / (SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_MAX_LOG_TO_DATA_RATIO *
+		                                               std::max<int64_t>(committedDataSize, 1)));
+		if (behind >= 1.0) {
+			rate = std::max(rate, std::min(behind, SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_MAX_RATE));
+		}
+		CODE_PROBE(rate < 1.0, "KeyValueStoreMemory snapshot slowed down by commit pressure");
+		CODE_PROBE(rate > 1.0, "KeyValueStoreMemory snapshot catching up");
+
+		snapshotRate = rate;
+		snapshotBudgetBytes += newWriteBytes * rate;
+	}
+
+	// Adds the spare disk bandwidth of seconds without commits to the snapshot budget, so that an idle or lightly
+	// written store still catches up on its snapshot. This only happens while the log holds more than a completed
+	// snapshot and the one in progress, since nothing more can be popped before the snapshot ends.
+	void addIdleSnapshotBudget(double seconds) {
+		if (recoveryLogBytes() <= 2 * committedDataSize) {
+			return;
+		}
+		double spareBytesPerSecond =
+		    std::max(0.0, SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_DISK_BYTES_PER_SECOND - commitWriteRate.smoothRate());
+		CODE_PROBE(spareBytesPerSecond > 0, "KeyValueStoreMemory snapshot catching up while idle");
+		snapshotBudgetBytes += spareBytesPerSecond * seconds;
+	}
+
+	// Only used for stores whose log is not committed by anyone else. The commit carries the snapshot items that the
+	// idle budget allows, and no mutations, since it only happens when none are pending.
+	ACTOR static Future<Void> snapshotWhileIdle(KeyValueStoreMemory* self) {
+		wait(self->recovering);
+		state int64_t lastCommittedWriteBytes = self->notifiedCommittedWriteBytes.get();
+		loop {
+			wait(delay(SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_IDLE_INTERVAL));
+			bool idle = self->notifiedCommittedWriteBytes.get() == lastCommittedWriteBytes &&
+			            self->queue.totalSize() == 0 && self->transactionSize == 0;
+			lastCommittedWriteBytes = self->notifiedCommittedWriteBytes.get();
+			if (!SERVER_KNOBS->KVS_MEMORY_ADAPTIVE_SNAPSHOT || !idle) {
+				continue;
+			}
+			self->addIdleSnapshotBudget(SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_IDLE_INTERVAL);
+			if ((int64_t)self->snapshotBudgetBytes > self->notifiedSnapshotBudgetBytes.get()) {
+				wait(self->commit(false));
+				lastCommittedWriteBytes = self->notifiedCommittedWriteBytes.get();
+			}
+		}
+	}
+
+	ACTOR static Future<Void> logSnapshotMetrics(KeyValueStoreMemory* self) {
+		wait(self->recovering);
+		loop {
+			wait(delay(SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_METRICS_INTERVAL));
+			if (self->disableSnapshot) {
+				continue;
+			}
+			TraceEvent("KVSMemSnapshotMetrics", self->id)
+			    .detail("EstimatedRecoveryTime", self->estimatedRecoveryTime())
+			    .detail("RecoveryLogBytes", self->recoveryLogBytes())
+			    .detail("DataSize", self->committedDataSize)
+			    .detail("SnapshotRate", self->snapshotRate)
+			    .detail("CommitWriteRate", self->commitWriteRate.smoothRate())
+			    .detail("Adaptive", SERVER_KNOBS->KVS_MEMORY_ADAPTIVE_SNAPSHOT);
+		}
+	}
+
 	// Snapshots an entire data set
 	void fullSnapshot(Container& snapshotData) {
 		previousSnapshotEnd = log_op(OpSnapshotAbort, StringRef(), StringRef());
+		previousSnapshotEndBytes = loggedBytes;
 		replaceContent = false;
 
 		// Clear everything since we are about to write the whole database
@@ -768,6 +945,7 @@ private:
 		    .detail("SnapshotElements", count);
 
 		currentSnapshotEnd = log_op(OpSnapshotEnd, StringRef(), StringRef());
+		currentSnapshotEndBytes = loggedBytes;
 	}
 
 	ACTOR static Future<Void> snapshot(KeyValueStoreMemory* self) {
@@ -790,7 +968,7 @@ private:
 		TraceEvent("KVSMemStartingSnapshot", self->id).detail("StartKey", nextKey);
 
 		loop {
-			wait(self->notifiedCommittedWriteBytes.whenAtLeast(snapshotTotalWrittenBytes + 1));
+			wait(self->notifiedSnapshotBudgetBytes.whenAtLeast(snapshotTotalWrittenBytes + 1));
 
 			if (self->resetSnapshot) {
 				nextKey = Key();
@@ -801,16 +979,17 @@ private:
 			}
 
 			auto next = nextKeyAfter ? self->data.upper_bound(nextKey) : self->data.lower_bound(nextKey);
-			int diff = self->notifiedCommittedWriteBytes.get() - snapshotTotalWrittenBytes;
+			int diff = self->notifiedSnapshotBudgetBytes.get() - snapshotTotalWrittenBytes;
 			if (diff > lastDiff && diff > 5e7)
 				TraceEvent(SevWarnAlways, "ManyWritesAtOnce", self->id)
 				    .detail("CommittedWrites", self->notifiedCommittedWriteBytes.get())
+				    .detail("SnapshotBudget", self->notifiedSnapshotBudgetBytes.get())
 				    .detail("SnapshotWrites", snapshotTotalWrittenBytes)
 				    .detail("Diff", diff)
 				    .detail("LastOperationWasASnapshot", nextKey == Key() && !nextKeyAfter);
 			lastDiff = diff;
 
-			// Since notifiedCommittedWriteBytes is only set() once per commit, before logging the commit operation,
+			// Since notifiedSnapshotBudgetBytes is only set() once per commit, before logging the commit operation,
 			// when this line is reached it is certain that there are no snapshot items in this commit yet.  Since this
 			// commit could be the first thing read during recovery, we can't write a delta yet.
 			bool useDelta = false;
@@ -836,6 +1015,8 @@ private:
 					ASSERT(thisSnapshotEnd >= self->currentSnapshotEnd);
 					self->previousSnapshotEnd = self->currentSnapshotEnd;
 					self->currentSnapshotEnd = thisSnapshotEnd;
+					self->previousSnapshotEndBytes = self->currentSnapshotEndBytes;
+					self->currentSnapshotEndBytes = self->loggedBytes;
 
 					if (++self->snapshotCount == 2) {
 						self->replaceContent = false;
@@ -846,7 +1027,7 @@ private:
 					snapshotTotalWrittenBytes += OP_DISK_OVERHEAD;
 
 					// If we're not stopping now, reset next
-					if (snapshotTotalWrittenBytes < self->notifiedCommittedWriteBytes.get()) {
+					if (snapshotTotalWrittenBytes < self->notifiedSnapshotBudgetBytes.get()) {
 						next = self->data.begin();
 					} else {
 						// Otherwise, save state for continuing after the next wait and stop
@@ -913,7 +1094,7 @@ private:
 					lastSnapshotKeyUsingA = !lastSnapshotKeyUsingA;
 
 					// If we're not stopping now, increment next
-					if (snapshotTotalWrittenBytes < self->notifiedCommittedWriteBytes.get()) {
+					if (snapshotTotalWrittenBytes < self->notifiedSnapshotBudgetBytes.get()) {
 						++next;
 					} else {
 						// Otherwise, save state for continuing after the next wait and stop
@@ -978,9 +1159,12 @@ KeyValueStoreMemory<Container>::KeyValueStoreMemory(IDiskQueue* log,
                                                     bool disableSnapshot,
                                                     bool replaceContent,
                                                     bool exactRecovery,
-                                                    bool enableEncryption)
-  : type(storeType), id(id), log(log), db(db), committedWriteBytes(0), overheadWriteBytes(0), currentSnapshotEnd(-1),
-    previousSnapshotEnd(-1), committedDataSize(0), transactionSize(0), transactionIsLarge(false), resetSnapshot(false),
+                                                    bool enableEncryption,
+                                                    bool idleSnapshots)
+  : type(storeType), id(id), log(log), db(db), committedWriteBytes(0), overheadWriteBytes(0), snapshotBudgetBytes(0),
+    snapshotRate(1.0), commitWriteRate(SERVER_KNOBS->KVS_MEMORY_SNAPSHOT_RATE_SMOOTHING), loggedBytes(0),
+    currentSnapshotEndBytes(0), previousSnapshotEndBytes(0), currentSnapshotEnd(-1), previousSnapshotEnd(-1),
+    committedDataSize(0), transactionSize(0), transactionIsLarge(false), resetSnapshot(false),
     disableSnapshot(disableSnapshot), replaceContent(replaceContent), firstCommitWithSnapshot(true), snapshotCount(0),
     memoryLimit(memoryLimit), enableEncryption(enableEncryption) {
 	// create reserved buffer for radixtree store type
@@ -991,6 +1175,10 @@ KeyValueStoreMemory<Container>::KeyValueStoreMemory(IDiskQueue* log,
 
 	recovering = recover(this, exactRecovery);
 	snapshotting = snapshot(this);
+	snapshotMetricsLogger = logSnapshotMetrics(this);
+	if (idleSnapshots && !disableSnapshot) {
+		idleSnapshotter = snapshotWhileIdle(this);
+	}
 	commitActors = actorCollection(addActor.getFuture());
 	if (enableEncryption) {
 		refreshCipherKeysActor = refreshCipherKeys(this);
@@ -1010,11 +1198,27 @@ IKeyValueStore* keyValueStoreMemory(std::string const& basename,
 	// SOMEDAY: update to use DiskQueueVersion::V2 with xxhash3 checksum for FDB >= 7.2
 	IDiskQueue* log = openDiskQueue(basename, ext, logID, DiskQueueVersion::V1);
 	if (storeType == KeyValueStoreType::MEMORY_RADIXTREE) {
-		return new KeyValueStoreMemory<radix_tree>(
-		    log, Reference<AsyncVar<ServerDBInfo> const>(), logID, memoryLimit, storeType, false, false, false, false);
+		return new KeyValueStoreMemory<radix_tree>(log,
+		                                           Reference<AsyncVar<ServerDBInfo> const>(),
+		                                           logID,
+		                                           memoryLimit,
+		                                           storeType,
+		                                           false,
+		                                           false,
+		                                           false,
+		                                           false,
+		                                           /* idleSnapshots= */ true);
 	} else {
-		return new KeyValueStoreMemory<IKeyValueContainer>(
-		    log, Reference<AsyncVar<ServerDBInfo> const>(), logID, memoryLimit, storeType, false, false, false, false);
+		return new KeyValueStoreMemory<IKeyValueContainer>(log,
+		                                                   Reference<AsyncVar<ServerDBInfo> const>(),
+		                                                   logID,
+		                                                   memoryLimit,
+		                                                   storeType,
+		                                                   false,
+		                                                   false,
+		                                                   false,
+		                                                   false,
+		                                                   /* idleSnapshots= */ true);
 	}
 }
 
@@ -1036,5 +1240,50 @@ IKeyValueStore* keyValueStoreLogSystem(class IDiskQueue* queue,
 	                                                   disableSnapshot,
 	                                                   replaceContent,
 	                                                   exactRecovery,
-	                                                   enableEncryption);
+	                                                   enableEncryption,
+	                                                   /* idleSnapshots= */ false);
+}
+
+TEST_CASE("noSim/fdbserver/KeyValueStoreMemory/RecoverUnsortedSets") {
+	state std::string basename = "kvsmemory-recovery-test-" + deterministicRandom()->randomUniqueID().toString() + "-";
+	state IKeyValueStore* kvStore = keyValueStoreMemory(basename, deterministicRandom()->randomUniqueID(), 500e6);
+	wait(kvStore->init());
+
+	// Sets out of key order, sets repeating a key within a commit, and clears interleaved with them
+	state std::map<Key, Value> expected;
+	state int i = 0;
+	for (i = 0; i < 20; i++) {
+		for (int j = 0; j < 50; j++) {
+			Key key = StringRef(format("key%04d", deterministicRandom()->randomInt(0, 200)));
+			Value value = StringRef(format("value%d-%d", i, j));
+			if (deterministicRandom()->random01() < 0.1) {
+				KeyRange range = KeyRangeRef(key, key.withSuffix("\xff"_sr));
+				kvStore->clear(range);
+				expected.erase(expected.lower_bound(range.begin), expected.lower_bound(range.end));
+			} else {
+				kvStore->set(KeyValueRef(key, value));
+				expected[key] = value;
+			}
+		}
+		wait(kvStore->commit(false));
+	}
+
+	state Future<Void> closed = kvStore->onClosed();
+	kvStore->close();
+	wait(closed);
+
+	kvStore = keyValueStoreMemory(basename, deterministicRandom()->randomUniqueID(), 500e6);
+	wait(kvStore->init());
+	RangeResult result = wait(kvStore->readRange(allKeys));
+	ASSERT(result.size() == expected.size());
+	auto it = expected.begin();
+	for (auto& kv : result) {
+		ASSERT(kv.key == it->first && kv.value == it->second);
+		++it;
+	}
+
+	closed = kvStore->onClosed();
+	kvStore->dispose();
+	wait(closed);
+	return Void();
 }
@@ -1627,6 +1627,7 @@ private:
 	volatile int64_t freeListPages;
 
 	std::vector<Reference<ReadCursor>> readCursors;
+	std::vector<int64_t> retainedZeroCopyPages; // Per reader; only written when readers run on the network thread
 	Reference<IAsyncFile> dbFile, walFile;
 
 	struct Reader : IThreadPoolReceiver {
@@ -1634,18 +1635,36 @@ private:
 		ThreadSafeCounter& counter;
 		UID dbgid;
 		Reference<ReadCursor>* ppReadCursor;
+		int64_t* pRetainedZeroCopyPages; // nullptr unless this reader retains zero-copy pages
 
 		explicit Reader(std::string const& filename,
 		                bool is_btree_v2,
 		                ThreadSafeCounter& counter,
 		                UID dbgid,
-		                Reference<ReadCursor>* ppReadCursor)
-		  : conn(filename, is_btree_v2, is_btree_v2), counter(counter), dbgid(dbgid), ppReadCursor(ppReadCursor) {}
-		~Reader() override { ppReadCursor->clear(); }
+		                Reference<ReadCursor>* ppReadCursor,
+		                int64_t* pRetainedZeroCopyPages)
+		  : conn(filename, is_btree_v2, is_btree_v2), counter(counter), dbgid(dbgid), ppReadCursor(ppReadCursor),
+		    pRetainedZeroCopyPages(pRetainedZeroCopyPages) {}
+		~Reader() override {
+			ppReadCursor->clear();
+			if (pRetainedZeroCopyPages)
+				*pRetainedZeroCopyPages = 0;
+		}
 
-		void init() override { conn.open(false); }
+		void init() override {
+			conn.open(false);
+			if (pRetainedZeroCopyPages) {
+				// Retained pages pin their AsyncFileCached pages outside its eviction, so bound how many this
+				// connection holds and report them through DiskMetrics
+				int cachePages = SERVER_KNOBS->SQLITE_READER_CACHE_PAGES;
+				Statement(conn, format("PRAGMA cache_size = %d", cachePages).c_str()).nextRow();
+				sqlite3_retain_zero_copy_pages(conn.db, cachePages);
+			}
+		}
 
 		Reference<ReadCursor> getCursor() {
+			if (pRetainedZeroCopyPages)
+				*pRetainedZeroCopyPages = sqlite3_retained_zero_copy_pages(conn.db);
 			Reference<ReadCursor> cursor = *ppReadCursor;
 			if (!cursor || cursor->get().kvBytesRead > SERVER_KNOBS->SQLITE_CURSOR_MAX_LIFETIME_BYTES) {
 				*ppReadCursor = cursor = makeReference<ReadCursor>();
@@ -1999,12 +2018,16 @@ private:
 			wait(delay(FLOW_KNOBS->DISK_METRIC_LOGGING_INTERVAL));
 
 			int64_t rc = self->readsComplete, wc = self->writesComplete;
+			int64_t retainedPages = 0;
+			for (int64_t pages : self->retainedZeroCopyPages)
+				retainedPages += pages;
 			TraceEvent("DiskMetrics", self->logID)
 			    .detail("ReadOps", rc - lastReadsComplete)
 			    .detail("WriteOps", wc - lastWritesComplete)
 			    .detail("ReadQueue", self->readsRequested - rc)
 			    .detail("WriteQueue", self->writesRequested - wc)
-			    .detail("GlobalSQLiteMemoryHighWater", (int64_t)sqlite3_memory_highwater(1));
+			    .detail("GlobalSQLiteMemoryHighWater", (int64_t)sqlite3_memory_highwater(1))
+			    .detail("RetainedZeroCopyPages", retainedPages);
 
 			TraceEvent("SpringCleaningMetrics", self->logID)
 			    .detail("SpringCleaningCount", self->springCleaningStats.springCleaningCount)
@@ -2145,6 +2168,7 @@ KeyValueStoreSQLite::KeyValueStoreSQLite(std::string const& filename,
 	ASSERT(!vfsAsyncIsOpen(filename + "-wal"));
 
 	readCursors.resize(SERVER_KNOBS->SQLITE_READER_THREADS); //< number of read threads
+	retainedZeroCopyPages.resize(readCursors.size());
 
 	sqlite3_soft_heap_limit64(SERVER_KNOBS->SOFT_HEAP_LIMIT); // SOMEDAY: Is this a performance issue?  Should we drop
 	                                                          // the cache sizes for individual threads?
@@ -2186,6 +2210,11 @@ StorageBytes KeyValueStoreSQLite::getStorageBytes() const {
 
 void KeyValueStoreSQLite::startReadThreads() {
 	int nReadThreads = readCursors.size();
+	// Reader connections share raw pages through AsyncFileCached already; retaining them also keeps each reader's
+	// decoded btree pages across cursor resets.  Pages can be recycled by any connection's page cache, so this is
+	// only safe when all connections run on the network thread.
+	bool retain =
+	    SERVER_KNOBS->SQLITE_READER_RETAIN_ZERO_COPY_PAGES && writeThread->isCoro() && readThreads->isCoro();
 	TaskPriority taskId = g_network->getCurrentTask();
 	g_network->setCurrentTask(TaskPriority::DiskRead);
 	for (int i = 0; i < nReadThreads; i++) {
@@ -2194,9 +2223,13 @@ void KeyValueStoreSQLite::startReadThreads() {
 			threadName = "fdb-sqlite-r";
 		}
 		//  Note: the below is actually a coroutine and not a thread.
-		readThreads->addThread(
-		    new Reader(filename, type == KeyValueStoreType::SSD_BTREE_V2, readsComplete, logID, &readCursors[i]),
-		    threadName.c_str());
+		readThreads->addThread(new Reader(filename,
+		                                  type == KeyValueStoreType::SSD_BTREE_V2,
+		                                  readsComplete,
+		                                  logID,
+		                                  &readCursors[i],
+		                                  retain ? &retainedZeroCopyPages[i] : nullptr),
+		                       threadName.c_str());
 	}
 	g_network->setCurrentTask(taskId);
 }
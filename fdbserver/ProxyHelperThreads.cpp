@@ -0,0 +1,101 @@
+/*
+ * ProxyHelperThreads.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/ProxyHelperThreads.h"
+
+#include "fdbserver/Knobs.h"
+#include "flow/ThreadPrimitives.h"
+
+namespace {
+
+struct HelperThread final : IThreadPoolReceiver {
+	void init() override {}
+
+	struct Part final : TypedAction<HelperThread, Part> {
+		std::function<void(int, int)> const* f;
+		int begin, end;
+		Optional<Error>* error;
+		Event* done;
+
+		Part(std::function<void(int, int)> const* f, int begin, int end, Optional<Error>* error, Event* done)
+		  : f(f), begin(begin), end(end), error(error), done(done) {}
+
+		double getTimeEstimate() const override { return 0; }
+	};
+
+	void action(Part& part) {
+		try {
+			(*part.f)(part.begin, part.end);
+		} catch (Error& e) {
+			*part.error = e;
+		} catch (...) {
+			*part.error = unknown_error();
+		}
+		part.done->set();
+	}
+};
+
+} // namespace
+
+ProxyHelperThreads::ProxyHelperThreads(int threads) : threads(threads) {
+	if (threads > 0 && !g_network->isSimulated()) {
+		pool = createGenericThreadPool();
+		for (int i = 0; i < threads; i++) {
+			pool->addThread(new HelperThread(), "fdb-proxy-help");
+		}
+	}
+}
+
+bool ProxyHelperThreads::shouldSplit(int count) const {
+	return threads > 0 && count >= SERVER_KNOBS->COMMIT_PROXY_HELPER_THREAD_MIN_ITEMS;
+}
+
+void ProxyHelperThreads::parallelFor(int count, std::function<void(int, int)> const& f) {
+	int parts = std::max(1, std::min(threads + 1, count));
+	if (!pool) {
+		for (int i = 0; i < parts; i++) {
+			f(int64_t(count) * i / parts, int64_t(count) * (i + 1) / parts);
+		}
+		return;
+	}
+
+	// The other parts reference f, errors and done, so they must finish before this returns or throws
+	Event done;
+	std::vector<Optional<Error>> errors(parts);
+	for (int i = 1; i < parts; i++) {
+		pool->post(new HelperThread::Part(
+		    &f, int64_t(count) * i / parts, int64_t(count) * (i + 1) / parts, &errors[i], &done));
+	}
+	try {
+		f(0, count / parts);
+	} catch (Error& e) {
+		errors[0] = e;
+	} catch (...) {
+		errors[0] = unknown_error();
+	}
+	for (int i = 1; i < parts; i++) {
+		done.block();
+	}
+	for (auto const& error : errors) {
+		if (error.present()) {
+			throw error.get();
+		}
+	}
+}
@@ -25,6 +25,7 @@
 #include "fdbserver/WaitFailure.h"
 #include "fdbserver/QuietDatabase.h"
 #include "flow/OwningResource.h"
+#include "flow/UnitTest.h"
 
 #include "flow/actorcompiler.h" // must be last include
 
@@ -630,6 +631,11 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 
 	std::map<UID, limitReason_t> ssReasons;
 
+	// With predictive control, queue limits come from the growth model of each queue instead of from how far into
+	// its spring the queue is. The model of the limiting queue is reported with the limit.
+	bool predictiveControl = SERVER_KNOBS->RATEKEEPER_PREDICTIVE_CONTROL;
+	std::map<UID, QueueGrowthModel> queueModels;
+
 	bool printRateKeepLimitReasonDetails =
 	    SERVER_KNOBS->RATEKEEPER_PRINT_LIMIT_REASON &&
 	    (deterministicRandom()->random01() < SERVER_KNOBS->RATEKEEPER_LIMIT_REASON_SAMPLE_RATE);
@@ -723,11 +729,18 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 		if (ssLimitReason == limitReason_t::unlimited)
 			ssLimitReason = limitReason_t::storage_server_write_bandwidth_mvcc;
 
-		if (targetRateRatio > 0 && inputRate > 0) {
+		if ((targetRateRatio > 0 || predictiveControl) && inputRate > 0) {
 			ASSERT(inputRate != 0);
 			double smoothedRate =
 			    std::max(ss.verySmoothDurableBytes.smoothRate(), actualTps / SERVER_KNOBS->MAX_TRANSACTIONS_PER_BYTE);
-			double x = smoothedRate / (inputRate * targetRateRatio);
+			double x;
+			if (predictiveControl) {
+				QueueGrowthModel model(storageQueue, targetBytes, inputRate, smoothedRate);
+				x = model.allowedInputRatio(SERVER_KNOBS->RATEKEEPER_PREDICTION_HORIZON);
+				queueModels[ss.id] = model;
+			} else {
+				x = smoothedRate / (inputRate * targetRateRatio);
+			}
 			double lim = actualTps * x;
 			if (lim < limitTps) {
 				double oldLimitTps = limitTps;
@@ -1086,7 +1099,20 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 
 		double inputRate = tl.smoothInputBytes.smoothRate();
 
-		if (targetRateRatio > 0) {
+		// The growth model only describes the queue, so a tlog limited by lagging storage servers keeps the spring
+		bool predictTLog = predictiveControl && tlogLimitReason != limitReason_t::storage_server_readable_behind;
+		if (predictTLog && inputRate > 0) {
+			double smoothedRate =
+			    std::max(tl.verySmoothDurableBytes.smoothRate(), actualTps / SERVER_KNOBS->MAX_TRANSACTIONS_PER_BYTE);
+			QueueGrowthModel model(queue, targetBytes, inputRate, smoothedRate);
+			queueModels[tl.id] = model;
+			double lim = actualTps * model.allowedInputRatio(SERVER_KNOBS->RATEKEEPER_PREDICTION_HORIZON);
+			if (lim < limits->tpsLimit) {
+				limits->tpsLimit = lim;
+				reasonID = tl.id;
+				limitReason = tlogLimitReason;
+			}
+		} else if (!predictTLog && targetRateRatio > 0) {
 			double smoothedRate =
 			    std::max(tl.verySmoothDurableBytes.smoothRate(), actualTps / SERVER_KNOBS->MAX_TRANSACTIONS_PER_BYTE);
 			double x = smoothedRate / (inputRate * targetRateRatio);
@@ -1171,8 +1197,8 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 
 	if (deterministicRandom()->random01() < 0.1) {
 		const std::string& name = limits->rkUpdateEventCacheHolder.getPtr()->trackingKey;
-		TraceEvent(name.c_str(), id)
-		    .detail("TPSLimit", limits->tpsLimit)
+		TraceEvent ev(name.c_str(), id);
+		ev.detail("TPSLimit", limits->tpsLimit)
 		    .detail("Reason", limitReason)
 		    .detail("ReasonServerID", reasonID == UID() ? std::string() : Traceable<UID>::toString(reasonID))
 		    .detail("ReleasedTPS", smoothReleasedTransactions.smoothRate())
@@ -1195,8 +1221,24 @@ void Ratekeeper::updateRate(RatekeeperLimits* limits) {
 		    .detail("TagsAutoThrottledBusyRead", tagThrottler->busyReadTagCount())
 		    .detail("TagsAutoThrottledBusyWrite", tagThrottler->busyWriteTagCount())
 		    .detail("TagsManuallyThrottled", tagThrottler->manualThrottleCount())
-		    .detail("AutoThrottlingEnabled", tagThrottler->isAutoThrottlingEnabled())
-		    .trackLatest(name);
+		    .detail("AutoThrottlingEnabled", tagThrottler->isAutoThrottlingEnabled());
+
+		// Explain a queue limit by the growth model of the limiting queue
+		auto model = queueModels.find(reasonID);
+		if (model != queueModels.end() &&
+		    (limitReason == limitReason_t::storage_server_write_queue_size ||
+		     limitReason == limitReason_t::log_server_write_queue ||
+		     limitReason == limitReason_t::storage_server_min_free_space ||
+		     limitReason == limitReason_t::storage_server_min_free_space_ratio ||
+		     limitReason == limitReason_t::log_server_min_free_space ||
+		     limitReason == limitReason_t::log_server_min_free_space_ratio)) {
+			ev.detail("LimitingQueueBytes", model->second.queue)
+			    .detail("LimitingQueueTargetBytes", model->second.targetBytes)
+			    .detail("LimitingInputRate", model->second.inputRate)
+			    .detail("LimitingDurableRate", model->second.durableRate)
+			    .detail("PredictedSecondsToLimit", std::min(model->second.secondsToLimit(), 1e6));
+		}
+		ev.trackLatest(name);
 	}
 }
 
@@ -1351,3 +1393,40 @@ RatekeeperLimits::RatekeeperLimits(TransactionPriority priority,
     lastDurabilityLag(0), durabilityLagLimit(std::numeric_limits<double>::infinity()), bwLagTarget(bwLagTarget),
     priority(priority), context(context),
     rkUpdateEventCacheHolder(makeReference<EventCacheHolder>("RkUpdate" + context)) {}
+
+double QueueGrowthModel::secondsToLimit() const {
+	if (queue >= targetBytes) {
+		return 0.0;
+	}
+	if (inputRate <= durableRate) {
+		return std::numeric_limits<double>::infinity();
+	}
+	return (targetBytes - queue) / (inputRate - durableRate);
+}
+
+double QueueGrowthModel::allowedInputRatio(double horizon) const {
+	// Let the queue grow by its remaining headroom over the horizon. As with the spring based limit, never ask for
+	// less than half of the durable rate, so that a queue far over its target does not stop all commits.
+	double allowedRate = std::max(durableRate + (targetBytes - queue) / std::max(horizon, 1e-3), durableRate / 2);
+	return allowedRate / std::max(1.0e-8, inputRate);
+}
+
+TEST_CASE("/fdbserver/Ratekeeper/QueueGrowthModel") {
+	// A queue that drains as fast as it fills never reaches its limit, and can take more input than it gets
+	QueueGrowthModel steady(100e6, 1000e6, 10e6, 10e6);
+	ASSERT(steady.secondsToLimit() == std::numeric_limits<double>::infinity());
+	ASSERT(steady.allowedInputRatio(10.0) > 1.0);
+
+	// 900MB of headroom filling at a net 90MB/s is used up in 10 seconds; a 20 second horizon halves that growth
+	QueueGrowthModel growing(100e6, 1000e6, 100e6, 10e6);
+	ASSERT(std::abs(growing.secondsToLimit() - 10.0) < 1e-9);
+	ASSERT(std::abs(growing.allowedInputRatio(20.0) * growing.inputRate - 55e6) < 1.0);
+
+	// A queue over its target is drained, but never limited below half of its durable rate
+	QueueGrowthModel full(1100e6, 1000e6, 10e6, 10e6);
+	ASSERT(full.secondsToLimit() == 0.0);
+	ASSERT(std::abs(full.allowedInputRatio(10.0) - 0.5) < 1e-9);
+	ASSERT(std::abs(full.allowedInputRatio(1000.0) - 0.99) < 1e-9);
+
+	return Void();
+}
@@ -0,0 +1,116 @@
+/*
+ * RecentWriteFilter.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "fdbserver/RecentWriteFilter.h"
+
+#include "flow/UnitTest.h"
+
+RecentWriteFilter::RecentWriteFilter(int slots) {
+	int size = 1;
+	while (size < slots) {
+		size *= 2;
+	}
+	this->slots.assign(size, invalidVersion);
+}
+
+Version& RecentWriteFilter::slot(KeyRef key) {
+	return slots[std::hash<StringRef>()(key) & (slots.size() - 1)];
+}
+
+void RecentWriteFilter::add(KeyRef key, Version version) {
+	auto it = latest.find(key);
+	if (it == latest.end()) {
+		it = latest.emplace(key, version).first;
+	} else if (it->second == version) {
+		return;
+	} else {
+		it->second = version;
+	}
+	// The versions of the entries of a key are increasing, so only its last entry matches its version in latest
+	byVersion.emplace_back(version, it->first);
+	Version& s = slot(key);
+	s = std::max(s, version);
+}
+
+void RecentWriteFilter::expire(Version version) {
+	oldest = std::max(oldest, version);
+	while (!byVersion.empty() && byVersion.front().first < oldest) {
+		auto it = latest.find(byVersion.front().second);
+		if (it->second == byVersion.front().first) {
+			latest.erase(it);
+		}
+		byVersion.pop_front();
+	}
+}
+
+bool RecentWriteFilter::writtenAfter(KeyRangeRef range, Version version) const {
+	version = std::max(version, oldest - 1);
+	if (range.singleKeyRange()) {
+		if (slot(range.begin) <= version) {
+			return false;
+		}
+		auto it = latest.find(range.begin);
+		return it != latest.end() && it->second > version;
+	}
+	int checked = 0;
+	for (auto it = latest.lower_bound(range.begin); it != latest.end() && it->first < range.end; ++it) {
+		if (it->second > version) {
+			return true;
+		}
+		if (++checked == 8) {
+			break;
+		}
+	}
+	return false;
+}
+
+TEST_CASE("/fdbserver/RecentWriteFilter/exact") {
+	RecentWriteFilter filter(deterministicRandom()->randomInt(1, 64));
+	// Version of the latest write of every key, and the version before which writes are expired
+	std::map<Key, Version> written;
+	Version expired = 0;
+	Version version = 0;
+	for (int i = 0; i < 10000; i++) {
+		Key key(format("%03d", deterministicRandom()->randomInt(0, 200)));
+		if (deterministicRandom()->random01() < 0.5) {
+			version += deterministicRandom()->randomInt(0, 3);
+			filter.add(key, version);
+			written[key] = version;
+		} else if (deterministicRandom()->random01() < 0.05) {
+			expired = std::max(expired, version - deterministicRandom()->randomInt(0, 50));
+			filter.expire(expired);
+		} else {
+			Version readVersion = version - deterministicRandom()->randomInt(0, 100);
+			auto it = written.find(key);
+			bool expected = it != written.end() && it->second > readVersion && it->second >= expired;
+			ASSERT_EQ(filter.writtenAfter(singleKeyRange(key), readVersion), expected);
+			Key end(format("%03d", deterministicRandom()->randomInt(0, 200)));
+			if (key < end && filter.writtenAfter(KeyRangeRef(key, end), readVersion)) {
+				bool found = false;
+				for (auto w = written.lower_bound(key); w != written.end() && w->first < end; ++w) {
+					found = found || (w->second > readVersion && w->second >= expired);
+				}
+				ASSERT(found);
+			}
+		}
+	}
+	return Void();
+}
@@ -20,10 +20,13 @@
 
 #include "fdbserver/ResolutionBalancer.actor.h"
 
+#include <numeric>
+
 #include "fdbclient/KeyRangeMap.h"
 #include "fdbserver/MasterInterface.h"
 #include "fdbserver/Knobs.h"
 #include "flow/flow.h"
+#include "flow/UnitTest.h"
 
 #include "flow/actorcompiler.h" // This must be the last #include.
 
@@ -45,6 +48,54 @@ void ResolutionBalancer::setChangesInReply(UID requestingProxy, GetCommitVersion
 	}
 }
 
+void ResolverLoadModel::update(const std::vector<ResolutionMetricsReply>& metrics, double now) {
+	if (metrics.size() != last.size() || now <= lastTime) {
+		last = metrics;
+		lastTime = now;
+		loads.clear();
+		return;
+	}
+
+	// CPU time is only compared when every resolver measures it, otherwise the conflict ranges checked stand in for it
+	bool cpu = std::all_of(metrics.begin(), metrics.end(), [](auto const& m) { return m.cpuSeconds > 0; });
+	if (cpu != cpuLoads) {
+		cpuLoads = cpu;
+		loads.clear();
+	}
+	double alpha = loads.empty() ? 1.0 : SERVER_KNOBS->RESOLUTION_BALANCE_LOAD_SMOOTHING;
+	loads.resize(metrics.size());
+	for (int i = 0; i < metrics.size(); i++) {
+		double used = cpu ? metrics[i].cpuSeconds - last[i].cpuSeconds
+		                  : double(metrics[i].conflictRanges - last[i].conflictRanges);
+		double load = std::max(used, 0.0) / (now - lastTime);
+		loads[i] = alpha * load + (1 - alpha) * loads[i];
+	}
+	last = metrics;
+	lastTime = now;
+}
+
+Optional<ResolverLoadModel::Move> ResolverLoadModel::planMove(
+    const std::vector<ResolutionMetricsReply>& metrics) const {
+	if (loads.size() < 2 || loads.size() != metrics.size()) {
+		return Optional<Move>();
+	}
+	int src = std::max_element(loads.begin(), loads.end()) - loads.begin();
+	int dest = std::min_element(loads.begin(), loads.end()) - loads.begin();
+	double mean = std::accumulate(loads.begin(), loads.end(), 0.0) / loads.size();
+	if (mean <= 0 || loads[src] - loads[dest] < SERVER_KNOBS->RESOLUTION_BALANCE_MIN_IMBALANCE * mean) {
+		return Optional<Move>();
+	}
+
+	// Moving half of the excess load at a time converges without overshooting, since the key sample only approximates
+	// where the load is
+	double share = std::min(loads[src] - mean, mean - loads[dest]) / loads[src] / 2;
+	int64_t amount = share * metrics[src].value;
+	if (amount <= 0) {
+		return Optional<Move>();
+	}
+	return Move{ src, dest, amount };
+}
+
 static std::pair<KeyRangeRef, bool> findRange(CoalescedKeyRangeMap<int>& key_resolver,
                                               Standalone<VectorRef<ResolverMoveRef>>& movedRanges,
                                               int src,
@@ -127,21 +178,35 @@ ACTOR Future<Void> ResolutionBalancer::resolutionBalancing_impl(ResolutionBalanc
 			futures.push_back(
 			    brokenPromiseToNever(p.metrics.getReply(ResolutionMetricsRequest(), TaskPriority::ResolutionMetrics)));
 		wait(waitForAll(futures));
-		state IndexedSet<std::pair<int64_t, int>, NoMetric> metrics;
+		state Optional<ResolverLoadModel::Move> move;
 
-		int64_t total = 0;
-		for (int i = 0; i < futures.size(); i++) {
-			total += futures[i].get().value;
-			metrics.insert(std::make_pair(futures[i].get().value, i), NoMetric());
-			//TraceEvent("ResolverMetric").detail("I", i).detail("Metric", futures[i].get());
+		if (SERVER_KNOBS->RESOLUTION_BALANCE_USE_LOAD_MODEL) {
+			std::vector<ResolutionMetricsReply> replies;
+			for (auto& f : futures)
+				replies.push_back(f.get());
+			self->loadModel.update(replies, now());
+			move = self->loadModel.planMove(replies);
+		} else {
+			IndexedSet<std::pair<int64_t, int>, NoMetric> metrics;
+			int64_t total = 0;
+			for (int i = 0; i < futures.size(); i++) {
+				total += futures[i].get().value;
+				metrics.insert(std::make_pair(futures[i].get().value, i), NoMetric());
+				//TraceEvent("ResolverMetric").detail("I", i).detail("Metric", futures[i].get());
+			}
+			if (metrics.lastItem()->first - metrics.begin()->first > SERVER_KNOBS->MIN_BALANCE_DIFFERENCE) {
+				move = ResolverLoadModel::Move{ metrics.lastItem()->second,
+					                            metrics.begin()->second,
+					                            std::min(metrics.lastItem()->first - total / self->resolvers.size(),
+					                                     total / self->resolvers.size() - metrics.begin()->first) /
+					                                2 };
+			}
 		}
-		if (metrics.lastItem()->first - metrics.begin()->first > SERVER_KNOBS->MIN_BALANCE_DIFFERENCE) {
+		if (move.present()) {
 			try {
-				state int src = metrics.lastItem()->second;
-				state int dest = metrics.begin()->second;
-				state int64_t amount = std::min(metrics.lastItem()->first - total / self->resolvers.size(),
-				                                total / self->resolvers.size() - metrics.begin()->first) /
-				                       2;
+				state int src = move.get().src;
+				state int dest = move.get().dest;
+				state int64_t amount = move.get().amount;
 				state Standalone<VectorRef<ResolverMoveRef>> movedRanges;
 
 				loop {
@@ -153,8 +218,8 @@ ACTOR Future<Void> ResolutionBalancer::resolutionBalancing_impl(ResolutionBalanc
 					req.range = range.first;
 
 					ResolutionSplitReply split =
-					    wait(brokenPromiseToNever(self->resolvers[metrics.lastItem()->second].split.getReply(
-					        req, TaskPriority::ResolutionMetrics)));
+					    wait(brokenPromiseToNever(self->resolvers[src].split.getReply(req,
+					                                                                  TaskPriority::ResolutionMetrics)));
 					KeyRangeRef moveRange = range.second ? KeyRangeRef(range.first.begin, split.key)
 					                                     : KeyRangeRef(split.key, range.first.end);
 					movedRanges.push_back_deep(movedRanges.arena(), ResolverMoveRef(moveRange, dest));
@@ -165,7 +230,9 @@ ACTOR Future<Void> ResolutionBalancer::resolutionBalancing_impl(ResolutionBalanc
 					    .detail("StartRange", range.first)
 					    .detail("MoveRange", moveRange)
 					    .detail("Used", split.used)
-					    .detail("KeyResolverRanges", key_resolver.size());
+					    .detail("KeyResolverRanges", key_resolver.size())
+					    .detail("SrcLoad", self->loadModel.loads.empty() ? 0.0 : self->loadModel.loads[src])
+					    .detail("DestLoad", self->loadModel.loads.empty() ? 0.0 : self->loadModel.loads[dest]);
 					amount -= split.used;
 					if (moveRange != range.first || amount <= 0)
 						break;
@@ -179,6 +246,8 @@ ACTOR Future<Void> ResolutionBalancer::resolutionBalancing_impl(ResolutionBalanc
 				for (auto& p : self->commitProxies)
 					self->resolverNeedingChanges.insert(p.id());
 				self->resolverChanges.set(movedRanges);
+				// The loads measured so far predate the move
+				self->loadModel.reset();
 			} catch (Error& e) {
 				if (e.code() != error_code_operation_failed)
 					throw;
@@ -186,3 +255,38 @@ ACTOR Future<Void> ResolutionBalancer::resolutionBalancing_impl(ResolutionBalanc
 		}
 	}
 }
+
+TEST_CASE("/fdbserver/ResolutionBalancer/loadModel") {
+	ResolverLoadModel model;
+	std::vector<ResolutionMetricsReply> metrics(3);
+	for (auto& m : metrics) {
+		m.value = 1000;
+	}
+	model.update(metrics, 1.0);
+	ASSERT(!model.planMove(metrics).present());
+
+	metrics[0].conflictRanges = 100;
+	metrics[1].conflictRanges = 100;
+	metrics[2].conflictRanges = 400;
+	model.update(metrics, 2.0);
+	Optional<ResolverLoadModel::Move> move = model.planMove(metrics);
+	ASSERT(move.present() && move.get().src == 2 && move.get().dest == 0);
+	// mean is 200, so a quarter of the source's load is in excess, and half of that is moved
+	ASSERT(move.get().amount == 125);
+
+	// The same rate measured by CPU time is balanced, and replaces the conflict range estimates
+	for (auto& m : metrics) {
+		m.cpuSeconds = 1.0;
+	}
+	model.update(metrics, 3.0);
+	ASSERT(!model.planMove(metrics).present());
+	for (auto& m : metrics) {
+		m.cpuSeconds = 2.0;
+	}
+	model.update(metrics, 4.0);
+	ASSERT(!model.planMove(metrics).present());
+
+	model.reset();
+	ASSERT(model.loads.empty() && !model.planMove(metrics).present());
+	return Void();
+}
@@ -168,6 +168,7 @@ struct Resolver : ReferenceCounted<Resolver> {
 	Counter metricsRequests;
 	Counter splitRequests;
 	int numLogs;
+	double conflictDetectionSeconds = 0; // CPU time spent detecting conflicts, not measured in simulation
 
 	Future<Void> logger;
 
@@ -277,6 +278,7 @@ ACTOR Future<Void> resolveBatch(Reference<Resolver> self,
 
 		// Detect conflicts
 		double expire = now() + SERVER_KNOBS->SAMPLE_EXPIRATION_TIME;
+		double cpuStart = g_network->isSimulated() ? 0 : getProcessorTimeThread();
 		ConflictBatch conflictBatch(self->conflictSet, &reply.conflictingKeyRangeMap, &reply.arena);
 		for (int t = 0; t < req.transactions.size(); t++) {
 			conflictBatch.addTransaction(req.transactions[t]);
@@ -294,6 +296,9 @@ ACTOR Future<Void> resolveBatch(Reference<Resolver> self,
 		}
 		conflictBatch.detectConflicts(
 		    req.version, req.version - SERVER_KNOBS->MAX_WRITE_TRANSACTION_LIFE_VERSIONS, commitList, &tooOldList);
+		if (!g_network->isSimulated()) {
+			self->conflictDetectionSeconds += getProcessorTimeThread() - cpuStart;
+		}
 
 		reply.debugID = req.debugID;
 		reply.committed.resize(reply.arena, req.transactions.size());
@@ -605,6 +610,12 @@ ACTOR Future<Void> processTransactionStateRequestPart(TransactionStateResolveCon
 	}
 	pContext->receivedSequences.insert(request.sequence);
 
+	// Lets the rest of the broadcast tree apply the part concurrently
+	state Promise<Void> applied;
+	if (SERVER_KNOBS->TXN_STATE_PIPELINED_BROADCAST) {
+		pContext->pActors->send(forwardTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, applied.getFuture()));
+	}
+
 	// ASSERT(!pContext->pResolverData->validState.isSet());
 
 	for (auto& kv : request.data) {
@@ -619,7 +630,11 @@ ACTOR Future<Void> processTransactionStateRequestPart(TransactionStateResolveCon
 		pContext->processed = true;
 	}
 
-	pContext->pActors->send(broadcastTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, true));
+	if (SERVER_KNOBS->TXN_STATE_PIPELINED_BROADCAST) {
+		applied.send(Void());
+	} else {
+		pContext->pActors->send(broadcastTxnRequest(request, SERVER_KNOBS->TXN_STATE_SEND_AMOUNT, true));
+	}
 	wait(yield());
 	return Void();
 }
@@ -682,8 +697,12 @@ ACTOR Future<Void> resolverCore(ResolverInterface resolver,
 		}
 		when(ResolutionMetricsRequest req = waitNext(resolver.metrics.getFuture())) {
 			++self->metricsRequests;
-			req.reply.send(self->iopsSample.getEstimate(SERVER_KNOBS->PROXY_USE_RESOLVER_PRIVATE_MUTATIONS ? normalKeys
-			                                                                                               : allKeys));
+			ResolutionMetricsReply rep(self->iopsSample.getEstimate(
+			    SERVER_KNOBS->PROXY_USE_RESOLVER_PRIVATE_MUTATIONS ? normalKeys : allKeys));
+			rep.cpuSeconds = self->conflictDetectionSeconds;
+			rep.conflictRanges =
+			    self->resolvedReadConflictRanges.getValue() + self->resolvedWriteConflictRanges.getValue();
+			req.reply.send(rep);
 		}
 		when(ResolutionSplitRequest req = waitNext(resolver.split.getFuture())) {
 			++self->splitRequests;
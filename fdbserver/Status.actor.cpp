@@ -717,6 +717,44 @@ struct RolesInfo {
 	}
 };
 
+// Builds the request rate and latencies of the busiest request types of a process from its EndpointLatencyMetrics event
+static JsonBuilderObject endpointLatenciesStatus(TraceEventFields const& event) {
+	JsonBuilderObject endpointsObj;
+	double elapsed = 0;
+	std::string value;
+	if (!event.tryGetValue("Elapsed", value) || (elapsed = atof(value.c_str())) <= 0) {
+		return endpointsObj;
+	}
+	for (int i = 0;; i++) {
+		std::string prefix = format("Endpoint%d", i);
+		std::string typeName;
+		if (!event.tryGetValue(prefix, typeName)) {
+			break;
+		}
+		JsonBuilderObject endpointObj;
+		JsonBuilderObject requestsObj;
+		if (event.tryGetValue(prefix + "Requests", value)) {
+			requestsObj["hz"] = atof(value.c_str()) / elapsed;
+		}
+		endpointObj["requests"] = requestsObj;
+		if (event.tryGetValue(prefix + "Errors", value)) {
+			JsonBuilderObject errorsObj;
+			errorsObj["hz"] = atof(value.c_str()) / elapsed;
+			endpointObj["errors"] = errorsObj;
+		}
+		for (auto const& [field, key] : { std::make_pair("QueueP99", "queue_p99_seconds"),
+		                                  std::make_pair("ServiceMedian", "service_median_seconds"),
+		                                  std::make_pair("ServiceP99", "service_p99_seconds"),
+		                                  std::make_pair("ServiceMax", "service_max_seconds") }) {
+			if (event.tryGetValue(prefix + field, value)) {
+				endpointObj.setKeyRawNumber(key, value);
+			}
+		}
+		endpointsObj[typeName] = endpointObj;
+	}
+	return endpointsObj;
+}
+
 ACTOR static Future<JsonBuilderObject> processStatusFetcher(
     Reference<AsyncVar<ServerDBInfo>> db,
     std::vector<WorkerDetails> workers,
@@ -726,6 +764,7 @@ ACTOR static Future<JsonBuilderObject> processStatusFetcher(
     WorkerEvents errors,
     WorkerEvents traceFileOpenErrors,
     WorkerEvents programStarts,
+    WorkerEvents endpointLatencies,
     std::map<std::string, std::vector<JsonBuilderObject>> processIssues,
     std::vector<StorageServerStatusInfo> storageServers,
     std::vector<std::pair<TLogInterface, EventMap>> tLogs,
@@ -1055,6 +1094,10 @@ ACTOR static Future<JsonBuilderObject> processStatusFetcher(
 				statusObj["degraded"] = true;
 			}
 
+			if (endpointLatencies.count(address) && endpointLatencies[address].size()) {
+				statusObj["endpoint_latencies"] = endpointLatenciesStatus(endpointLatencies[address]);
+			}
+
 			const TraceEventFields& networkMetrics = nMetrics[workerItr->interf.address()];
 			double networkMetricsElapsed = networkMetrics.getDouble("Elapsed");
 
@@ -2055,6 +2098,15 @@ JsonBuilderObject getPerfLimit(TraceEventFields const& ratekeeper, double transP
 			std::string reason_server_id = ratekeeper.getValue("ReasonServerID");
 			if (!reason_server_id.empty())
 				perfLimit["reason_server_id"] = reason_server_id;
+			// Present when ratekeeper predicts how soon the limiting queue will fill
+			std::string secondsToLimit;
+			if (ratekeeper.tryGetValue("PredictedSecondsToLimit", secondsToLimit)) {
+				perfLimit["predicted_seconds_to_limit"] = ratekeeper.getDouble("PredictedSecondsToLimit");
+				perfLimit["queue_bytes"] = ratekeeper.getInt64("LimitingQueueBytes");
+				perfLimit["queue_target_bytes"] = ratekeeper.getInt64("LimitingQueueTargetBytes");
+				perfLimit["input_bytes_per_second"] = ratekeeper.getDouble("LimitingInputRate");
+				perfLimit["durable_bytes_per_second"] = ratekeeper.getDouble("LimitingDurableRate");
+			}
 		}
 	} else {
 		perfLimit = JsonString::makeMessage("workload", "The database is not being saturated by the workload.");
@@ -2984,6 +3036,7 @@ ACTOR Future<StatusReply> clusterGetStatus(
 		futures.push_back(latestErrorOnWorkers(workers)); // Get all latest errors.
 		futures.push_back(latestEventOnWorkers(workers, "TraceFileOpenError"));
 		futures.push_back(latestEventOnWorkers(workers, "ProgramStart"));
+		futures.push_back(latestEventOnWorkers(workers, "EndpointLatencyMetrics"));
 
 		// Wait for all response pairs.
 		state std::vector<Optional<std::pair<WorkerEvents, std::set<std::string>>>> workerEventsVec =
@@ -3031,6 +3084,8 @@ ACTOR Future<StatusReply> clusterGetStatus(
 		    workerEventsVec[4].present() ? workerEventsVec[4].get().first : WorkerEvents();
 		state WorkerEvents programStarts =
 		    workerEventsVec[5].present() ? workerEventsVec[5].get().first : WorkerEvents();
+		state WorkerEvents endpointLatencies =
+		    workerEventsVec[6].present() ? workerEventsVec[6].get().first : WorkerEvents();
 
 		state JsonBuilderObject statusObj;
 		if (db->get().recoveryCount > 0) {
@@ -3318,6 +3373,7 @@ ACTOR Future<StatusReply> clusterGetStatus(
 		                              latestError,
 		                              traceFileOpenErrors,
 		                              programStarts,
+		                              endpointLatencies,
 		                              processIssues,
 		                              storageServers,
 		                              tLogs,
@@ -0,0 +1,156 @@
+/*
+ * StorageServerReadCache.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbserver/StorageServerReadCache.h"
+#include "flow/UnitTest.h"
+
+// Approximate per-entry memory overhead of the map node, list hook and arenas
+static constexpr int64_t ENTRY_OVERHEAD_BYTES = 128;
+
+StorageServerReadCache::StorageServerReadCache(int64_t capacityBytes)
+  : capacityBytes(capacityBytes), bytes(0), evictions(0) {}
+
+StorageServerReadCache::~StorageServerReadCache() {
+	clear();
+}
+
+void StorageServerReadCache::erase(EntryMapT::iterator it) {
+	bytes -= it->second.bytes;
+	evictionOrder.erase(evictionOrder.iterator_to(it->second));
+	entries.erase(it);
+}
+
+Optional<Optional<Value>> StorageServerReadCache::get(KeyRef key, Version version) {
+	auto it = entries.find(key);
+	if (it == entries.end() || version < it->second.validFrom) {
+		return Optional<Optional<Value>>();
+	}
+	// Move to the most recently used end
+	evictionOrder.erase(evictionOrder.iterator_to(it->second));
+	evictionOrder.push_back(it->second);
+	return it->second.value;
+}
+
+void StorageServerReadCache::insert(KeyRef key, Optional<Value> const& value, Version validFrom) {
+	if (!enabled()) {
+		return;
+	}
+	int64_t entryBytes = key.size() + value.expectedSize() + ENTRY_OVERHEAD_BYTES;
+	if (entryBytes > capacityBytes) {
+		return;
+	}
+
+	auto it = entries.find(key);
+	if (it != entries.end()) {
+		erase(it);
+	}
+
+	while (bytes + entryBytes > capacityBytes) {
+		ASSERT(!evictionOrder.empty());
+		erase(entries.find(evictionOrder.front().key));
+		++evictions;
+	}
+
+	it = entries.emplace(Key(key), Entry()).first;
+	Entry& e = it->second;
+	e.key = it->first;
+	e.value = value;
+	e.validFrom = validFrom;
+	e.bytes = entryBytes;
+	evictionOrder.push_back(e);
+	bytes += entryBytes;
+}
+
+void StorageServerReadCache::invalidate(KeyRef key) {
+	auto it = entries.find(key);
+	if (it != entries.end()) {
+		erase(it);
+	}
+}
+
+void StorageServerReadCache::invalidate(KeyRangeRef range) {
+	auto it = entries.lower_bound(range.begin);
+	while (it != entries.end() && it->first < range.end) {
+		erase(it++);
+	}
+}
+
+void StorageServerReadCache::clear() {
+	evictionOrder.clear();
+	entries.clear();
+	bytes = 0;
+}
+
+TEST_CASE("/fdbserver/StorageServerReadCache/Basic") {
+	StorageServerReadCache cache(1 << 20);
+
+	ASSERT(!cache.get("a"_sr, 10).present());
+	cache.insert("a"_sr, "1"_sr, 10);
+	cache.insert("b"_sr, Optional<Value>(), 10);
+
+	ASSERT(cache.get("a"_sr, 10).get() == Optional<Value>("1"_sr));
+	ASSERT(!cache.get("a"_sr, 9).present());
+	ASSERT(cache.get("b"_sr, 11).present() && !cache.get("b"_sr, 11).get().present());
+
+	cache.invalidate("a"_sr);
+	ASSERT(!cache.get("a"_sr, 10).present());
+	ASSERT(cache.getEntries() == 1);
+
+	cache.insert("c"_sr, "3"_sr, 10);
+	cache.insert("d"_sr, "4"_sr, 10);
+	cache.invalidate(KeyRangeRef("b"_sr, "d"_sr));
+	ASSERT(!cache.get("b"_sr, 10).present());
+	ASSERT(!cache.get("c"_sr, 10).present());
+	ASSERT(cache.get("d"_sr, 10).present());
+
+	cache.clear();
+	ASSERT(cache.getEntries() == 0 && cache.getBytes() == 0);
+
+	return Void();
+}
+
+TEST_CASE("/fdbserver/StorageServerReadCache/Eviction") {
+	int64_t entryBytes = 1 + 10 + ENTRY_OVERHEAD_BYTES;
+	StorageServerReadCache cache(entryBytes * 3);
+	Value value = makeString(10);
+
+	cache.insert("a"_sr, value, 0);
+	cache.insert("b"_sr, value, 0);
+	cache.insert("c"_sr, value, 0);
+	ASSERT(cache.getBytes() == entryBytes * 3);
+
+	// "a" becomes the most recently used, so inserting "d" evicts "b"
+	ASSERT(cache.get("a"_sr, 0).present());
+	cache.insert("d"_sr, value, 0);
+	ASSERT(cache.getEntries() == 3 && cache.getEvictions() == 1);
+	ASSERT(!cache.get("b"_sr, 0).present());
+	ASSERT(cache.get("a"_sr, 0).present());
+
+	// Replacing an entry does not evict anything
+	cache.insert("c"_sr, value, 5);
+	ASSERT(cache.getEntries() == 3 && cache.getEvictions() == 1);
+	ASSERT(!cache.get("c"_sr, 0).present());
+
+	// Entries larger than the cache are not inserted
+	cache.insert("e"_sr, makeString(entryBytes * 3), 0);
+	ASSERT(!cache.get("e"_sr, 0).present() && cache.getEntries() == 3);
+
+	return Void();
+}
@@ -22,6 +22,7 @@
 
 #include <set>
 #include <sstream>
+#include <unordered_map>
 #include "fdbclient/FDBOptions.g.h"
 #include "fdbclient/FDBTypes.h"
 #include "fdbclient/KeyBackedTypes.h"
@@ -167,6 +168,60 @@ public:
 };
 typedef AsyncMap<UID, ServerStatus> ServerStatusMap;
 
+// Buckets servers or machines by the number of teams they are on, so that team building can find the least used ones,
+// and tell whether any of them is on too few teams, without scanning all of them for every team it adds.
+template <class T>
+class TeamCountIndex {
+	std::vector<std::vector<Reference<T>>> buckets; // buckets[n] holds the members on n teams
+	std::unordered_map<T*, std::pair<int, int>> positions; // member -> (team count, index in its bucket)
+	int minCount = 0; // No bucket below minCount holds members
+
+	void removeFromBucket(std::pair<int, int> position) {
+		auto& bucket = buckets[position.first];
+		bucket[position.second] = bucket.back();
+		positions[bucket[position.second].getPtr()].second = position.second;
+		bucket.pop_back();
+	}
+
+public:
+	void insert(Reference<T> const& member, int teamCount) {
+		auto it = positions.find(member.getPtr());
+		if (it != positions.end()) {
+			if (it->second.first == teamCount) {
+				return;
+			}
+			removeFromBucket(it->second);
+		}
+		if (buckets.size() <= teamCount) {
+			buckets.resize(teamCount + 1);
+		}
+		positions[member.getPtr()] = { teamCount, (int)buckets[teamCount].size() };
+		buckets[teamCount].push_back(member);
+		minCount = std::min(minCount, teamCount);
+	}
+
+	// Updates the team count of member if it is indexed
+	void update(Reference<T> const& member, int teamCount) {
+		if (positions.count(member.getPtr())) {
+			insert(member, teamCount);
+		}
+	}
+
+	bool empty() const { return positions.empty(); }
+
+	// Returns the fewest teams any member is on. Requires !empty().
+	int leastCount() {
+		ASSERT(!empty());
+		while (buckets[minCount].empty()) {
+			++minCount;
+		}
+		return minCount;
+	}
+
+	// Returns the members on the fewest teams. Requires !empty().
+	std::vector<Reference<T>> const& leastUsed() { return buckets[leastCount()]; }
+};
+
 FDB_DECLARE_BOOLEAN_PARAM(IsPrimary);
 FDB_DECLARE_BOOLEAN_PARAM(IsInitialTeam);
 FDB_DECLARE_BOOLEAN_PARAM(IsRedundantTeam);
@@ -265,6 +320,7 @@ class DDTeamCollection : public ReferenceCounted<DDTeamCollection> {
 
 	Reference<EventCacheHolder> ddTrackerStartingEventHolder;
 	Reference<EventCacheHolder> teamCollectionInfoEventHolder;
+	mutable Future<Void> teamCollectionInfoTracer; // Coalesces traceTeamCollectionInfo() calls
 	Reference<EventCacheHolder> storageServerRecruitmentEventHolder;
 
 	bool primary;
@@ -286,7 +342,8 @@ class DDTeamCollection : public ReferenceCounted<DDTeamCollection> {
 
 	void resetLocalitySet();
 
-	bool satisfiesPolicy(const std::vector<Reference<TCServerInfo>>& team, int amount = -1) const;
+	// Recreates storageServerSet first if servers were removed since it was last built
+	bool satisfiesPolicy(const std::vector<Reference<TCServerInfo>>& team, int amount = -1);
 
 	Future<Void> interruptableBuildTeams();
 
@@ -337,8 +394,12 @@ class DDTeamCollection : public ReferenceCounted<DDTeamCollection> {
 
 	bool isMachineHealthy(Reference<TCMachineInfo> const& machine) const;
 
-	// Return the healthy server with the least number of correct-size server teams
-	Reference<TCServerInfo> findOneLeastUsedServer() const;
+	// Return a random server of candidates with the least number of correct-size server teams
+	Reference<TCServerInfo> findOneLeastUsedServer(TeamCountIndex<TCServerInfo>& candidates) const;
+
+	// Index the healthy servers by their number of server teams. candidates holds those of them that team building may
+	// choose, i.e. the ones with a valid locality.
+	void indexServersByTeamCount(TeamCountIndex<TCServerInfo>& healthy, TeamCountIndex<TCServerInfo>& candidates) const;
 
 	// A server team should always come from servers on a machine team
 	// Check if it is true
@@ -366,10 +427,16 @@ class DDTeamCollection : public ReferenceCounted<DDTeamCollection> {
 
 	int getHealthyMachineTeamCount() const;
 
+	// The number of machine teams each machine is expected to be on
+	int targetMachineTeamNumPerMachine() const;
+
 	// Each machine is expected to have targetMachineTeamNumPerMachine
 	// Return true if there exists a machine that does not have enough teams.
 	bool notEnoughMachineTeamsForAMachine() const;
 
+	// The number of server teams each server is expected to be on
+	int targetTeamNumPerServer() const;
+
 	// Each server is expected to have targetTeamNumPerServer teams.
 	// Return true if there exists a server that does not have enough teams.
 	bool notEnoughTeamsForAServer() const;
@@ -500,8 +567,12 @@ class DDTeamCollection : public ReferenceCounted<DDTeamCollection> {
 	Future<Void> removeWrongStoreType();
 
 	// Check if the number of server (and machine teams) is larger than the maximum allowed number
+	// The calls made within DD_TEAM_COLLECTION_INFO_TRACE_DELAY of each other are traced once, because team trackers
+	// call this whenever the health of their team changes and computing it visits all servers and teams
 	void traceTeamCollectionInfo() const;
 
+	void traceTeamCollectionInfoNow() const;
+
 	Future<Void> updateReplicasKey(Optional<Key> dcId);
 
 	Future<Void> storageRecruiter(Reference<IAsyncListener<RequestStream<RecruitStorageRequest>>> recruitStorage,
@@ -612,6 +683,7 @@ public:
 	std::vector<DDTeamCollection*> teamCollections;
 	AsyncTrigger printDetailedTeamsInfo;
 	Reference<LocalitySet> storageServerSet;
+	bool localitySetStale = false; // storageServerSet still holds removed servers
 
 	DDTeamCollection(Database const& cx,
 	                 UID distributorId,
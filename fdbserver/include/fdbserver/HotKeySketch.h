@@ -0,0 +1,85 @@
+/*
+ * HotKeySketch.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+
+#include "fdbclient/FDBTypes.h"
+#include "fdbclient/StorageServerInterface.h"
+
+// A Space-Saving heavy hitters sketch over a stream of (key, cost) pairs. It tracks at most capacity keys. When a new
+// key arrives and the sketch is full, the key with the smallest cost is replaced and the new key inherits its cost as
+// an error bound. The estimated cost of a tracked key is never less than its true cost and exceeds it by at most its
+// error, and every key whose true cost exceeds total / capacity is tracked.
+class HotKeySketch {
+public:
+	struct Counter {
+		int64_t cost = 0;
+		int64_t error = 0;
+	};
+
+	explicit HotKeySketch(int capacity);
+
+	void add(KeyRef key, int64_t cost);
+
+	// Returns the estimated cost of key, or 0 if it is not tracked
+	int64_t estimate(KeyRef key) const;
+
+	// Returns the tracked keys in keys, in decreasing order of estimated cost
+	std::vector<std::pair<KeyRef, Counter>> getTop(KeyRangeRef keys, int limit) const;
+
+	int64_t getTotal() const { return total; }
+	int size() const { return counters.size(); }
+	void clear();
+
+private:
+	int capacity;
+	int64_t total = 0;
+	std::map<Key, Counter, std::less<>> counters;
+	// Orders the tracked keys by cost, so that the key to replace is found in logarithmic time. The KeyRefs point
+	// into the keys of counters.
+	std::set<std::pair<int64_t, KeyRef>> byCost;
+};
+
+// Tracks the hottest keys read from and written to a storage server. Reads and writes are sampled with probability
+// HOT_KEY_SAMPLE_RATE into a sketch per interval of HOT_KEY_INTERVAL seconds, and the sketches of the last complete
+// interval answer queries.
+class HotKeyTracker {
+	HotKeySketch reads, writes;
+	HotKeySketch previousReads, previousWrites;
+	double intervalStart = 0;
+	double previousElapsed = 0;
+
+	void sample(HotKeySketch& sketch, KeyRef key, int64_t bytes);
+
+public:
+	HotKeyTracker();
+
+	void addRead(KeyRef key, int64_t bytes) { sample(reads, key, bytes); }
+	void addWrite(KeyRef key, int64_t bytes) { sample(writes, key, bytes); }
+
+	// Save the sketches of the current interval and start a new one
+	void startNewInterval();
+
+	// Returns the hottest keys in keys by read plus write bandwidth, as of the end of the last interval
+	Standalone<VectorRef<HotKeyMetrics>> getHotKeys(KeyRangeRef keys, int limit) const;
+};
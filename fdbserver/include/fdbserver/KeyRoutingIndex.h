@@ -0,0 +1,124 @@
+/*
+ * KeyRoutingIndex.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FDBSERVER_KEYROUTINGINDEX_H
+#define FDBSERVER_KEYROUTINGINDEX_H
+#pragma once
+
+#include <vector>
+
+#include "fdbclient/KeyRangeMap.h"
+
+// Returns the first eight bytes of key as a big endian integer, padded with zeros. Keys with different heads sort like
+// their heads.
+uint64_t keyHead(KeyRef key);
+
+// A flat copy of the boundaries of a KeyRangeMap, so that the commit proxy can find the ranges of the keys of a batch
+// with searches over contiguous arrays instead of walking the map's nodes. Boundaries are compared by their heads
+// first, so most comparisons don't touch the keys. The index refers to the keys and values of the map, so it must be
+// told about every change of the map's boundaries with invalidate(), and refreshed before it is searched again.
+// Changes of values are seen directly.
+//
+// Boundaries change on the commit path whenever a batch moves shards, often many times per batch. Invalidating is
+// O(1) and refresh() rebuilds at most once, so a commit batch costs one O(#shards) pass if it changed any boundary
+// and nothing otherwise, however many boundaries it changed.
+template <class Val>
+class KeyRoutingIndex : NonCopyable {
+public:
+	explicit KeyRoutingIndex(KeyRangeMap<Val>* map) : map(map) { rebuild(); }
+
+	// Rebuilds the whole index from the map
+	void rebuild() {
+		heads.clear();
+		begins.clear();
+		values.clear();
+		heads.reserve(map->size());
+		begins.reserve(map->size());
+		values.reserve(map->size());
+		for (auto r : map->ranges()) {
+			heads.push_back(keyHead(r.begin()));
+			begins.push_back(r.begin());
+			values.push_back(&r.value());
+		}
+		stale = false;
+	}
+
+	// Marks the index out of date after the map's boundaries have changed. The index must not be searched again until
+	// it is refreshed.
+	void invalidate() { stale = true; }
+
+	// Rebuilds the index if the map's boundaries have changed since it was last built
+	void refresh() {
+		if (stale) {
+			rebuild();
+		}
+	}
+
+	int size() const { return begins.size(); }
+	KeyRef begin(int i) const { return begins[i]; }
+	Val& value(int i) const { return *values[i]; }
+
+	// Returns the index of the range containing key
+	int find(KeyRef key) const {
+		ASSERT(!stale);
+		return upperBound(key, keyHead(key), 0) - 1;
+	}
+
+	// Returns the index of the range containing key, which must not sort before range i. Finding ascending keys this
+	// way merges them with the boundaries. Nearby keys are often in the same or the next few ranges, so those are
+	// tried before searching.
+	int findFrom(int i, KeyRef key) const {
+		uint64_t head = keyHead(key);
+		for (int probe = 0; probe < 4; probe++, i++) {
+			if (i + 1 == size() || before(key, head, i + 1)) {
+				return i;
+			}
+		}
+		return upperBound(key, head, i) - 1;
+	}
+
+private:
+	KeyRangeMap<Val>* map;
+	// The boundary of range i is begins[i], whose head is heads[i]. The keys and values are the map's.
+	std::vector<uint64_t> heads;
+	std::vector<KeyRef> begins;
+	std::vector<Val*> values;
+	bool stale = false;
+
+	// Whether key, whose head is head, sorts before the boundary of range i
+	bool before(KeyRef key, uint64_t head, int i) const { return head != heads[i] ? head < heads[i] : key < begins[i]; }
+
+	// Returns the first range from lo whose boundary sorts after key, or size()
+	int upperBound(KeyRef key, uint64_t head, int lo) const {
+		int hi = size();
+		while (lo < hi) {
+			int mid = lo + (hi - lo) / 2;
+			if (before(key, head, mid)) {
+				hi = mid;
+			} else {
+				lo = mid + 1;
+			}
+		}
+		return lo;
+	}
+};
+
+#endif
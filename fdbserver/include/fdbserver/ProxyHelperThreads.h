@@ -0,0 +1,49 @@
+/*
+ * ProxyHelperThreads.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FDBSERVER_PROXYHELPERTHREADS_H
+#define FDBSERVER_PROXYHELPERTHREADS_H
+#pragma once
+
+#include <functional>
+
+#include "flow/IThreadPool.h"
+
+// Threads that let a commit proxy spread the CPU heavy loops of a commit batch over several cores. parallelFor()
+// splits a loop into parts, runs the first part on the calling thread and the others on the helper threads, and
+// returns once all of them are done. The network thread is blocked meanwhile, so the parts may read the proxy's key
+// maps without any actor modifying them. The parts must not modify shared state, trace or use the network.
+// In simulation no threads are started and the parts run on the calling thread one after the other.
+class ProxyHelperThreads : NonCopyable {
+public:
+	explicit ProxyHelperThreads(int threads);
+
+	// Whether a loop of count items should be split
+	bool shouldSplit(int count) const;
+
+	// Calls f(begin, end) for disjoint ranges that cover [0, count), and rethrows the first error they threw
+	void parallelFor(int count, std::function<void(int begin, int end)> const& f);
+
+private:
+	int threads;
+	Reference<IThreadPool> pool;
+};
+
+#endif
@@ -98,6 +98,26 @@ struct TLogQueueInfo {
 	void update(TLogQueuingMetricsReply const& reply, Smoother& smoothTotalDurableBytes);
 };
 
+// Models a storage server or tlog queue as filling at its smoothed input rate and draining at its smoothed durable
+// rate, so that ratekeeper can limit on how soon the queue will reach its target rather than on how full it is now.
+struct QueueGrowthModel {
+	int64_t queue;
+	int64_t targetBytes;
+	double inputRate;
+	double durableRate;
+
+	QueueGrowthModel() : queue(0), targetBytes(0), inputRate(0), durableRate(0) {}
+	QueueGrowthModel(int64_t queue, int64_t targetBytes, double inputRate, double durableRate)
+	  : queue(queue), targetBytes(targetBytes), inputRate(inputRate), durableRate(durableRate) {}
+
+	// Seconds until the queue reaches targetBytes at its current net growth rate, or infinity if it is not growing
+	double secondsToLimit() const;
+
+	// The fraction of the current input rate the queue can accept so that it reaches targetBytes no sooner than
+	// horizon seconds from now. A queue that is over its target is drained over the same horizon.
+	double allowedInputRatio(double horizon) const;
+};
+
 struct RatekeeperLimits {
 	double tpsLimit;
 	Int64MetricHandle tpsLimitMetric;
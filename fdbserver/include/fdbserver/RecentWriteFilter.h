@@ -0,0 +1,64 @@
+/*
+ * RecentWriteFilter.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef FDBSERVER_RECENTWRITEFILTER_H
+#define FDBSERVER_RECENTWRITEFILTER_H
+#pragma once
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "fdbclient/FDBTypes.h"
+
+// The keys written by the transactions a commit proxy committed recently, and the latest version each was written at,
+// so that the proxy can reject transactions that read them at an older version without asking the resolvers. A hashed
+// array of versions answers most lookups of keys that were not written recently, and the exact keys confirm the rest,
+// so writtenAfter() never reports a write that was not added. Writes older than the version passed to expire() are
+// forgotten.
+class RecentWriteFilter {
+public:
+	explicit RecentWriteFilter(int slots);
+
+	// Records a write of key committed at version, which must not be less than that of earlier writes
+	void add(KeyRef key, Version version);
+
+	// Forgets the writes committed before version
+	void expire(Version version);
+
+	// Returns whether a recorded write committed after version intersects range. Writes to ranges with more than a few
+	// recorded keys may be missed.
+	bool writtenAfter(KeyRangeRef range, Version version) const;
+
+	int size() const { return latest.size(); }
+
+private:
+	// The largest version of the keys hashed to each slot
+	std::vector<Version> slots;
+	Version oldest = invalidVersion;
+	std::map<Key, Version, std::less<>> latest;
+	std::deque<std::pair<Version, KeyRef>> byVersion; // The KeyRefs point into the keys of latest
+
+	Version& slot(KeyRef key);
+	Version slot(KeyRef key) const { return const_cast<RecentWriteFilter*>(this)->slot(key); }
+};
+
+#endif
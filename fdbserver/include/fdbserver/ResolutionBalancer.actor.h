@@ -35,6 +35,34 @@
 #include "flow/genericactors.actor.h"
 #include "flow/actorcompiler.h" // must be last include
 
+// Estimates the load of every resolver from the CPU time its conflict detection used, or from the number of conflict
+// ranges it checked where CPU time is not measured, smoothed over balancing rounds. Plans moves of key ranges from the
+// most to the least loaded resolver, sized in units of the source resolver's key sample so that it can pick the keys
+// to split at.
+struct ResolverLoadModel {
+	struct Move {
+		int src, dest;
+		int64_t amount;
+	};
+
+	std::vector<double> loads; // The smoothed load of every resolver, per second
+
+	// Adds the metrics the resolvers reported at time now
+	void update(const std::vector<ResolutionMetricsReply>& metrics, double now);
+
+	// Returns the move that halves the largest load difference, unless the loads are balanced enough
+	Optional<Move> planMove(const std::vector<ResolutionMetricsReply>& metrics) const;
+
+	// Forgets the smoothed loads after key ranges were moved, so that the next move is planned from loads measured
+	// after this one
+	void reset() { loads.clear(); }
+
+private:
+	std::vector<ResolutionMetricsReply> last;
+	double lastTime = 0;
+	bool cpuLoads = false;
+};
+
 struct ResolutionBalancer {
 	AsyncVar<Standalone<VectorRef<ResolverMoveRef>>> resolverChanges;
 	Version resolverChangesVersion = invalidVersion;
@@ -45,6 +73,7 @@ struct ResolutionBalancer {
 	std::vector<CommitProxyInterface> commitProxies;
 	std::vector<ResolverInterface> resolvers;
 	AsyncTrigger triggerResolution;
+	ResolverLoadModel loadModel;
 
 	ResolutionBalancer(Version* version) : pVersion(version) {}
 
@@ -149,13 +149,17 @@ struct ResolveTransactionBatchRequest {
 struct ResolutionMetricsReply {
 	constexpr static FileIdentifier file_identifier = 3;
 
-	int64_t value;
+	int64_t value; // Estimated from the resolver's sample of conflict range keys
+	// Totals since the resolver started. CPU time is not measured in simulation.
+	double cpuSeconds = 0;
+	int64_t conflictRanges = 0;
+
 	ResolutionMetricsReply() = default;
 	explicit ResolutionMetricsReply(int64_t value) : value(value) {}
 
 	template <class Ar>
 	void serialize(Ar& ar) {
-		serializer(ar, value);
+		serializer(ar, value, cpuSeconds, conflictRanges);
 	}
 };
 
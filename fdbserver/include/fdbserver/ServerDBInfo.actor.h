@@ -119,6 +119,9 @@ struct GetServerDBInfoRequest {
 
 ACTOR Future<Void> broadcastTxnRequest(TxnStateRequest req, int sendAmount, bool sendReply);
 
+// Broadcasts req like broadcastTxnRequest, but replies only once applied is also ready
+ACTOR Future<Void> forwardTxnRequest(TxnStateRequest req, int sendAmount, Future<Void> applied);
+
 ACTOR Future<std::vector<Endpoint>> broadcastDBInfoRequest(UpdateServerDBInfoRequest req,
                                                            int sendAmount,
                                                            Optional<Endpoint> sender,
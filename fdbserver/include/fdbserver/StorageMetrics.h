@@ -26,6 +26,7 @@
 #include "fdbclient/StorageServerInterface.h"
 #include "fdbclient/KeyRangeMap.h"
 #include "fdbserver/Knobs.h"
+#include "flow/IndexedBTree.h"
 
 const StringRef STORAGESERVER_HISTOGRAM_GROUP = "StorageServer"_sr;
 const StringRef FETCH_KEYS_LATENCY_HISTOGRAM = "FetchKeysLatency"_sr;
@@ -41,7 +42,7 @@ const StringRef STORAGE_COMMIT_LATENCY_HISTOGRAM = "StorageCommitLatency"_sr;
 const StringRef SS_DURABLE_VERSION_UPDATE_LATENCY_HISTOGRAM = "SSDurableVersionUpdateLatency"_sr;
 
 struct StorageMetricSample {
-	IndexedSet<Key, int64_t> sample;
+	IndexedBTree<Key, int64_t> sample;
 	int64_t metricUnitsPerSample;
 
 	explicit StorageMetricSample(int64_t metricUnitsPerSample) : metricUnitsPerSample(metricUnitsPerSample) {}
@@ -371,7 +372,8 @@ struct StorageServerMetrics {
 				if (remaining.bytes < 2 * minSplitBytes)
 					break;
 				KeyRef key = req.keys.end;
-				bool hasUsed = used.bytes != 0 || used.bytesPerKSecond != 0 || used.iosPerKSecond != 0;
+				bool hasUsed = used.bytes != 0 || used.bytesPerKSecond != 0 || used.iosPerKSecond != 0 ||
+				               used.bytesReadPerKSecond != 0;
 				key = getSplitKey(remaining.bytes,
 				                  estimated.bytes,
 				                  req.limits.bytes,
@@ -408,6 +410,17 @@ struct StorageServerMetrics {
 				                  lastKey,
 				                  key,
 				                  hasUsed);
+				key = getSplitKey(remaining.bytesReadPerKSecond,
+				                  estimated.bytesReadPerKSecond,
+				                  req.limits.bytesReadPerKSecond,
+				                  used.bytesReadPerKSecond,
+				                  req.limits.infinity,
+				                  req.isLastShard,
+				                  bytesReadSample,
+				                  SERVER_KNOBS->STORAGE_METRICS_AVERAGE_INTERVAL_PER_KSECONDS,
+				                  lastKey,
+				                  key,
+				                  hasUsed);
 				ASSERT(key != lastKey || hasUsed);
 				if (key == req.keys.end)
 					break;
@@ -540,7 +553,7 @@ struct StorageServerMetrics {
 	std::vector<KeyRef> getSplitPoints(KeyRangeRef range, int64_t chunkSize, Optional<Key> prefixToRemove) const {
 		std::vector<KeyRef> toReturn;
 		KeyRef beginKey = range.begin;
-		IndexedSet<Key, int64_t>::const_iterator endKey =
+		auto endKey =
 		    byteSample.sample.index(byteSample.sample.sumTo(byteSample.sample.lower_bound(beginKey)) + chunkSize);
 		while (endKey != byteSample.sample.end()) {
 			if (*endKey > range.end) {
@@ -0,0 +1,72 @@
+/*
+ * StorageServerReadCache.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+
+#include <boost/intrusive/list.hpp>
+
+#include "fdbclient/FDBTypes.h"
+
+// A size-bounded LRU cache of point reads served by a storage server's storage engine.
+//
+// An entry holds the value (or absence) of a key as stored in the engine, and is valid for reads at or after
+// validFrom until a mutation to the key is applied to the storage server's versioned data, at which point the
+// storage server invalidates it.  The storage server only consults the cache for keys which have no entries in
+// the versioned map at the read version, which is exactly when the engine's value would have been returned.
+class StorageServerReadCache : NonCopyable {
+	struct Entry : public boost::intrusive::list_base_hook<> {
+		KeyRef key; // Refers to the memory of the map's key
+		Optional<Value> value;
+		Version validFrom;
+		int64_t bytes;
+	};
+	typedef std::map<Key, Entry, std::less<>> EntryMapT;
+	typedef boost::intrusive::list<Entry> EvictionOrderT;
+
+	EntryMapT entries;
+	EvictionOrderT evictionOrder;
+	int64_t capacityBytes;
+	int64_t bytes;
+	int64_t evictions;
+
+	void erase(EntryMapT::iterator it);
+
+public:
+	explicit StorageServerReadCache(int64_t capacityBytes);
+	~StorageServerReadCache();
+
+	bool enabled() const { return capacityBytes > 0; }
+
+	// Returns the cached value of key if there is an entry valid at version.  The outer Optional is empty on a miss.
+	Optional<Optional<Value>> get(KeyRef key, Version version);
+
+	// Caches the value of key as read from the storage engine, valid for reads at versions >= validFrom.
+	void insert(KeyRef key, Optional<Value> const& value, Version validFrom);
+
+	void invalidate(KeyRef key);
+	void invalidate(KeyRangeRef range);
+	void clear();
+
+	int64_t getBytes() const { return bytes; }
+	int64_t getEntries() const { return entries.size(); }
+	int64_t getEvictions() const { return evictions; }
+};
@@ -61,6 +61,7 @@
 #include "fdbserver/EncryptedMutationMessage.h"
 #include "fdbserver/FDBExecHelper.actor.h"
 #include "fdbserver/GetEncryptCipherKeys.h"
+#include "fdbserver/HotKeySketch.h"
 #include "fdbserver/IKeyValueStore.h"
 #include "fdbserver/Knobs.h"
 #include "fdbserver/LatencyBandConfig.h"
@@ -76,6 +77,7 @@
 #include "fdbserver/ServerDBInfo.h"
 #include "fdbserver/SpanContextMessage.h"
 #include "fdbserver/StorageMetrics.h"
+#include "fdbserver/StorageServerReadCache.h"
 #include "fdbserver/TLogInterface.h"
 #include "fdbserver/TransactionTagCounter.h"
 #include "fdbserver/WaitFailure.h"
@@ -927,8 +929,12 @@ public:
 
 	KeyRangeMap<Reference<ShardInfo>> shards;
 	uint64_t shardChangeCounter; // max( shards->changecounter )
+	StorageServerReadCache readCache; // Point reads served by the storage engine, invalidated by applyMutation()
 
 	KeyRangeMap<bool> cachedRangeMap; // indicates if a key-range is being cached
+	// The bytes of the rows array of recent readRange() replies to getKeyValues and getMappedKeyValues requests
+	ArenaSizeHint readRangeRowsHint;
+	ArenaSizeHint mappedRangeRowsHint;
 
 	KeyRangeMap<std::vector<Reference<ChangeFeedInfo>>> keyChangeFeed;
 	std::map<Key, Reference<ChangeFeedInfo>> uidChangeFeed;
@@ -1046,6 +1052,7 @@ public:
 
 	TransactionTagCounter transactionTagCounter;
 	BusiestWriteTagContext busiestWriteTagContext;
+	HotKeyTracker hotKeys;
 
 	Optional<LatencyBandConfig> latencyBandConfig;
 
@@ -1116,6 +1123,8 @@ public:
 		Counter kvCommits;
 		// The count of change feed reads that hit disk
 		Counter changeFeedDiskReads;
+		// The count of point reads that would have gone to the storage engine and were or were not served by readCache
+		Counter readCacheHits, readCacheMisses;
 
 		LatencySample readLatencySample;
 		LatencyBands readLatencyBands;
@@ -1151,6 +1160,7 @@ public:
 		    quickGetKeyValuesMiss("QuickGetKeyValuesMiss", cc), kvScanBytes("KVScanBytes", cc),
 		    kvGetBytes("KVGetBytes", cc), eagerReadsKeys("EagerReadsKeys", cc), kvGets("KVGets", cc),
 		    kvScans("KVScans", cc), kvCommits("KVCommits", cc), changeFeedDiskReads("ChangeFeedDiskReads", cc),
+		    readCacheHits("ReadCacheHits", cc), readCacheMisses("ReadCacheMisses", cc),
 		    readLatencySample("ReadLatencyMetrics",
 		                      self->thisServerID,
 		                      SERVER_KNOBS->LATENCY_METRICS_LOGGING_INTERVAL,
@@ -1205,6 +1215,9 @@ public:
 			specialCounter(cc, "KvstoreInlineKey", [self]() { return std::get<2>(self->storage.getSize()); });
 			specialCounter(cc, "ActiveChangeFeeds", [self]() { return self->uidChangeFeed.size(); });
 			specialCounter(cc, "ActiveChangeFeedQueries", [self]() { return self->activeFeedQueries; });
+			specialCounter(cc, "ReadCacheBytes", [self]() { return self->readCache.getBytes(); });
+			specialCounter(cc, "ReadCacheEntries", [self]() { return self->readCache.getEntries(); });
+			specialCounter(cc, "ReadCacheEvictions", [self]() { return self->readCache.getEvictions(); });
 		}
 	} counters;
 
@@ -1241,8 +1254,9 @@ public:
 	                                                                   SS_DURABLE_VERSION_UPDATE_LATENCY_HISTOGRAM,
 	                                                                   Histogram::Unit::microseconds)),
 	    tag(invalidTag), poppedAllAfter(std::numeric_limits<Version>::max()), cpuUsage(0.0), diskUsage(0.0),
-	    storage(this, storage), shardChangeCounter(0), lastTLogVersion(0), lastVersionWithData(0), restoredVersion(0),
-	    prevVersion(0), rebootAfterDurableVersion(std::numeric_limits<Version>::max()),
+	    storage(this, storage), shardChangeCounter(0),
+	    readCache(SERVER_KNOBS->STORAGE_SERVER_READ_CACHE_BYTES), lastTLogVersion(0), lastVersionWithData(0),
+	    restoredVersion(0), prevVersion(0), rebootAfterDurableVersion(std::numeric_limits<Version>::max()),
 	    primaryLocality(tagLocalityInvalid), knownCommittedVersion(0), versionLag(0), logProtocol(0),
 	    thisServerID(ssi.id()), tssInQuarantine(false), db(db), actors(false),
 	    byteSampleClears(false, LiteralStringRef("\xff\xff\xff")), durableInProgress(Void()), watchBytes(0),
@@ -1289,6 +1303,7 @@ public:
 	void addShard(ShardInfo* newShard) {
 		ASSERT(!newShard->keys.empty());
 		newShard->changeCounter = ++shardChangeCounter;
+		readCache.invalidate(newShard->keys);
 		//TraceEvent("AddShard", this->thisServerID).detail("KeyBegin", newShard->keys.begin).detail("KeyEnd", newShard->keys.end).detail("State", newShard->isReadable() ? "Readable" : newShard->notAssigned() ? "NotAssigned" : "Adding").detail("Version", this->version.get());
 		/*auto affected = shards.getAffectedRangesAfterInsertion( newShard->keys, Reference<ShardInfo>() );
 		for(auto i = affected.begin(); i != affected.end(); ++i)
@@ -1842,15 +1857,41 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 			path = 1;
 		} else if (!i || !i->isClearTo() || i->getEndKey() <= req.key) {
 			path = 2;
-			Optional<Value> vv = wait(data->storage.readValue(req.key, IKeyValueStore::ReadType::NORMAL, req.debugID));
-			data->counters.kvGetBytes += vv.expectedSize();
-			// Validate that while we were reading the data we didn't lose the version or shard
-			if (version < data->storageVersion()) {
-				CODE_PROBE(true, "transaction_too_old after readValue");
-				throw transaction_too_old();
+			Optional<Optional<Value>> cached;
+			if (data->readCache.enabled()) {
+				cached = data->readCache.get(req.key, version);
+				if (cached.present()) {
+					CODE_PROBE(true, "getValueQ served from storage server read cache");
+					++data->counters.readCacheHits;
+				} else {
+					++data->counters.readCacheMisses;
+				}
+			}
+			if (cached.present()) {
+				v = cached.get();
+			} else {
+				state Version readStorageVersion = data->storageVersion();
+				Optional<Value> vv =
+				    wait(data->storage.readValue(req.key, IKeyValueStore::ReadType::NORMAL, req.debugID));
+				data->counters.kvGetBytes += vv.expectedSize();
+				// Validate that while we were reading the data we didn't lose the version or shard
+				if (version < data->storageVersion()) {
+					CODE_PROBE(true, "transaction_too_old after readValue");
+					throw transaction_too_old();
+				}
+				data->checkChangeCounter(changeCounter, req.key);
+				v = vv;
+
+				// The engine's value is current as long as no mutation to the key is still in the versioned map, since
+				// mutations stay there until they are durable and applyMutation() invalidates the cache for new ones.
+				if (data->readCache.enabled()) {
+					auto latest = data->data().atLatest().lastLessOrEqual(req.key);
+					if (!latest ||
+					    (latest.key() != req.key && (!latest->isClearTo() || latest->getEndKey() <= req.key))) {
+						data->readCache.insert(req.key, vv, readStorageVersion);
+					}
+				}
 			}
-			data->checkChangeCounter(changeCounter, req.key);
-			v = vv;
 		}
 
 		DEBUG_MUTATION("ShardGetValue",
@@ -1888,6 +1929,8 @@ ACTOR Future<Void> getValueQ(StorageServer* data, GetValueRequest req) {
 			                : SERVER_KNOBS->EMPTY_READ_PENALTY;
 			data->metrics.notifyBytesReadPerKSecond(req.key, bytesReadPerKSecond);
 		}
+		data->hotKeys.addRead(req.key,
+		                      std::max((int64_t)(req.key.size() + resultSize), SERVER_KNOBS->EMPTY_READ_PENALTY));
 
 		if (req.debugID.present())
 			g_traceBatch.addEvent("GetValueDebug",
@@ -3283,7 +3326,8 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
                                           int* pLimitBytes,
                                           SpanContext parentSpan,
                                           IKeyValueStore::ReadType type,
-                                          Optional<Key> tenantPrefix) {
+                                          Optional<Key> tenantPrefix,
+                                          ArenaSizeHint* rowsHint) {
 	state GetKeyValuesReply result;
 	state StorageServer::VersionedData::ViewAtVersion view = data->data().at(version);
 	state StorageServer::VersionedData::iterator vCurrent = view.end();
@@ -3299,6 +3343,13 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
 	// for remembering the position in the resultCache
 	state int pos = 0;
 
+	// Size the rows array from recent replies of the same caller up front, rather than growing it by doubling within
+	// the reply arena. Never reserve more rows than the request can return.
+	if (rowsHint != nullptr) {
+		result.data.reserve(result.arena,
+		                    std::min<int64_t>(rowsHint->reservedSize() / sizeof(KeyValueRef), std::abs(limit)));
+	}
+
 	// Check if the desired key-range is cached
 	auto containingRange = data->cachedRangeMap.rangeContaining(range.begin);
 	if (containingRange.value() && containingRange->range().end >= range.end) {
@@ -3503,6 +3554,9 @@ ACTOR Future<GetKeyValuesReply> readRange(StorageServer* data,
 	ASSERT(result.data.size() == 0 || *pLimitBytes + result.data.end()[-1].expectedSize() + sizeof(KeyValueRef) > 0);
 	result.more = limit == 0 || *pLimitBytes <= 0; // FIXME: Does this have to be exact?
 	result.version = version;
+	if (rowsHint != nullptr) {
+		rowsHint->record(result.data.size() * sizeof(KeyValueRef));
+	}
 	return result;
 }
 
@@ -3563,7 +3617,8 @@ ACTOR Future<Key> findKey(StorageServer* data,
 	              &maxBytes,
 	              span.context,
 	              type,
-	              Optional<Key>()));
+	              Optional<Key>(),
+	              nullptr));
 	state bool more = rep.more && rep.data.size() != distance + skipEqualKey;
 
 	// If we get only one result in the reverse direction as a result of the data being too large, we could get stuck in
@@ -3578,7 +3633,8 @@ ACTOR Future<Key> findKey(StorageServer* data,
 		                                        &maxBytes,
 		                                        span.context,
 		                                        type,
-		                                        Optional<Key>()));
+		                                        Optional<Key>(),
+		                                        nullptr));
 		rep = rep2;
 		more = rep.more && rep.data.size() != distance + skipEqualKey;
 		ASSERT(rep.data.size() == 2 || !more);
@@ -3772,7 +3828,8 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 			                                      &remainingLimitBytes,
 			                                      span.context,
 			                                      type,
-			                                      tenantPrefix));
+			                                      tenantPrefix,
+			                                      &data->readRangeRowsHint));
 			GetKeyValuesReply r = _r;
 
 			if (req.debugID.present())
@@ -3807,6 +3864,11 @@ ACTOR Future<Void> getKeyValuesQ(StorageServer* data, GetKeyValuesRequest req)
 				data->metrics.notifyBytesReadPerKSecond(
 				    addPrefix(r.data[r.data.size() - 1].key, tenantPrefix, req.arena), bytesReadPerKSecond);
 			}
+			if (totalByteSize > 0) {
+				int64_t bytesRead = std::max(totalByteSize, SERVER_KNOBS->EMPTY_READ_PENALTY) / 2;
+				data->hotKeys.addRead(addPrefix(r.data[0].key, tenantPrefix, req.arena), bytesRead);
+				data->hotKeys.addRead(addPrefix(r.data.back().key, tenantPrefix, req.arena), bytesRead);
+			}
 
 			r.penalty = data->getPenalty();
 			req.reply.send(r);
@@ -4527,7 +4589,8 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 			                                                     &remainingLimitBytes,
 			                                                     span.context,
 			                                                     type,
-			                                                     tenantPrefix));
+			                                                     tenantPrefix,
+			                                                     &data->mappedRangeRowsHint));
 
 			state GetMappedKeyValuesReply r;
 			try {
@@ -4565,6 +4628,11 @@ ACTOR Future<Void> getMappedKeyValuesQ(StorageServer* data, GetMappedKeyValuesRe
 				data->metrics.notifyBytesReadPerKSecond(
 				    addPrefix(r.data[r.data.size() - 1].key, tenantPrefix, req.arena), bytesReadPerKSecond);
 			}
+			if (totalByteSize > 0) {
+				int64_t bytesRead = std::max(totalByteSize, SERVER_KNOBS->EMPTY_READ_PENALTY) / 2;
+				data->hotKeys.addRead(addPrefix(r.data[0].key, tenantPrefix, req.arena), bytesRead);
+				data->hotKeys.addRead(addPrefix(r.data.back().key, tenantPrefix, req.arena), bytesRead);
+			}
 
 			r.penalty = data->getPenalty();
 			req.reply.send(r);
@@ -4765,6 +4833,11 @@ ACTOR Future<Void> getKeyValuesStreamQ(StorageServer* data, GetKeyValuesStreamRe
 					data->metrics.notifyBytesReadPerKSecond(firstKey, bytesReadPerKSecond);
 					data->metrics.notifyBytesReadPerKSecond(lastKey, bytesReadPerKSecond);
 				}
+				if (totalByteSize > 0) {
+					int64_t bytesRead = std::max(totalByteSize, SERVER_KNOBS->EMPTY_READ_PENALTY) / 2;
+					data->hotKeys.addRead(addPrefix(r.data[0].key, tenantPrefix, req.arena), bytesRead);
+					data->hotKeys.addRead(lastKey, bytesRead);
+				}
 
 				req.reply.send(r);
 
@@ -5157,6 +5230,7 @@ void applyMutation(StorageServer* self,
 	self->metrics.notify(m.param1, metrics);
 
 	if (m.type == MutationRef::SetValue) {
+		self->readCache.invalidate(m.param1);
 		// VersionedMap (data) is bookkeeping all empty ranges. If the key to be set is new, it is supposed to be in a
 		// range what was empty. Break the empty range into halves.
 		auto prev = data.atLatest().lastLessOrEqual(m.param1);
@@ -5182,6 +5256,7 @@ void applyMutation(StorageServer* self,
 		data.insert(m.param1, ValueOrClearToRef::value(m.param2));
 		self->watches.trigger(m.param1);
 	} else if (m.type == MutationRef::ClearRange) {
+		self->readCache.invalidate(KeyRangeRef(m.param1, m.param2));
 		data.erase(m.param1, m.param2);
 		ASSERT(m.param2 > m.param1);
 		ASSERT(!data.isClearContaining(data.atLatest(), m.param1));
@@ -8199,6 +8274,10 @@ ACTOR Future<Void> update(StorageServer* data, bool* pReceivedUpdate) {
 					data->counters.mutationBytes += msg.totalSize();
 					data->counters.logicalBytesInput += msg.expectedSize();
 					++data->counters.mutations;
+					// Private mutations and clears are not attributed to a hot key
+					if (msg.type != MutationRef::ClearRange && !msg.param1.startsWith(systemKeys.end)) {
+						data->hotKeys.addWrite(msg.param1, msg.expectedSize());
+					}
 					switch (msg.type) {
 					case MutationRef::SetValue:
 						++data->counters.setMutations;
@@ -9684,6 +9763,16 @@ ACTOR Future<Void> metricsCore(StorageServer* self, StorageServerInterface ssi)
 					self->metrics.getReadHotRanges(req);
 				}
 			}
+			when(GetHotKeysRequest req = waitNext(ssi.getHotKeys.getFuture())) {
+				if (!self->isReadable(req.keys)) {
+					CODE_PROBE(true, "getHotKeys immediate wrong_shard_server()");
+					self->sendErrorWithPenalty(req.reply, wrong_shard_server(), self->getPenalty());
+				} else {
+					GetHotKeysReply reply;
+					reply.hotKeys = self->hotKeys.getHotKeys(req.keys, req.limit);
+					req.reply.send(reply);
+				}
+			}
 			when(SplitRangeRequest req = waitNext(ssi.getRangeSplitPoints.getFuture())) {
 				if (!self->isReadable(req.keys)) {
 					CODE_PROBE(true, "getSplitPoints immediate wrong_shard_server()");
@@ -10017,6 +10106,7 @@ ACTOR Future<Void> storageServerCore(StorageServer* self, StorageServerInterface
 	self->transactionTagCounter.startNewInterval();
 	self->actors.add(
 	    recurring([&]() { self->transactionTagCounter.startNewInterval(); }, SERVER_KNOBS->TAG_MEASUREMENT_INTERVAL));
+	self->actors.add(recurring([&]() { self->hotKeys.startNewInterval(); }, SERVER_KNOBS->HOT_KEY_INTERVAL));
 
 	self->coreStarted.send(Void());
 
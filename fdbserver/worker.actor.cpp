@@ -60,6 +60,8 @@
 #include "fdbclient/MonitorLeader.h"
 #include "fdbclient/ClientWorkerInterface.h"
 #include "flow/Profiler.h"
+#include "flow/HeapProfiler.h"
+#include "flow/SlowTaskProfiler.h"
 #include "flow/ThreadHelper.actor.h"
 #include "flow/Trace.h"
 #include "flow/flow.h"
@@ -1135,6 +1137,43 @@ void updateCpuProfiler(ProfilerRequest req) {
 			break;
 		}
 		break;
+	case ProfilerRequest::Type::SLOW_TASK:
+		switch (req.action) {
+		case ProfilerRequest::Action::ENABLE:
+			SlowTaskProfiler::instance().enable();
+			break;
+		case ProfilerRequest::Action::DISABLE:
+			try {
+				SlowTaskProfiler::writeProfile(SlowTaskProfiler::instance().disable(), req.outputFile.toString());
+			} catch (Error& e) {
+				TraceEvent(SevWarnAlways, "SlowTaskProfileWriteError").error(e).detail("File", req.outputFile);
+			}
+			break;
+		case ProfilerRequest::Action::RUN:
+			ASSERT(false); // User should have called runProfiler.
+			break;
+		}
+		break;
+	case ProfilerRequest::Type::HEAP:
+		switch (req.action) {
+		case ProfilerRequest::Action::ENABLE:
+			HeapProfiler::enable(FLOW_KNOBS->HEAP_PROFILER_SAMPLE_BYTES);
+			break;
+		case ProfilerRequest::Action::DISABLE: {
+			std::vector<HeapProfiler::Site> sites = HeapProfiler::getLiveSites();
+			HeapProfiler::disable();
+			try {
+				HeapProfiler::writeProfile(sites, req.outputFile.toString());
+			} catch (Error& e) {
+				TraceEvent(SevWarnAlways, "HeapProfileWriteError").error(e).detail("File", req.outputFile);
+			}
+			break;
+		}
+		case ProfilerRequest::Action::RUN:
+			ASSERT(false); // User should have called runProfiler.
+			break;
+		}
+		break;
 	default:
 		ASSERT(false);
 		break;
@@ -1279,6 +1318,7 @@ ACTOR Future<Void> storageServerRollbackRebooter(std::set<std::pair<UID, KeyValu
 		DUMPTOKEN(recruited.waitMetrics);
 		DUMPTOKEN(recruited.splitMetrics);
 		DUMPTOKEN(recruited.getReadHotRanges);
+		DUMPTOKEN(recruited.getHotKeys);
 		DUMPTOKEN(recruited.getRangeSplitPoints);
 		DUMPTOKEN(recruited.getStorageMetrics);
 		DUMPTOKEN(recruited.waitFailure);
@@ -1730,6 +1770,7 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 				DUMPTOKEN(recruited.waitMetrics);
 				DUMPTOKEN(recruited.splitMetrics);
 				DUMPTOKEN(recruited.getReadHotRanges);
+				DUMPTOKEN(recruited.getHotKeys);
 				DUMPTOKEN(recruited.getRangeSplitPoints);
 				DUMPTOKEN(recruited.getStorageMetrics);
 				DUMPTOKEN(recruited.waitFailure);
@@ -1996,10 +2037,17 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 				// beneath the working directory, and we remove the ability to do any symlink or ../..
 				// tricks by resolving all paths through `abspath` first.
 				try {
+					// The in-process profilers only write a file when they are disabled
+					bool writesFile = profilerReq.action != ProfilerRequest::Action::ENABLE ||
+					                  (profilerReq.type != ProfilerRequest::Type::SLOW_TASK &&
+					                   profilerReq.type != ProfilerRequest::Type::HEAP);
 					std::string realLogDir = abspath(SERVER_KNOBS->LOG_DIRECTORY);
 					std::string realOutPath = abspath(realLogDir + "/" + profilerReq.outputFile.toString());
-					if (realLogDir.size() < realOutPath.size() &&
-					    strncmp(realLogDir.c_str(), realOutPath.c_str(), realLogDir.size()) == 0) {
+					if (!writesFile) {
+						uncancellable(runProfiler(profilerReq));
+						profilerReq.reply.send(Void());
+					} else if (realLogDir.size() < realOutPath.size() &&
+					           strncmp(realLogDir.c_str(), realOutPath.c_str(), realLogDir.size()) == 0) {
 						profilerReq.outputFile = realOutPath;
 						uncancellable(runProfiler(profilerReq));
 						profilerReq.reply.send(Void());
@@ -2267,6 +2315,7 @@ ACTOR Future<Void> workerServer(Reference<IClusterConnectionRecord> connRecord,
 					DUMPTOKEN(recruited.waitMetrics);
 					DUMPTOKEN(recruited.splitMetrics);
 					DUMPTOKEN(recruited.getReadHotRanges);
+					DUMPTOKEN(recruited.getHotKeys);
 					DUMPTOKEN(recruited.getRangeSplitPoints);
 					DUMPTOKEN(recruited.getStorageMetrics);
 					DUMPTOKEN(recruited.waitFailure);
@@ -0,0 +1,265 @@
+/*
+ * DataMoveThroughput.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/ManagementAPI.actor.h"
+#include "fdbclient/NativeAPI.actor.h"
+#include "fdbclient/StatusClient.h"
+#include "fdbserver/DataDistribution.actor.h"
+#include "fdbserver/QuietDatabase.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Measures how fast data distribution moves data off a storage server, first by excluding the server and then (if
+// measureWiggle is set) by running one step of the perpetual storage wiggle. Only a server whose exclusion passes
+// checkSafeExclusions is excluded, and the check fails unless the data moved at minBytesPerSecond or more.
+struct DataMoveThroughputWorkload : TestWorkload {
+	int keyCount, valueBytes;
+	bool measureWiggle;
+	double maxWaitTime;
+	double minBytesPerSecond;
+	bool noSafeExclusion;
+	double exclusionSeconds, exclusionBytes;
+	double wiggleSeconds, wiggleBytes;
+
+	DataMoveThroughputWorkload(WorkloadContext const& wcx)
+	  : TestWorkload(wcx), noSafeExclusion(false), exclusionSeconds(0), exclusionBytes(0), wiggleSeconds(0),
+	    wiggleBytes(0) {
+		keyCount = getOption(options, "keyCount"_sr, 20000);
+		valueBytes = getOption(options, "valueBytes"_sr, 1000);
+		measureWiggle = getOption(options, "measureWiggle"_sr, true);
+		maxWaitTime = getOption(options, "maxWaitTime"_sr, 1200.0);
+		// Half the data we load per maxWaitTime, which a healthy cluster exceeds by far
+		minBytesPerSecond = getOption(options, "minBytesPerSecond"_sr, 0.5 * keyCount * valueBytes / maxWaitTime);
+	}
+
+	std::string description() const override { return "DataMoveThroughput"; }
+
+	static Key keyForIndex(int i) { return StringRef(format("datamovethroughput%08x", i)); }
+
+	Future<Void> setup(Database const& cx) override { return clientId == 0 ? _setup(cx, this) : Void(); }
+
+	Future<Void> start(Database const& cx) override { return clientId == 0 ? _start(cx, this) : Void(); }
+
+	Future<bool> check(Database const& cx) override {
+		if (clientId != 0) {
+			return true;
+		}
+		bool ok = true;
+		if (noSafeExclusion) {
+			// No server could be excluded without losing fault tolerance, so there was nothing to measure
+			TraceEvent(SevWarnAlways, "DataMoveThroughputNotMeasured").detail("Reason", "NoSafeExclusion");
+		} else {
+			ok = checkRate("Exclusion", exclusionSeconds, exclusionBytes) && ok;
+		}
+		if (measureWiggle) {
+			ok = checkRate("Wiggle", wiggleSeconds, wiggleBytes) && ok;
+		}
+		return ok;
+	}
+
+	// Whether moving bytes took seconds at no less than minBytesPerSecond. A movement that was never measured fails.
+	bool checkRate(const char* movement, double seconds, double bytes) const {
+		bool ok = seconds > 0 && bytes > 0 && bytes / seconds >= minBytesPerSecond;
+		if (!ok) {
+			TraceEvent(SevError, "DataMoveThroughputTooSlow")
+			    .detail("Movement", movement)
+			    .detail("Seconds", seconds)
+			    .detail("Bytes", bytes)
+			    .detail("MinBytesPerSecond", minBytesPerSecond);
+		}
+		return ok;
+	}
+
+	void getMetrics(std::vector<PerfMetric>& m) override {
+		if (clientId == 0) {
+			m.emplace_back("Exclusion Seconds", exclusionSeconds, Averaged::False);
+			m.emplace_back("Exclusion Bytes/sec",
+			               exclusionSeconds > 0 ? exclusionBytes / exclusionSeconds : 0,
+			               Averaged::False);
+			if (measureWiggle) {
+				m.emplace_back("Wiggle Seconds", wiggleSeconds, Averaged::False);
+				m.emplace_back(
+				    "Wiggle Bytes/sec", wiggleSeconds > 0 ? wiggleBytes / wiggleSeconds : 0, Averaged::False);
+			}
+		}
+	}
+
+	ACTOR static Future<Void> _setup(Database cx, DataMoveThroughputWorkload* self) {
+		state int i = 0;
+		state int batch = 100;
+		for (i = 0; i < self->keyCount; i += batch) {
+			state Transaction tr(cx);
+			loop {
+				try {
+					for (int j = i; j < std::min(i + batch, self->keyCount); j++) {
+						tr.set(keyForIndex(j), Value(deterministicRandom()->randomAlphaNumeric(self->valueBytes)));
+					}
+					wait(tr.commit());
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+		}
+		return Void();
+	}
+
+	// Returns the bytes in queue and in flight for data distribution, as reported by status
+	ACTOR static Future<double> getMovingData(Database cx) {
+		StatusObject statusObj = wait(StatusClient::statusFetcher(cx));
+		StatusObjectReader statusObjCluster;
+		((StatusObjectReader)statusObj).get("cluster", statusObjCluster);
+		StatusObjectReader statusObjData;
+		statusObjCluster.get("data", statusObjData);
+		if (statusObjData.has("moving_data")) {
+			StatusObjectReader movingData = statusObjData.last();
+			double dataInQueue, dataInFlight;
+			if (movingData.get("in_queue_bytes", dataInQueue) && movingData.get("in_flight_bytes", dataInFlight)) {
+				return dataInQueue + dataInFlight;
+			}
+		}
+		return -1.0;
+	}
+
+	ACTOR static Future<Void> waitForNoMovingData(Database cx) {
+		loop {
+			double movingData = wait(getMovingData(cx));
+			if (movingData == 0.0) {
+				return Void();
+			}
+			wait(delay(2.5));
+		}
+	}
+
+	// Returns the bytes stored by each storage server
+	ACTOR static Future<std::vector<std::pair<StorageServerInterface, int64_t>>> getStoredBytes(Database cx) {
+		state std::vector<StorageServerInterface> servers = wait(getStorageServers(cx));
+		state std::vector<Future<ErrorOr<GetStorageMetricsReply>>> replies;
+		for (auto& ssi : servers) {
+			replies.push_back(ssi.getStorageMetrics.tryGetReply(GetStorageMetricsRequest()));
+		}
+		wait(waitForAll(replies));
+
+		std::vector<std::pair<StorageServerInterface, int64_t>> result;
+		for (int i = 0; i < servers.size(); i++) {
+			if (replies[i].get().present()) {
+				result.emplace_back(servers[i], replies[i].get().get().load.bytes);
+			}
+		}
+		return result;
+	}
+
+	ACTOR static Future<Optional<StorageWiggleMetrics>> getWiggleMetrics(Database cx) {
+		Optional<Value> value = wait(StorageWiggleMetrics::runGetTransaction(cx, true));
+		if (!value.present()) {
+			return Optional<StorageWiggleMetrics>();
+		}
+		return ObjectReader::fromStringRef<StorageWiggleMetrics>(value.get(), IncludeVersion());
+	}
+
+	ACTOR static Future<Void> measureExclusion(Database cx, DataMoveThroughputWorkload* self) {
+		state std::vector<std::pair<StorageServerInterface, int64_t>> stored = wait(getStoredBytes(cx));
+		state std::pair<StorageServerInterface, int64_t> victim;
+		state std::vector<AddressExclusion> excluded;
+		state int i = 0;
+		ASSERT(!stored.empty());
+
+		// Exclude a random server holding data, as long as the cluster stays fault tolerant without it
+		deterministicRandom()->randomShuffle(stored);
+		for (i = 0; i < stored.size(); i++) {
+			if (stored[i].second <= 0) {
+				continue;
+			}
+			state std::vector<AddressExclusion> candidate = { AddressExclusion(stored[i].first.address().ip,
+			                                                                   stored[i].first.address().port) };
+			bool safe = wait(checkSafeExclusions(cx, candidate));
+			if (safe) {
+				victim = stored[i];
+				excluded = candidate;
+				break;
+			}
+		}
+		if (excluded.empty()) {
+			CODE_PROBE(true, "DataMoveThroughput found no storage server that is safe to exclude");
+			TraceEvent(SevWarnAlways, "DataMoveThroughputNoSafeExclusion").detail("Servers", stored.size());
+			self->noSafeExclusion = true;
+			return Void();
+		}
+
+		TraceEvent("DataMoveThroughputExcluding")
+		    .detail("Server", victim.first.id())
+		    .detail("Address", victim.first.address())
+		    .detail("StoredBytes", victim.second);
+		state double startTime = now();
+		wait(excludeServers(cx, excluded));
+		std::set<NetworkAddress> inProgress = wait(checkForExcludingServers(cx, excluded, true));
+		ASSERT(inProgress.empty());
+		self->exclusionSeconds = now() - startTime;
+		self->exclusionBytes = victim.second;
+		TraceEvent("DataMoveThroughputExcluded")
+		    .detail("Server", victim.first.id())
+		    .detail("Seconds", self->exclusionSeconds)
+		    .detail("BytesPerSecond", self->exclusionBytes / std::max(self->exclusionSeconds, 1e-6));
+
+		wait(includeServers(cx, excluded));
+		return Void();
+	}
+
+	ACTOR static Future<Void> measureWiggleStep(Database cx, DataMoveThroughputWorkload* self) {
+		state std::vector<std::pair<StorageServerInterface, int64_t>> stored = wait(getStoredBytes(cx));
+		state Optional<StorageWiggleMetrics> before = wait(getWiggleMetrics(cx));
+		state int finishedBefore = before.present() ? before.get().finished_wiggle : 0;
+
+		wait(success(setPerpetualStorageWiggle(cx, true, LockAware::True)));
+		loop {
+			wait(delay(5.0));
+			Optional<StorageWiggleMetrics> metrics = wait(getWiggleMetrics(cx));
+			if (metrics.present() && metrics.get().finished_wiggle > finishedBefore) {
+				self->wiggleSeconds = metrics.get().last_wiggle_finish - metrics.get().last_wiggle_start;
+				break;
+			}
+		}
+		wait(success(setPerpetualStorageWiggle(cx, false, LockAware::True)));
+
+		// The wiggled server is not reported, so estimate its data as the average stored by a storage server
+		int64_t total = 0;
+		for (auto& [ssi, bytes] : stored) {
+			total += bytes;
+		}
+		self->wiggleBytes = stored.empty() ? 0 : (double)total / stored.size();
+		TraceEvent("DataMoveThroughputWiggled")
+		    .detail("Seconds", self->wiggleSeconds)
+		    .detail("BytesPerSecond", self->wiggleBytes / std::max(self->wiggleSeconds, 1e-6));
+		return Void();
+	}
+
+	ACTOR static Future<Void> _start(Database cx, DataMoveThroughputWorkload* self) {
+		// Let data distribution settle after the load, so that only the measured movements are in flight
+		wait(timeoutError(waitForNoMovingData(cx), self->maxWaitTime));
+		wait(timeoutError(measureExclusion(cx, self), self->maxWaitTime));
+		if (self->measureWiggle) {
+			wait(timeoutError(waitForNoMovingData(cx), self->maxWaitTime));
+			wait(timeoutError(measureWiggleStep(cx, self), self->maxWaitTime));
+		}
+		return Void();
+	}
+};
+
+WorkloadFactory<DataMoveThroughputWorkload> DataMoveThroughputWorkloadFactory("DataMoveThroughput");
@@ -0,0 +1,196 @@
+/*
+ * ReadHotAutoCache.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/KeyRangeMap.h"
+#include "fdbclient/NativeAPI.actor.h"
+#include "fdbclient/SystemData.h"
+#include "fdbserver/TesterInterface.actor.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Reads a small range of keys hard for hotDuration and checks that data distribution caches a range covering it, then
+// uncaches that range again once the reads have stopped.
+struct ReadHotAutoCacheWorkload : TestWorkload {
+	int actorCount, keyCount, valueBytes, hotKeyCount, hotBegin;
+	double testDuration, hotDuration, transactionsPerSecond;
+	std::vector<Future<Void>> clients;
+	KeyRange hotRange;
+	Optional<KeyRange> cachedRange;
+	bool retired;
+
+	ReadHotAutoCacheWorkload(WorkloadContext const& wcx) : TestWorkload(wcx), retired(false) {
+		testDuration = getOption(options, "testDuration"_sr, 300.0);
+		hotDuration = getOption(options, "hotDuration"_sr, 60.0);
+		transactionsPerSecond = getOption(options, "transactionsPerSecond"_sr, 2000.0) / clientCount;
+		actorCount = getOption(options, "actorsPerClient"_sr, transactionsPerSecond / 5);
+		keyCount = getOption(options, "keyCount"_sr, 2000);
+		valueBytes = getOption(options, "valueBytes"_sr, 1000);
+		hotKeyCount = getOption(options, "hotKeyCount"_sr, 20);
+		hotBegin = sharedRandomNumber % (keyCount - hotKeyCount + 1);
+		hotRange = KeyRangeRef(keyForIndex(hotBegin), keyForIndex(hotBegin + hotKeyCount));
+	}
+
+	std::string description() const override { return "ReadHotAutoCache"; }
+
+	static Key keyForIndex(int i) { return StringRef(format("readhotautocache%08x", i)); }
+
+	Future<Void> setup(Database const& cx) override { return clientId == 0 ? _setup(cx, this) : Void(); }
+
+	Future<Void> start(Database const& cx) override {
+		for (int c = 0; c < actorCount; c++) {
+			clients.push_back(
+			    timeout(keyReader(cx->clone(), this, actorCount / transactionsPerSecond), hotDuration, Void()));
+		}
+		return clientId == 0 ? timeout(_start(cx->clone(), this), testDuration, Void()) : delay(testDuration);
+	}
+
+	Future<bool> check(Database const& cx) override {
+		if (clientId != 0) {
+			return true;
+		}
+		TraceEvent(cachedRange.present() && retired ? SevInfo : SevError, "ReadHotAutoCacheResult")
+		    .detail("HotRange", hotRange)
+		    .detail("CachedRange", cachedRange.present() ? cachedRange.get() : KeyRange())
+		    .detail("Cached", cachedRange.present())
+		    .detail("Retired", retired);
+		return cachedRange.present() && retired;
+	}
+
+	void getMetrics(std::vector<PerfMetric>& m) override {}
+
+	ACTOR static Future<Void> _setup(Database cx, ReadHotAutoCacheWorkload* self) {
+		state int i = 0;
+		state int batch = 100;
+		for (i = 0; i < self->keyCount; i += batch) {
+			state Transaction tr(cx);
+			loop {
+				try {
+					for (int j = i; j < std::min(i + batch, self->keyCount); j++) {
+						tr.set(keyForIndex(j), Value(deterministicRandom()->randomAlphaNumeric(self->valueBytes)));
+					}
+					wait(tr.commit());
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+		}
+		return Void();
+	}
+
+	// Returns the auto cached range intersecting range, if it is recorded in autoCachedRangeKeys and is cached
+	ACTOR static Future<Optional<KeyRange>> getAutoCachedRange(Database cx, KeyRange range) {
+		state Transaction tr(cx);
+		loop {
+			try {
+				tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+				tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+				RangeResult records = wait(tr.getRange(autoCachedRangeKeys, CLIENT_KNOBS->TOO_MANY));
+				state Optional<KeyRange> found;
+				for (auto& r : records) {
+					KeyRange recorded = KeyRangeRef(decodeAutoCachedRangeKey(r.key), r.value);
+					if (recorded.intersects(range)) {
+						found = recorded;
+						break;
+					}
+				}
+				if (!found.present()) {
+					return found;
+				}
+				Optional<Value> boundary = wait(tr.get(storageCacheKey(found.get().begin)));
+				std::vector<uint16_t> serverIndices;
+				if (boundary.present()) {
+					decodeStorageCacheValue(boundary.get(), serverIndices);
+				}
+				return serverIndices.empty() ? Optional<KeyRange>() : found;
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+	}
+
+	// Returns whether any part of range is cached
+	ACTOR static Future<bool> isCached(Database cx, KeyRange range) {
+		state Transaction tr(cx);
+		loop {
+			try {
+				tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+				tr.setOption(FDBTransactionOptions::LOCK_AWARE);
+				RangeResult boundaries = wait(krmGetRanges(&tr, storageCachePrefix, range));
+				for (int i = 0; i < boundaries.size() - 1; i++) {
+					std::vector<uint16_t> serverIndices;
+					decodeStorageCacheValue(boundaries[i].value, serverIndices);
+					if (!serverIndices.empty()) {
+						return true;
+					}
+				}
+				return false;
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+	}
+
+	ACTOR static Future<Void> _start(Database cx, ReadHotAutoCacheWorkload* self) {
+		loop {
+			Optional<KeyRange> cachedRange = wait(getAutoCachedRange(cx, self->hotRange));
+			if (cachedRange.present()) {
+				self->cachedRange = cachedRange;
+				break;
+			}
+			wait(delay(1.0));
+		}
+		TraceEvent("ReadHotAutoCacheCached")
+		    .detail("HotRange", self->hotRange)
+		    .detail("Range", self->cachedRange.get());
+
+		// Reads stop after hotDuration, after which the range decays out of the read sample and is retired
+		loop {
+			state Optional<KeyRange> stillCached = wait(getAutoCachedRange(cx, self->cachedRange.get()));
+			bool cached = wait(isCached(cx, self->cachedRange.get()));
+			if (!stillCached.present() && !cached) {
+				self->retired = true;
+				break;
+			}
+			wait(delay(1.0));
+		}
+		TraceEvent("ReadHotAutoCacheRetired").detail("Range", self->cachedRange.get());
+		return Void();
+	}
+
+	ACTOR static Future<Void> keyReader(Database cx, ReadHotAutoCacheWorkload* self, double delay) {
+		state double lastTime = now();
+		loop {
+			wait(poisson(&lastTime, delay));
+			state Transaction tr(cx);
+			state Key key = keyForIndex(self->hotBegin + deterministicRandom()->randomInt(0, self->hotKeyCount));
+			loop {
+				try {
+					Optional<Value> v = wait(tr.get(key));
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+		}
+	}
+};
+
+WorkloadFactory<ReadHotAutoCacheWorkload> ReadHotAutoCacheWorkloadFactory("ReadHotAutoCache");
@@ -0,0 +1,206 @@
+/*
+ * ReadHotSplit.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fdbclient/KeyRangeMap.h"
+#include "fdbclient/NativeAPI.actor.h"
+#include "fdbclient/SystemData.h"
+#include "fdbserver/QuietDatabase.h"
+#include "fdbserver/TesterInterface.actor.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Concentrates reads on a small range of keys within one shard and checks that data distribution splits the shard and
+// moves the hot pieces, so that the read load across storage servers becomes less skewed.
+struct ReadHotSplitWorkload : TestWorkload {
+	int actorCount, keyCount, valueBytes, hotKeyCount, hotBegin;
+	double testDuration, transactionsPerSecond, hotFraction, warmupTime, skewTolerance;
+	std::vector<Future<Void>> clients;
+	Future<Void> splitCheck;
+	KeyRange hotRange;
+	KeyRange initialShard;
+	int finalShards;
+	double initialSkew, finalSkew;
+	bool passed;
+
+	ReadHotSplitWorkload(WorkloadContext const& wcx)
+	  : TestWorkload(wcx), finalShards(0), initialSkew(0), finalSkew(0), passed(false) {
+		testDuration = getOption(options, "testDuration"_sr, 120.0);
+		transactionsPerSecond = getOption(options, "transactionsPerSecond"_sr, 1000.0) / clientCount;
+		actorCount = getOption(options, "actorsPerClient"_sr, transactionsPerSecond / 5);
+		keyCount = getOption(options, "keyCount"_sr, 2000);
+		valueBytes = getOption(options, "valueBytes"_sr, 1000);
+		hotKeyCount = getOption(options, "hotKeyCount"_sr, 20);
+		hotFraction = getOption(options, "hotFraction"_sr, 0.9);
+		warmupTime = getOption(options, "warmupTime"_sr, 10.0);
+		skewTolerance = getOption(options, "skewTolerance"_sr, 0.1);
+		// Use the same hot range on every client. It is spread over several keys, since no split can spread the
+		// load of a single key.
+		hotBegin = sharedRandomNumber % (keyCount - hotKeyCount + 1);
+		hotRange = KeyRangeRef(keyForIndex(hotBegin), keyForIndex(hotBegin + hotKeyCount));
+	}
+
+	std::string description() const override { return "ReadHotSplit"; }
+
+	static Key keyForIndex(int i) { return StringRef(format("readhotsplit%08x", i)); }
+
+	Future<Void> setup(Database const& cx) override { return clientId == 0 ? _setup(cx, this) : Void(); }
+
+	Future<Void> start(Database const& cx) override {
+		for (int c = 0; c < actorCount; c++) {
+			clients.push_back(
+			    timeout(keyReader(cx->clone(), this, actorCount / transactionsPerSecond), testDuration, Void()));
+		}
+		splitCheck = clientId == 0 ? _check(cx->clone(), this) : Void();
+		return delay(testDuration);
+	}
+
+	Future<bool> check(Database const& cx) override { return clientId != 0 || passed; }
+
+	void getMetrics(std::vector<PerfMetric>& m) override {
+		if (clientId == 0) {
+			m.emplace_back("Initial Read Skew", initialSkew, Averaged::False);
+			m.emplace_back("Final Read Skew", finalSkew, Averaged::False);
+			m.emplace_back("Final Shards", finalShards, Averaged::False);
+		}
+	}
+
+	ACTOR static Future<Void> _setup(Database cx, ReadHotSplitWorkload* self) {
+		state int i = 0;
+		state int batch = 100;
+		for (i = 0; i < self->keyCount; i += batch) {
+			state Transaction tr(cx);
+			loop {
+				try {
+					for (int j = i; j < std::min(i + batch, self->keyCount); j++) {
+						tr.set(keyForIndex(j), Value(deterministicRandom()->randomAlphaNumeric(self->valueBytes)));
+					}
+					wait(tr.commit());
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+		}
+		// The shard is captured before any read load, since data distribution may split it during the warmup
+		KeyRange initialShard = wait(getShard(cx, self->hotRange.begin));
+		self->initialShard = initialShard;
+		return Void();
+	}
+
+	// Returns the shard currently containing key
+	ACTOR static Future<KeyRange> getShard(Database cx, Key key) {
+		state Transaction tr(cx);
+		loop {
+			try {
+				tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+				RangeResult shards = wait(krmGetRanges(&tr, keyServersPrefix, KeyRangeRef(key, keyAfter(key)), 2));
+				ASSERT(shards.size() >= 2);
+				return KeyRange(KeyRangeRef(shards[0].key, shards[1].key));
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+	}
+
+	// Returns the number of shards that range is now split into
+	ACTOR static Future<int> getShardCount(Database cx, KeyRange range) {
+		state Transaction tr(cx);
+		loop {
+			try {
+				tr.setOption(FDBTransactionOptions::READ_SYSTEM_KEYS);
+				RangeResult shards =
+				    wait(krmGetRanges(&tr, keyServersPrefix, range, CLIENT_KNOBS->TOO_MANY, CLIENT_KNOBS->TOO_MANY));
+				ASSERT(shards.size() >= 2);
+				return shards.size() - 1;
+			} catch (Error& e) {
+				wait(tr.onError(e));
+			}
+		}
+	}
+
+	// Returns the ratio of the highest to the average read bandwidth of the storage servers
+	ACTOR static Future<double> getReadSkew(Database cx) {
+		state std::vector<StorageServerInterface> servers = wait(getStorageServers(cx));
+		state std::vector<Future<ErrorOr<GetStorageMetricsReply>>> replies;
+		for (auto& ssi : servers) {
+			replies.push_back(ssi.getStorageMetrics.tryGetReply(GetStorageMetricsRequest()));
+		}
+		wait(waitForAll(replies));
+
+		int64_t total = 0, maxRead = 0;
+		int count = 0;
+		for (auto& reply : replies) {
+			if (reply.get().present()) {
+				int64_t read = reply.get().get().load.bytesReadPerKSecond;
+				total += read;
+				maxRead = std::max(maxRead, read);
+				count++;
+			}
+		}
+		return total > 0 ? (double)maxRead * count / total : 1.0;
+	}
+
+	ACTOR static Future<Void> _check(Database cx, ReadHotSplitWorkload* self) {
+		wait(delay(self->warmupTime));
+		double initialSkew = wait(getReadSkew(cx));
+		self->initialSkew = initialSkew;
+
+		// Measure again shortly before the readers stop
+		wait(delay(std::max(0.0, self->testDuration - self->warmupTime - 5.0)));
+		int finalShards = wait(getShardCount(cx, self->initialShard));
+		double finalSkew = wait(getReadSkew(cx));
+		self->finalShards = finalShards;
+		self->finalSkew = finalSkew;
+
+		bool split = self->finalShards > 1;
+		bool converged = self->finalSkew < self->initialSkew - self->skewTolerance;
+		self->passed = split && converged;
+
+		TraceEvent(self->passed ? SevInfo : SevError, "ReadHotSplitResult")
+		    .detail("HotRange", self->hotRange)
+		    .detail("InitialShard", self->initialShard)
+		    .detail("FinalShards", self->finalShards)
+		    .detail("InitialReadSkew", self->initialSkew)
+		    .detail("FinalReadSkew", self->finalSkew);
+		return Void();
+	}
+
+	ACTOR static Future<Void> keyReader(Database cx, ReadHotSplitWorkload* self, double delay) {
+		state double lastTime = now();
+		loop {
+			wait(poisson(&lastTime, delay));
+			state Transaction tr(cx);
+			state Key key =
+			    keyForIndex(deterministicRandom()->random01() < self->hotFraction
+			                    ? self->hotBegin + deterministicRandom()->randomInt(0, self->hotKeyCount)
+			                    : deterministicRandom()->randomInt(0, self->keyCount));
+			loop {
+				try {
+					Optional<Value> v = wait(tr.get(key));
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+		}
+	}
+};
+
+WorkloadFactory<ReadHotSplitWorkload> ReadHotSplitWorkloadFactory("ReadHotSplit");
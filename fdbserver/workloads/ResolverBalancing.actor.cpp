@@ -0,0 +1,159 @@
+/*
+ * ResolverBalancing.actor.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <numeric>
+
+#include "fdbclient/NativeAPI.actor.h"
+#include "fdbserver/ResolverInterface.h"
+#include "fdbserver/ServerDBInfo.h"
+#include "fdbserver/TesterInterface.actor.h"
+#include "fdbserver/workloads/workloads.actor.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+// Writes mostly to a contiguous range of keys, which all start out on one resolver, and follows how unevenly the
+// resolvers share the conflict ranges over consecutive windows. Resolution balancing must bring the average imbalance
+// of the last windows down to maxFinalImbalance. The first window is fully imbalanced (2.0 with two resolvers), and
+// the default of 0.3 only allows splits of two resolvers up to about 57/43.
+struct ResolverBalancingWorkload : TestWorkload {
+	int actorCount, keyCount, hotKeyCount, hotBegin, finalWindows;
+	double testDuration, transactionsPerSecond, hotFraction, windowTime, maxFinalImbalance;
+	std::vector<Future<Void>> writers;
+	Future<Void> monitor;
+	// The imbalance of every window: the difference between the most and the least conflict ranges any resolver
+	// checked, relative to the mean
+	std::vector<double> imbalances;
+	bool resolversChanged = false;
+
+	ResolverBalancingWorkload(WorkloadContext const& wcx) : TestWorkload(wcx) {
+		testDuration = getOption(options, "testDuration"_sr, 60.0);
+		transactionsPerSecond = getOption(options, "transactionsPerSecond"_sr, 1000.0) / clientCount;
+		actorCount = getOption(options, "actorsPerClient"_sr, transactionsPerSecond / 5);
+		keyCount = getOption(options, "keyCount"_sr, 10000);
+		hotKeyCount = getOption(options, "hotKeyCount"_sr, 1000);
+		hotFraction = getOption(options, "hotFraction"_sr, 0.8);
+		windowTime = getOption(options, "windowTime"_sr, 1.0);
+		finalWindows = getOption(options, "finalWindows"_sr, 5);
+		maxFinalImbalance = getOption(options, "maxFinalImbalance"_sr, 0.3);
+		hotBegin = sharedRandomNumber % (keyCount - hotKeyCount + 1);
+	}
+
+	std::string description() const override { return "ResolverBalancing"; }
+
+	Future<Void> setup(Database const& cx) override { return Void(); }
+
+	Future<Void> start(Database const& cx) override {
+		for (int c = 0; c < actorCount; c++) {
+			writers.push_back(
+			    timeout(writer(cx->clone(), this, actorCount / transactionsPerSecond), testDuration, Void()));
+		}
+		monitor = clientId == 0 ? timeout(monitorImbalance(this), testDuration, Void()) : Void();
+		return delay(testDuration);
+	}
+
+	double initialImbalance() const { return imbalances.front(); }
+
+	double finalImbalance() const {
+		int windows = std::min<int>(finalWindows, imbalances.size());
+		return std::accumulate(imbalances.end() - windows, imbalances.end(), 0.0) / windows;
+	}
+
+	Future<bool> check(Database const& cx) override {
+		if (clientId != 0) {
+			return true;
+		}
+		// A recovery replaces the resolvers and resets their key ranges, so such a run shows nothing about balancing
+		bool measured = !resolversChanged && (int)imbalances.size() > finalWindows;
+		bool converged = measured && finalImbalance() <= maxFinalImbalance;
+		TraceEvent(converged ? SevInfo : SevError, "ResolverBalancingResult")
+		    .detail("ResolversChanged", resolversChanged)
+		    .detail("Windows", imbalances.size())
+		    .detail("InitialImbalance", imbalances.empty() ? 0.0 : initialImbalance())
+		    .detail("FinalImbalance", imbalances.empty() ? 0.0 : finalImbalance())
+		    .detail("MaxFinalImbalance", maxFinalImbalance);
+		return converged;
+	}
+
+	void getMetrics(std::vector<PerfMetric>& m) override {
+		if (clientId == 0 && !imbalances.empty()) {
+			m.emplace_back("Initial Resolver Imbalance", initialImbalance(), Averaged::False);
+			m.emplace_back("Final Resolver Imbalance", finalImbalance(), Averaged::False);
+		}
+	}
+
+	ACTOR static Future<std::vector<int64_t>> getConflictRanges(std::vector<ResolverInterface> resolvers) {
+		state std::vector<Future<ResolutionMetricsReply>> replies;
+		for (auto& r : resolvers) {
+			replies.push_back(r.metrics.getReply(ResolutionMetricsRequest()));
+		}
+		wait(waitForAll(replies));
+		std::vector<int64_t> conflictRanges;
+		for (auto& reply : replies) {
+			conflictRanges.push_back(reply.get().conflictRanges);
+		}
+		return conflictRanges;
+	}
+
+	ACTOR static Future<Void> monitorImbalance(ResolverBalancingWorkload* self) {
+		state std::vector<ResolverInterface> resolvers = self->dbInfo->get().resolvers;
+		state std::vector<int64_t> last = wait(getConflictRanges(resolvers));
+		loop {
+			wait(delay(self->windowTime) || self->dbInfo->onChange());
+			if (self->dbInfo->get().resolvers != resolvers) {
+				self->resolversChanged = true;
+				return Void();
+			}
+			std::vector<int64_t> current = wait(getConflictRanges(resolvers));
+			std::vector<int64_t> window;
+			for (int i = 0; i < current.size(); i++) {
+				window.push_back(current[i] - last[i]);
+			}
+			last = current;
+			double mean = std::accumulate(window.begin(), window.end(), 0.0) / window.size();
+			if (mean > 0) {
+				auto [least, most] = std::minmax_element(window.begin(), window.end());
+				self->imbalances.push_back((*most - *least) / mean);
+			}
+		}
+	}
+
+	ACTOR static Future<Void> writer(Database cx, ResolverBalancingWorkload* self, double delay) {
+		state double lastTime = now();
+		loop {
+			wait(poisson(&lastTime, delay));
+			state Transaction tr(cx);
+			state int index = deterministicRandom()->random01() < self->hotFraction
+			                      ? self->hotBegin + deterministicRandom()->randomInt(0, self->hotKeyCount)
+			                      : deterministicRandom()->randomInt(0, self->keyCount);
+			state Key key = StringRef(format("resolverbalancing%08x", index));
+			loop {
+				try {
+					Optional<Value> v = wait(tr.get(key));
+					tr.set(key, v.present() ? v.get() : "0"_sr);
+					wait(tr.commit());
+					break;
+				} catch (Error& e) {
+					wait(tr.onError(e));
+				}
+			}
+		}
+	}
+};
+
+WorkloadFactory<ResolverBalancingWorkload> ResolverBalancingWorkloadFactory("ResolverBalancing");
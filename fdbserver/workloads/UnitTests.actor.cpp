@@ -23,6 +23,7 @@
 #include "flow/actorcompiler.h" // has to be last include
 
 void forceLinkIndexedSetTests();
+void forceLinkIndexedBTreeTests();
 void forceLinkDequeTests();
 void forceLinkFlowTests();
 void forceLinkVersionedMapTests();
@@ -75,6 +76,7 @@ struct UnitTestWorkload : TestWorkload {
 		}
 
 		forceLinkIndexedSetTests();
+		forceLinkIndexedBTreeTests();
 		forceLinkDequeTests();
 		forceLinkFlowTests();
 		forceLinkVersionedMapTests();
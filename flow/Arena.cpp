@@ -22,6 +22,8 @@
 
 #include "flow/UnitTest.h"
 
+#include <cmath>
+
 // We don't align memory properly, and we need to tell lsan about that.
 extern "C" const char* __lsan_default_options(void) {
 	return "use_unaligned=1";
@@ -102,8 +104,82 @@ void makeNoAccess(void*, size_t) {}
 void makeDefined(void*, size_t) {}
 void makeUndefined(void*, size_t) {}
 #endif
+
+// Blocks of 512 to 8192 bytes are allocated with new rather than a FastAllocator, so each thread keeps a few of each
+// size that it released to hand out again. The cache is trivially destructible so that blocks can still be released
+// while the thread exits, which leaks the blocks it holds then.
+#if defined(ADDRESS_SANITIZER) || VALGRIND
+constexpr int recycledBlocksPerSize = 0;
+#else
+constexpr int recycledBlocksPerSize = 16;
+#endif
+constexpr int recycledBlockSizes = 5; // 512, 1024, 2048, 4096 and 8192
+
+struct RecycledArenaBlocks {
+	uint8_t* blocks[recycledBlockSizes][std::max(recycledBlocksPerSize, 1)];
+	int count[recycledBlockSizes];
+};
+
+thread_local RecycledArenaBlocks recycledArenaBlocks;
+thread_local ArenaBlockCounts arenaBlockCounts;
+
+int recycledBlockIndex(int size) {
+	int index = 0;
+	while ((512 << index) < size) {
+		++index;
+	}
+	return index;
+}
+
+ArenaBlock* newRecycledBlock(int size) {
+	RecycledArenaBlocks& recycled = recycledArenaBlocks;
+	int index = recycledBlockIndex(size);
+	if (recycled.count[index] > 0) {
+		++arenaBlockCounts.recycled;
+		return (ArenaBlock*)recycled.blocks[index][--recycled.count[index]];
+	}
+	return (ArenaBlock*)new uint8_t[size];
+}
+
+void deleteRecycledBlock(ArenaBlock* b, int size) {
+	RecycledArenaBlocks& recycled = recycledArenaBlocks;
+	int index = recycledBlockIndex(size);
+	if (recycled.count[index] < recycledBlocksPerSize) {
+		recycled.blocks[index][recycled.count[index]++] = reinterpret_cast<uint8_t*>(b);
+	} else {
+		delete[] reinterpret_cast<uint8_t*>(b);
+	}
+}
 } // namespace
 
+ArenaBlockCounts getArenaBlockCounts() {
+	return arenaBlockCounts;
+}
+
+namespace {
+// Size hints adapt to a change of size within a few dozen arenas
+constexpr double sizeHintWeight = 1.0 / 16;
+constexpr size_t maxSizeHint = 1 << 17;
+} // namespace
+
+size_t ArenaSizeHint::reservedSize() const {
+	if (!recorded) {
+		return 0;
+	}
+	return std::min<size_t>(maxSizeHint, std::ceil(average + 2 * deviation));
+}
+
+void ArenaSizeHint::record(size_t size) {
+	if (!recorded) {
+		recorded = true;
+		average = size;
+		return;
+	}
+	double error = size - average;
+	average += sizeHintWeight * error;
+	deviation += sizeHintWeight * (std::abs(error) - deviation);
+}
+
 Arena::Arena() : impl(nullptr) {}
 Arena::Arena(size_t reservedSize) : impl(0) {
 	UNSTOPPABLE_ASSERT(reservedSize < std::numeric_limits<int>::max());
@@ -330,6 +406,7 @@ void* ArenaBlock::allocate(Reference<ArenaBlock>& self, int bytes) {
 // Return an appropriately-sized ArenaBlock to store the given data
 ArenaBlock* ArenaBlock::create(int dataSize, Reference<ArenaBlock>& next) {
 	ArenaBlock* b;
+	++arenaBlockCounts.created;
 	if (dataSize <= SMALL - TINY_HEADER && !next) {
 		static_assert(sizeof(ArenaBlock) <= 32); // Need to allocate at least sizeof(ArenaBlock) for an ArenaBlock*. See
 		                                         // https://github.com/apple/foundationdb/issues/6753
@@ -367,26 +444,30 @@ ArenaBlock* ArenaBlock::create(int dataSize, Reference<ArenaBlock>& next) {
 				b->bigSize = 256;
 				INSTRUMENT_ALLOCATE("Arena256");
 			} else if (reqSize <= 512) {
-				b = (ArenaBlock*)new uint8_t[512];
+				b = newRecycledBlock(512);
 				b->bigSize = 512;
 				INSTRUMENT_ALLOCATE("Arena512");
 			} else if (reqSize <= 1024) {
-				b = (ArenaBlock*)new uint8_t[1024];
+				b = newRecycledBlock(1024);
 				b->bigSize = 1024;
 				INSTRUMENT_ALLOCATE("Arena1024");
 			} else if (reqSize <= 2048) {
-				b = (ArenaBlock*)new uint8_t[2048];
+				b = newRecycledBlock(2048);
 				b->bigSize = 2048;
 				INSTRUMENT_ALLOCATE("Arena2048");
 			} else if (reqSize <= 4096) {
-				b = (ArenaBlock*)new uint8_t[4096];
+				b = newRecycledBlock(4096);
 				b->bigSize = 4096;
 				INSTRUMENT_ALLOCATE("Arena4096");
 			} else {
-				b = (ArenaBlock*)new uint8_t[8192];
+				b = newRecycledBlock(8192);
 				b->bigSize = 8192;
 				INSTRUMENT_ALLOCATE("Arena8192");
 			}
+			if (b->bigSize > 256) {
+				// Smaller blocks are sampled by FastAllocator
+				HeapProfiler::allocated(b, b->bigSize);
+			}
 			b->totalSizeEstimate = b->bigSize;
 			b->tinySize = b->tinyUsed = NOT_TINY;
 			b->bigUsed = sizeof(ArenaBlock);
@@ -395,6 +476,7 @@ ArenaBlock* ArenaBlock::create(int dataSize, Reference<ArenaBlock>& next) {
 			allocInstr["ArenaHugeKB"].alloc((reqSize + 1023) >> 10);
 #endif
 			b = (ArenaBlock*)new uint8_t[reqSize];
+			HeapProfiler::allocated(b, reqSize);
 			b->tinySize = b->tinyUsed = NOT_TINY;
 			b->bigSize = reqSize;
 			b->totalSizeEstimate = b->bigSize;
@@ -475,6 +557,9 @@ void ArenaBlock::destroyLeaf() {
 			INSTRUMENT_RELEASE("Arena64");
 		}
 	} else {
+		if (bigSize > 256) {
+			HeapProfiler::released(this);
+		}
 		if (bigSize <= 128) {
 			FastAllocator<128>::release(this);
 			INSTRUMENT_RELEASE("Arena128");
@@ -482,19 +567,19 @@ void ArenaBlock::destroyLeaf() {
 			FastAllocator<256>::release(this);
 			INSTRUMENT_RELEASE("Arena256");
 		} else if (bigSize <= 512) {
-			delete[] reinterpret_cast<uint8_t*>(this);
+			deleteRecycledBlock(this, bigSize);
 			INSTRUMENT_RELEASE("Arena512");
 		} else if (bigSize <= 1024) {
-			delete[] reinterpret_cast<uint8_t*>(this);
+			deleteRecycledBlock(this, bigSize);
 			INSTRUMENT_RELEASE("Arena1024");
 		} else if (bigSize <= 2048) {
-			delete[] reinterpret_cast<uint8_t*>(this);
+			deleteRecycledBlock(this, bigSize);
 			INSTRUMENT_RELEASE("Arena2048");
 		} else if (bigSize <= 4096) {
-			delete[] reinterpret_cast<uint8_t*>(this);
+			deleteRecycledBlock(this, bigSize);
 			INSTRUMENT_RELEASE("Arena4096");
 		} else if (bigSize <= 8192) {
-			delete[] reinterpret_cast<uint8_t*>(this);
+			deleteRecycledBlock(this, bigSize);
 			INSTRUMENT_RELEASE("Arena8192");
 		} else {
 #ifdef ALLOC_INSTRUMENTATION
@@ -775,6 +860,38 @@ TEST_CASE("/flow/Arena/Size") {
 	return Void();
 }
 
+TEST_CASE("/flow/Arena/SizeHint") {
+	ArenaSizeHint hint;
+	ASSERT_EQ(hint.reservedSize(), 0);
+	for (int i = 0; i < 100; i++) {
+		hint.record(1000);
+	}
+	ASSERT_EQ(hint.reservedSize(), 1000);
+
+	// Varying sizes reserve room for most of them
+	for (int i = 0; i < 100; i++) {
+		hint.record(i % 2 ? 1000 : 3000);
+	}
+	ASSERT(hint.reservedSize() > 3000 && hint.reservedSize() < 5000);
+
+	for (int i = 0; i < 100; i++) {
+		hint.record(1 << 30);
+	}
+	ASSERT_EQ(hint.reservedSize(), 1 << 17);
+	return Void();
+}
+
+TEST_CASE("/flow/Arena/RecycledBlocks") {
+	// A released block of 512 to 8192 bytes is handed out again by the same thread, unless recycling is compiled out
+	{ Arena a(1000); }
+	ArenaBlockCounts before = getArenaBlockCounts();
+	{ Arena a(1000); }
+	ArenaBlockCounts after = getArenaBlockCounts();
+	ASSERT_EQ(after.created - before.created, 1);
+	ASSERT_EQ(after.recycled - before.recycled, recycledBlocksPerSize > 0 ? 1 : 0);
+	return Void();
+}
+
 TEST_CASE("flow/StringRef/eat") {
 	StringRef str = "test/case"_sr;
 	StringRef first = str.eat("/");
@@ -49,6 +49,15 @@
 
 #define FAST_ALLOCATOR_DEBUG 0
 
+// Whether FastAllocator::trim() can return memory to the OS. Debug and instrumented builds don't pool memory, or keep
+// redundant freelist pointers that trim() doesn't maintain.
+#if defined(__linux__) && !FAST_ALLOCATOR_DEBUG && !defined(USE_GPERFTOOLS) && !defined(ADDRESS_SANITIZER) &&          \
+    !defined(VALGRIND)
+#define FAST_ALLOCATOR_CAN_TRIM 1
+#else
+#define FAST_ALLOCATOR_CAN_TRIM 0
+#endif
+
 #ifdef _MSC_VER
 // warning 4073 warns about "initializers put in library initialization area", which is our intent
 #pragma warning(disable : 4073)
@@ -248,7 +257,14 @@ struct FastAllocator<Size>::GlobalData {
 	std::atomic<long long> totalMemory;
 	long long partialMagazineUnallocatedMemory;
 	std::atomic<long long> activeThreads;
-	GlobalData() : totalMemory(0), partialMagazineUnallocatedMemory(0), activeThreads(0) {
+	std::vector<void*> blocks; // Every block allocated by getMagazine(), including the released ones
+	std::vector<void*> releasedBlocks; // Blocks returned to the OS by trim(), which getMagazine() reuses first
+	std::atomic<long long> releasedMemory;
+	// The fewest magazines in the pool since the last trim(). Magazines are taken from and returned to the back of the
+	// pool, so the first idleMagazines magazines have not been used since then.
+	size_t idleMagazines;
+	GlobalData()
+	  : totalMemory(0), partialMagazineUnallocatedMemory(0), activeThreads(0), releasedMemory(0), idleMagazines(0) {
 		InitializeCriticalSection(&mutex);
 	}
 };
@@ -273,6 +289,94 @@ long long FastAllocator<Size>::getActiveThreads() {
 	return globalData()->activeThreads.load();
 }
 
+template <int Size>
+long long FastAllocator<Size>::getReleasedMemory() {
+	return globalData()->releasedMemory.load();
+}
+
+template <int Size>
+long long FastAllocator<Size>::trim(int maxItems) {
+#if FAST_ALLOCATOR_CAN_TRIM
+	GlobalData* data = globalData();
+	EnterCriticalSection(&data->mutex);
+	size_t idle = std::min<size_t>({ data->idleMagazines,
+	                                 data->magazines.size(),
+	                                 static_cast<size_t>(std::max(maxItems / magazine_size, 1)) });
+	std::vector<void*> magazines(data->magazines.begin(), data->magazines.begin() + idle);
+	data->magazines.erase(data->magazines.begin(), data->magazines.begin() + idle);
+	std::vector<void*> blocks = data->blocks;
+	LeaveCriticalSection(&data->mutex);
+	ASSERT(magazines.empty() || blocks.size());
+
+	// Count the free items of each block. A block is free once all of its items are in the idle magazines.
+	std::vector<void*> items;
+	items.reserve(magazines.size() * magazine_size);
+	for (void* magazine : magazines) {
+		for (void* p = magazine; p; p = *(void**)p) {
+			items.push_back(p);
+		}
+	}
+	std::sort(items.begin(), items.end());
+	std::sort(blocks.begin(), blocks.end());
+	std::vector<int> freeItems(blocks.size(), 0);
+	size_t block = 0;
+	for (void* p : items) {
+		while (block + 1 < blocks.size() && blocks[block + 1] <= p) {
+			++block;
+		}
+		++freeItems[block];
+	}
+
+	std::vector<void*> released;
+	for (int i = 0; i < blocks.size(); i++) {
+		if (freeItems[i] == magazine_size) {
+			// The pages read as zeros when the block is reused, and the mapping (with its guard pages) is kept
+			madvise(blocks[i], magazine_size * Size, MADV_DONTNEED);
+			released.push_back(blocks[i]);
+		}
+	}
+
+	// Refill the magazines with the remaining items in address order, so that items of the same block tend to be
+	// allocated and freed together and more blocks become free. The released items are a whole number of magazines.
+	std::vector<void*> refilled;
+	void** last = nullptr;
+	int count = 0;
+	block = 0;
+	for (void* p : items) {
+		while (block + 1 < blocks.size() && blocks[block + 1] <= p) {
+			++block;
+		}
+		if (freeItems[block] == magazine_size) {
+			continue;
+		}
+		if (count == 0) {
+			refilled.push_back(p);
+		} else {
+			*last = p;
+		}
+		last = (void**)p;
+		if (++count == magazine_size) {
+			*last = nullptr;
+			count = 0;
+		}
+	}
+	ASSERT(count == 0);
+
+	long long releasedBytes = (long long)released.size() * magazine_size * Size;
+	EnterCriticalSection(&data->mutex);
+	// The refilled magazines stay at the front of the pool, where they are used last
+	data->magazines.insert(data->magazines.begin(), refilled.begin(), refilled.end());
+	data->releasedBlocks.insert(data->releasedBlocks.end(), released.begin(), released.end());
+	data->totalMemory.fetch_sub(releasedBytes);
+	data->releasedMemory.fetch_add(releasedBytes);
+	data->idleMagazines = data->magazines.size();
+	LeaveCriticalSection(&data->mutex);
+	return releasedBytes;
+#else
+	return 0;
+#endif
+}
+
 #if FAST_ALLOCATOR_DEBUG
 static int64_t getSizeCode(int i) {
 	switch (i) {
@@ -354,6 +458,7 @@ void* FastAllocator<Size>::allocate() {
 #if defined(ALLOC_INSTRUMENTATION) || defined(ALLOC_INSTRUMENTATION_STDOUT)
 	recordAllocation(p, Size);
 #endif
+	HeapProfiler::allocated(p, Size);
 	return p;
 }
 
@@ -400,6 +505,7 @@ void FastAllocator<Size>::release(void* ptr) {
 #if defined(ALLOC_INSTRUMENTATION) || defined(ALLOC_INSTRUMENTATION_STDOUT)
 	recordDeallocation(ptr);
 #endif
+	HeapProfiler::released(ptr);
 }
 
 template <int Size>
@@ -460,30 +566,7 @@ FastAllocator<Size>::ThreadData::ThreadData() {
 }
 
 template <int Size>
-void FastAllocator<Size>::getMagazine() {
-	ThreadData& thr = threadData();
-	ASSERT(!thr.freelist && !thr.alternate && thr.count == 0);
-
-	EnterCriticalSection(&globalData()->mutex);
-	if (globalData()->magazines.size()) {
-		void* m = globalData()->magazines.back();
-		globalData()->magazines.pop_back();
-		LeaveCriticalSection(&globalData()->mutex);
-		thr.freelist = m;
-		thr.count = magazine_size;
-		return;
-	} else if (globalData()->partial_magazines.size()) {
-		std::pair<int, void*> p = globalData()->partial_magazines.back();
-		globalData()->partial_magazines.pop_back();
-		globalData()->partialMagazineUnallocatedMemory -= p.first * Size;
-		LeaveCriticalSection(&globalData()->mutex);
-		thr.freelist = p.second;
-		thr.count = p.first;
-		return;
-	}
-	globalData()->totalMemory.fetch_add(magazine_size * Size);
-	LeaveCriticalSection(&globalData()->mutex);
-
+void** FastAllocator<Size>::allocateBlock() {
 // Allocate a new page of data from the system allocator
 #ifdef ALLOC_INSTRUMENTATION
 	interlockedIncrement(&pageCount);
@@ -527,6 +610,51 @@ void FastAllocator<Size>::getMagazine() {
 	block = (void**)::allocate(magazine_size * Size, /*allowLargePages*/ false, includeGuardPages);
 #endif
 
+#if FAST_ALLOCATOR_CAN_TRIM
+	EnterCriticalSection(&globalData()->mutex);
+	globalData()->blocks.push_back(block);
+	LeaveCriticalSection(&globalData()->mutex);
+#endif
+	return block;
+}
+
+template <int Size>
+void FastAllocator<Size>::getMagazine() {
+	ThreadData& thr = threadData();
+	ASSERT(!thr.freelist && !thr.alternate && thr.count == 0);
+
+	EnterCriticalSection(&globalData()->mutex);
+	if (globalData()->magazines.size()) {
+		void* m = globalData()->magazines.back();
+		globalData()->magazines.pop_back();
+		globalData()->idleMagazines = std::min(globalData()->idleMagazines, globalData()->magazines.size());
+		LeaveCriticalSection(&globalData()->mutex);
+		thr.freelist = m;
+		thr.count = magazine_size;
+		return;
+	} else if (globalData()->partial_magazines.size()) {
+		std::pair<int, void*> p = globalData()->partial_magazines.back();
+		globalData()->partial_magazines.pop_back();
+		globalData()->partialMagazineUnallocatedMemory -= p.first * Size;
+		LeaveCriticalSection(&globalData()->mutex);
+		thr.freelist = p.second;
+		thr.count = p.first;
+		return;
+	}
+	globalData()->totalMemory.fetch_add(magazine_size * Size);
+	// Reuse a block released by trim() before asking the OS for a new one
+	void** block = nullptr;
+	if (globalData()->releasedBlocks.size()) {
+		block = (void**)globalData()->releasedBlocks.back();
+		globalData()->releasedBlocks.pop_back();
+		globalData()->releasedMemory.fetch_sub(magazine_size * Size);
+	}
+	LeaveCriticalSection(&globalData()->mutex);
+
+	if (!block) {
+		block = allocateBlock();
+	}
+
 	// void** block = new void*[ magazine_size * PSize ];
 	for (int i = 0; i < magazine_size - 1; i++) {
 		block[i * PSize + 1] = block[i * PSize] = &block[(i + 1) * PSize];
@@ -582,6 +710,27 @@ int64_t getTotalUnusedAllocatedMemory() {
 	return unusedMemory;
 }
 
+int64_t trimFastAllocators() {
+	int maxItems = FLOW_KNOBS->FAST_ALLOC_TRIM_MAX_ITEMS;
+	int64_t released = 0;
+	released += FastAllocator<16>::trim(maxItems);
+	released += FastAllocator<32>::trim(maxItems);
+	released += FastAllocator<64>::trim(maxItems);
+	released += FastAllocator<96>::trim(maxItems);
+	released += FastAllocator<128>::trim(maxItems);
+	released += FastAllocator<256>::trim(maxItems);
+	released += FastAllocator<512>::trim(maxItems);
+	released += FastAllocator<1024>::trim(maxItems);
+	released += FastAllocator<2048>::trim(maxItems);
+	released += FastAllocator<4096>::trim(maxItems);
+	released += FastAllocator<8192>::trim(maxItems);
+	released += FastAllocator<16384>::trim(maxItems);
+	if (released > 0) {
+		TraceEvent("FastAllocatorTrimmed").detail("ReleasedBytes", released);
+	}
+	return released;
+}
+
 template class FastAllocator<16>;
 template class FastAllocator<32>;
 template class FastAllocator<64>;
@@ -620,4 +769,41 @@ TEST_CASE("/jemalloc/4k_aligned_usable_size") {
 	}
 	return Void();
 }
-#endif
\ No newline at end of file
+#endif
+
+TEST_CASE("/flow/FastAllocator/trim") {
+	using Allocator = FastAllocator<2048>;
+	const int magazineSize = kFastAllocMagazineBytes / 2048;
+	long long retained = Allocator::getTotalMemory() + Allocator::getReleasedMemory();
+
+	// Use up the pool, so that at least a few blocks are allocated for this test alone
+	std::vector<void*> items(Allocator::getApproximateMemoryUnused() / 2048 + 8 * magazineSize);
+	for (auto& p : items) {
+		p = Allocator::allocate();
+		memset(p, 1, 2048);
+	}
+	// Free the items of the newest blocks first, so that they fill magazines that go to the global pool
+	for (auto p = items.rbegin(); p != items.rend(); ++p) {
+		Allocator::release(*p);
+	}
+
+	// The first trim only finds the magazines that are idle from now on
+	Allocator::trim(std::numeric_limits<int>::max());
+	long long released = Allocator::trim(std::numeric_limits<int>::max());
+	ASSERT(Allocator::getTotalMemory() + Allocator::getReleasedMemory() >= retained);
+	if (FAST_ALLOCATOR_CAN_TRIM) {
+		ASSERT(released > 0 && Allocator::getReleasedMemory() >= released);
+	} else {
+		ASSERT(released == 0);
+	}
+
+	// Released blocks are reused
+	for (auto& p : items) {
+		p = Allocator::allocate();
+		memset(p, 2, 2048);
+	}
+	for (auto p : items) {
+		Allocator::release(p);
+	}
+	return Void();
+}
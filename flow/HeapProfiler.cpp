@@ -0,0 +1,297 @@
+/*
+ * HeapProfiler.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+#include "crc32/crc32c.h"
+#include "flow/HeapProfiler.h"
+#include "flow/SlowTaskProfiler.h"
+#include "flow/ThreadPrimitives.h"
+#include "flow/flow.h"
+#include "flow/Knobs.h"
+#include "flow/Platform.h"
+#include "flow/Trace.h"
+#include "flow/UnitTest.h"
+
+std::atomic<bool> HeapProfiler::enabled(false);
+
+namespace {
+
+constexpr int maxFrames = 64;
+constexpr int filterBits = 1 << 20;
+
+struct LiveSample {
+	std::pair<uint32_t, const char*> site;
+	double bytes;
+	double allocations;
+};
+
+struct SiteData {
+	std::vector<void*> frames;
+	double liveBytes = 0;
+	double liveAllocations = 0;
+	int64_t samples = 0;
+};
+
+struct HeapProfilerState {
+	ThreadSpinLock lock;
+	std::atomic<int64_t> sampleBytes = 1;
+	std::unordered_map<void*, LiveSample> live;
+	std::map<std::pair<uint32_t, const char*>, SiteData> sites;
+	// A bit for every address that may have been sampled, so that most releases are filtered out without the lock.
+	// Bits are only cleared when the profiler is enabled again.
+	std::atomic<uint64_t> filter[filterBits / 64];
+};
+
+// Outlives main, since allocations are released during static destruction
+HeapProfilerState& state() {
+	static HeapProfilerState* s = new HeapProfilerState();
+	return *s;
+}
+
+size_t filterBit(void* ptr) {
+	return (uintptr_t(ptr) * 0x9E3779B97F4A7C15ULL) >> (64 - 20);
+}
+
+thread_local int64_t bytesUntilSample = 0;
+thread_local bool bytesUntilSampleDrawn = false;
+thread_local bool inHeapProfiler = false;
+
+// The number of bytes allocated until the next sample, so that every allocated byte is sampled with the same
+// probability
+int64_t nextSampleDistance(int64_t sampleBytes) {
+	static thread_local std::mt19937_64 random(std::random_device{}());
+	double u = std::uniform_real_distribution<double>(0, 1)(random);
+	return 1 + int64_t(-std::log1p(-u) * sampleBytes);
+}
+
+} // namespace
+
+void HeapProfiler::enable(int64_t sampleBytes) {
+	HeapProfilerState& s = state();
+	{
+		ThreadSpinLockHolder holder(s.lock);
+		s.sampleBytes = std::max<int64_t>(sampleBytes, 1);
+		s.live.clear();
+		s.sites.clear();
+		for (auto& word : s.filter) {
+			word.store(0, std::memory_order_relaxed);
+		}
+	}
+	TraceEvent("HeapProfilerEnabled").detail("SampleBytes", sampleBytes);
+	if (!enabled.exchange(true)) {
+		++actorTypeNameReaders;
+	}
+}
+
+void HeapProfiler::disable() {
+	if (enabled.exchange(false)) {
+		--actorTypeNameReaders;
+	}
+	HeapProfilerState& s = state();
+	ThreadSpinLockHolder holder(s.lock);
+	s.live.clear();
+	s.sites.clear();
+}
+
+void HeapProfiler::sampleAllocation(void* ptr, size_t size) {
+	if (inHeapProfiler) {
+		return;
+	}
+	HeapProfilerState& s = state();
+	int64_t sampleBytes = s.sampleBytes.load(std::memory_order_relaxed);
+	if (!bytesUntilSampleDrawn) {
+		bytesUntilSample = nextSampleDistance(sampleBytes);
+		bytesUntilSampleDrawn = true;
+	}
+	bytesUntilSample -= size;
+	if (bytesUntilSample > 0) {
+		return;
+	}
+	inHeapProfiler = true;
+	bytesUntilSample = nextSampleDistance(sampleBytes);
+
+	// An allocation is sampled with probability 1 - exp(-size / sampleBytes), so weighting each sample by the inverse
+	// of that probability gives unbiased estimates of live bytes and allocations
+	double probability = -std::expm1(-double(size) / sampleBytes);
+	void* frames[maxFrames];
+	int length = 0;
+#ifdef __unixish__
+	length = platform::raw_backtrace(frames, maxFrames);
+#endif
+	uint32_t stackId = length ? crc32c_append(0xfdbeefdb, reinterpret_cast<uint8_t*>(frames), length * sizeof(void*))
+	                          : 0;
+	LiveSample sample{ std::make_pair(stackId, currentActorTypeName), size / probability, 1 / probability };
+
+	{
+		ThreadSpinLockHolder holder(s.lock);
+		if (isEnabled()) {
+			SiteData& site = s.sites[sample.site];
+			if (site.samples == 0) {
+				site.frames.assign(frames, frames + length);
+			}
+			site.liveBytes += sample.bytes;
+			site.liveAllocations += sample.allocations;
+			++site.samples;
+			s.live[ptr] = sample;
+			size_t bit = filterBit(ptr);
+			s.filter[bit / 64].fetch_or(uint64_t(1) << (bit % 64), std::memory_order_relaxed);
+		}
+	}
+	inHeapProfiler = false;
+}
+
+void HeapProfiler::sampleRelease(void* ptr) {
+	HeapProfilerState& s = state();
+	size_t bit = filterBit(ptr);
+	if (!(s.filter[bit / 64].load(std::memory_order_relaxed) & (uint64_t(1) << (bit % 64))) || inHeapProfiler) {
+		return;
+	}
+	inHeapProfiler = true;
+	{
+		ThreadSpinLockHolder holder(s.lock);
+		auto it = s.live.find(ptr);
+		if (it != s.live.end()) {
+			auto site = s.sites.find(it->second.site);
+			site->second.liveBytes -= it->second.bytes;
+			site->second.liveAllocations -= it->second.allocations;
+			if (--site->second.samples == 0) {
+				s.sites.erase(site);
+			}
+			s.live.erase(it);
+		}
+	}
+	inHeapProfiler = false;
+}
+
+std::vector<HeapProfiler::Site> HeapProfiler::getLiveSites() {
+	HeapProfilerState& s = state();
+	std::vector<Site> result;
+	{
+		ThreadSpinLockHolder holder(s.lock);
+		for (auto const& [key, site] : s.sites) {
+			result.push_back(
+			    Site{ key.first, key.second, site.frames, site.liveBytes, site.liveAllocations, site.samples });
+		}
+	}
+	std::sort(result.begin(), result.end(), [](Site const& a, Site const& b) { return a.liveBytes > b.liveBytes; });
+	return result;
+}
+
+std::string HeapProfiler::toPprof(std::vector<Site> const& sites, std::string const& mappings) {
+	// The format has no place for actors, so the sites of a stack are merged
+	std::map<std::vector<void*>, std::pair<double, double>> stacks;
+	double totalBytes = 0, totalAllocations = 0;
+	for (auto const& site : sites) {
+		auto& stack = stacks[site.frames];
+		stack.first += site.liveAllocations;
+		stack.second += site.liveBytes;
+		totalAllocations += site.liveAllocations;
+		totalBytes += site.liveBytes;
+	}
+
+	std::string profile = format("heap profile: %6lld: %8lld [%6lld: %8lld] @ heapprofile\n",
+	                             llround(totalAllocations),
+	                             llround(totalBytes),
+	                             llround(totalAllocations),
+	                             llround(totalBytes));
+	for (auto const& [frames, live] : stacks) {
+		profile += format("%6lld: %8lld [%6lld: %8lld] @",
+		                  llround(live.first),
+		                  llround(live.second),
+		                  llround(live.first),
+		                  llround(live.second));
+		for (void* frame : frames) {
+			profile += format(" %p", frame);
+		}
+		profile += "\n";
+	}
+	return profile + "\nMAPPED_LIBRARIES:\n" + mappings;
+}
+
+void HeapProfiler::writeProfile(std::vector<Site> const& sites, std::string const& outputFile) {
+	std::string mappings;
+#ifdef __linux__
+	std::ifstream maps("/proc/self/maps");
+	std::stringstream ss;
+	ss << maps.rdbuf();
+	mappings = ss.str();
+#endif
+	writeFile(outputFile, toPprof(sites, mappings));
+
+	double liveBytes = 0;
+	for (auto const& site : sites) {
+		liveBytes += site.liveBytes;
+	}
+	TraceEvent("HeapProfileWritten")
+	    .detail("File", outputFile)
+	    .detail("Sites", sites.size())
+	    .detail("LiveBytes", (int64_t)liveBytes);
+
+	// sites are sorted by live bytes
+	for (int i = 0; i < sites.size() && i < FLOW_KNOBS->HEAP_PROFILER_SUMMARY_SITES; i++) {
+		TraceEvent("HeapProfileSite")
+		    .detail("Actor", SlowTaskProfiler::actorName(sites[i].actorTypeName))
+		    .detail("StackId", sites[i].stackId)
+		    .detail("LiveBytes", (int64_t)sites[i].liveBytes)
+		    .detail("LiveAllocations", (int64_t)sites[i].liveAllocations)
+		    .detail("Samples", sites[i].samples)
+		    .detail("Backtrace", platform::format_backtrace((void**)sites[i].frames.data(), sites[i].frames.size()));
+	}
+}
+
+TEST_CASE("/flow/HeapProfiler/liveBytes") {
+	ASSERT(!HeapProfiler::isEnabled());
+	// allocateFast() hooks the profiler for allocations too large for a FastAllocator
+	std::vector<void*> kept, freed;
+	HeapProfiler::enable(4096);
+	for (int i = 0; i < 20000; i++) {
+		void* p = allocateFast(1024);
+		(i % 2 ? kept : freed).push_back(p);
+	}
+	for (void* p : freed) {
+		freeFast(1024, p);
+	}
+	std::vector<HeapProfiler::Site> sites = HeapProfiler::getLiveSites();
+	HeapProfiler::disable();
+	for (void* p : kept) {
+		freeFast(1024, p);
+	}
+
+	// Other allocations made meanwhile may be sampled too, but the kept allocations dominate
+	double liveBytes = 0;
+	for (auto const& site : sites) {
+		ASSERT(site.samples > 0 && site.liveBytes > 0);
+		liveBytes += site.liveBytes;
+	}
+	double expected = 10000 * 1024;
+	ASSERT(liveBytes > 0.8 * expected && liveBytes < 1.2 * expected);
+
+	std::string profile = HeapProfiler::toPprof(sites, "maps");
+	ASSERT(profile.rfind("heap profile: ", 0) == 0);
+	ASSERT(profile.size() > 5 && profile.substr(profile.size() - 4) == "maps");
+	ASSERT(HeapProfiler::getLiveSites().empty());
+	return Void();
+}
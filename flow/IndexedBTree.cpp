@@ -0,0 +1,221 @@
+/*
+ * IndexedBTree.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// At the moment, this file just contains tests.  IndexedBTree<> is a template
+// and so all the important implementation is in the header file
+
+#include "flow/IndexedBTree.h"
+#include "flow/Arena.h"
+#include "flow/IRandom.h"
+#include "flow/UnitTest.h"
+
+#include <functional>
+#include <map>
+
+template <class T, class Metric, int Fanout>
+int IndexedBTree<T, Metric, Fanout>::testonly_assertValid() const {
+	if (!root) {
+		ASSERT(total == Metric());
+		return 0;
+	}
+	ASSERT(!root->parent);
+	ASSERT(root->count >= (root->isLeaf ? 1 : 2));
+
+	int elements = 0;
+	int leafDepth = -1;
+	const Leaf* lastLeaf = nullptr;
+
+	// Checks the subtree at n, whose elements must be >= *lo and < *hi, and returns its metric total
+	std::function<Metric(const Node*, const T*, const T*, int)> check =
+	    [&](const Node* n, const T* lo, const T* hi, int depth) -> Metric {
+		ASSERT(n->count <= Fanout);
+		ASSERT(n == root || n->count >= minCount);
+		Metric m = Metric();
+		if (n->isLeaf) {
+			const Leaf* leaf = static_cast<const Leaf*>(n);
+			ASSERT(leafDepth == -1 || leafDepth == depth);
+			leafDepth = depth;
+			ASSERT(leaf->prev == lastLeaf);
+			ASSERT(!lastLeaf || lastLeaf->next == leaf);
+			lastLeaf = leaf;
+			for (int i = 0; i < leaf->count; i++) {
+				ASSERT(i == 0 || leaf->keys[i - 1] < leaf->keys[i]);
+				ASSERT(!lo || !(leaf->keys[i] < *lo));
+				ASSERT(!hi || leaf->keys[i] < *hi);
+				m = m + leaf->metrics[i];
+			}
+			elements += leaf->count;
+		} else {
+			const Internal* in = static_cast<const Internal*>(n);
+			for (int i = 0; i < in->count; i++) {
+				ASSERT(in->children[i]->parent == in);
+				const T* childLo = i == 0 ? lo : &in->keys[i];
+				const T* childHi = i + 1 < in->count ? &in->keys[i + 1] : hi;
+				Metric childTotal = check(in->children[i], childLo, childHi, depth + 1);
+				ASSERT(childTotal == in->totals[i]);
+				m = m + childTotal;
+			}
+		}
+		return m;
+	};
+
+	ASSERT(check(root, nullptr, nullptr, 0) == total);
+	ASSERT(!lastLeaf->next);
+	return elements;
+}
+
+namespace {
+
+// Compares every query on tree against the same query on model
+template <class Tree>
+void checkAgainstModel(const Tree& tree, const std::map<int, int>& model) {
+	ASSERT(tree.testonly_assertValid() == (int)model.size());
+	ASSERT(tree.empty() == model.empty());
+
+	int sum = 0;
+	auto it = tree.begin();
+	for (auto& [key, metric] : model) {
+		ASSERT(it != tree.end() && *it == key && tree.getMetric(it) == metric);
+		ASSERT(tree.sumTo(it) == sum);
+		sum += metric;
+		++it;
+	}
+	ASSERT(it == tree.end());
+	ASSERT(tree.sumTo(tree.end()) == sum);
+
+	if (!model.empty()) {
+		auto last = tree.end();
+		for (auto m = model.rbegin(); m != model.rend(); ++m) {
+			if (m == model.rbegin()) {
+				last = tree.find(m->first);
+			} else {
+				last.decrementNonEnd();
+			}
+			ASSERT(*last == m->first);
+		}
+		ASSERT(last == tree.begin());
+	}
+
+	for (int i = 0; i < 100; i++) {
+		int key = deterministicRandom()->randomInt(0, 1000);
+		auto lb = model.lower_bound(key);
+		auto ub = model.upper_bound(key);
+		ASSERT(lb == model.end() ? tree.lower_bound(key) == tree.end() : *tree.lower_bound(key) == lb->first);
+		ASSERT(ub == model.end() ? tree.upper_bound(key) == tree.end() : *tree.upper_bound(key) == ub->first);
+		ASSERT((tree.find(key) != tree.end()) == (model.count(key) == 1));
+
+		int target = deterministicRandom()->randomInt(-1, sum + 2);
+		auto expected = model.begin();
+		for (int through = 0; expected != model.end(); ++expected) {
+			through += expected->second;
+			if (through > target)
+				break;
+		}
+		auto found = tree.index(target);
+		ASSERT(expected == model.end() ? found == tree.end() : *found == expected->first);
+	}
+}
+
+} // namespace
+
+TEST_CASE("/flow/IndexedBTree/random ops") {
+	for (int t = 0; t < 20; t++) {
+		IndexedBTree<int, int, 8> tree;
+		std::map<int, int> model;
+		int ops = deterministicRandom()->randomInt(0, 3000);
+		for (int n = 0; n < ops; n++) {
+			int key = deterministicRandom()->randomInt(0, 1000);
+			int metric = deterministicRandom()->randomInt(1, 10);
+			switch (deterministicRandom()->randomInt(0, 6)) {
+			case 0:
+				tree.insert(key, metric);
+				model[key] = metric;
+				break;
+			case 1:
+				tree.insert(key, metric, false);
+				model.emplace(key, metric);
+				break;
+			case 2: {
+				// Keep metrics positive, as in the storage metric samples
+				int delta =
+				    model.count(key) && deterministicRandom()->coinflip() ? -std::min(metric, model[key]) : metric;
+				int newMetric = tree.addMetric(key, delta);
+				ASSERT(newMetric == (model[key] += delta));
+				if (newMetric == 0) {
+					tree.erase(key);
+					model.erase(key);
+				}
+				break;
+			}
+			case 3:
+				tree.erase(key);
+				model.erase(key);
+				break;
+			case 4: {
+				int end = key + deterministicRandom()->randomInt(0, deterministicRandom()->coinflip() ? 10 : 500);
+				tree.erase(key, end);
+				model.erase(model.lower_bound(key), model.lower_bound(end));
+				break;
+			}
+			default:
+				tree.erase(tree.lower_bound(key));
+				if (model.lower_bound(key) != model.end())
+					model.erase(model.lower_bound(key));
+				break;
+			}
+			if (n % 100 == 0)
+				checkAgainstModel(tree, model);
+		}
+		checkAgainstModel(tree, model);
+
+		tree.erase(tree.begin(), tree.end());
+		model.clear();
+		checkAgainstModel(tree, model);
+	}
+	return Void();
+}
+
+TEST_CASE("/flow/IndexedBTree/strings") {
+	IndexedBTree<Standalone<StringRef>, int64_t> tree;
+	for (int i = 0; i < 10000; i++) {
+		tree.insert(StringRef(format("key%05d", i)), 10);
+	}
+	ASSERT(tree.testonly_assertValid() == 10000);
+
+	// Queries accept StringRef as well as Standalone<StringRef>
+	ASSERT(tree.find("key00042"_sr) != tree.end());
+	ASSERT(tree.find("key00042a"_sr) == tree.end());
+	ASSERT(*tree.upper_bound("key00042"_sr) == "key00043"_sr);
+	ASSERT(tree.sumRange("key00100"_sr, "key00200"_sr) == 1000);
+	ASSERT(*tree.index(tree.sumTo(tree.lower_bound("key05000"_sr)) + 5) == "key05000"_sr);
+
+	ASSERT(tree.addMetric("key00150"_sr, -10) == 0);
+	tree.erase("key00150"_sr);
+	ASSERT(tree.sumRange("key00100"_sr, "key00200"_sr) == 990);
+
+	tree.erase("key01000"_sr, "key09000"_sr);
+	ASSERT(tree.testonly_assertValid() == 1999);
+	ASSERT(*tree.lower_bound("key01000"_sr) == "key09000"_sr);
+	ASSERT(tree.sumTo(tree.end()) == 19990);
+
+	return Void();
+}
+
+void forceLinkIndexedBTreeTests() {}
@@ -66,9 +66,15 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( SATURATION_PROFILING_LOG_INTERVAL,                   0.5 ); // A value of 0 means use RUN_LOOP_PROFILING_INTERVAL
 	init( SATURATION_PROFILING_MAX_LOG_INTERVAL,               5.0 );
 	init( SATURATION_PROFILING_LOG_BACKOFF,                    2.0 );
+	init( SLOWTASK_PROFILER_SAMPLES,                         10000 ); if( randomize && BUGGIFY ) SLOWTASK_PROFILER_SAMPLES = 10;
+	init( SLOWTASK_PROFILER_SUMMARY_ACTORS,                     20 );
+	init( HEAP_PROFILER_SAMPLE_BYTES,                      1 << 20 ); if( randomize && BUGGIFY ) HEAP_PROFILER_SAMPLE_BYTES = 1;
+	init( HEAP_PROFILER_SUMMARY_SITES,                          20 );
 
 	init( RANDOMSEED_RETRY_LIMIT,                                4 );
 	init( FAST_ALLOC_LOGGING_BYTES,                           10e6 );
+	init( FAST_ALLOC_TRIM_INTERVAL,                              0 ); if( randomize && BUGGIFY ) FAST_ALLOC_TRIM_INTERVAL = 5.0; // A value of 0 disables trimming
+	init( FAST_ALLOC_TRIM_MAX_ITEMS,                        1 << 18 ); if( randomize && BUGGIFY ) FAST_ALLOC_TRIM_MAX_ITEMS = 1;
 	init( HUGE_ARENA_LOGGING_BYTES,                          100e6 );
 	init( HUGE_ARENA_LOGGING_INTERVAL,                         5.0 );
 
@@ -109,6 +115,10 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( PING_LOGGING_INTERVAL,                               3.0 );
 	init( PING_SAMPLE_AMOUNT,                                  100 );
 	init( NETWORK_CONNECT_SAMPLE_AMOUNT,                       100 );
+	init( ENDPOINT_LATENCY_TRACKING,                          true );
+	init( ENDPOINT_LATENCY_LOGGING_INTERVAL,                  30.0 ); if( randomize && BUGGIFY ) ENDPOINT_LATENCY_LOGGING_INTERVAL = 5.0;
+	init( ENDPOINT_LATENCY_ERROR_GUARANTEE,                   0.02 );
+	init( ENDPOINT_LATENCY_STATUS_TYPES,                        10 );
 
 	init( TLS_CERT_REFRESH_DELAY_SECONDS,                 12*60*60 );
 	init( TLS_SERVER_CONNECTION_THROTTLE_TIMEOUT,              9.0 );
@@ -188,7 +198,9 @@ void FlowKnobs::initialize(Randomize randomize, IsSimulated isSimulated) {
 	init( TSC_YIELD_TIME,                                  1000000 );
 	init( MIN_LOGGED_PRIORITY_BUSY_FRACTION,                  0.05 );
 	init( CERT_FILE_MAX_SIZE,                      5 * 1024 * 1024 );
-	init( READY_QUEUE_RESERVED_SIZE,                          8192 );
+	init( RUN_LOOP_PRIORITY_BUDGETS,                            "" ); if( randomize && BUGGIFY ) RUN_LOOP_PRIORITY_BUDGETS = "5000:0.1,3000:0.2";
+	init( RUN_LOOP_BUDGET_WINDOW,                              0.1 ); if( randomize && BUGGIFY ) RUN_LOOP_BUDGET_WINDOW = 0.001;
+	init( RUN_LOOP_QUEUE_DELAY_HISTOGRAMS,                    true );
 	init( TASKS_PER_REACTOR_CHECK,                             100 );
 
 	//Network
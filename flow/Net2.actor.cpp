@@ -51,9 +51,11 @@
 #include "flow/SendBufferIterator.h"
 #include "flow/TLSConfig.actor.h"
 #include "flow/genericactors.actor.h"
+#include "flow/Histogram.h"
 #include "flow/Util.h"
 #include "flow/UnitTest.h"
 #include "flow/ScopeExit.h"
+#include "flow/SlowTaskProfiler.h"
 
 #ifdef ADDRESS_SANITIZER
 #include <sanitizer/lsan_interface.h>
@@ -75,6 +77,8 @@ using namespace boost::asio::ip;
 
 std::atomic<int64_t> net2RunLoopIterations(0);
 std::atomic<int64_t> net2RunLoopSleeps(0);
+// The priority of the task the run loop is running, read by the run loop profiler's signal handler
+volatile int64_t net2CurrentTaskPriority = 0;
 
 volatile size_t net2backtraces_max = 10000;
 volatile void** volatile net2backtraces = nullptr;
@@ -119,18 +123,209 @@ struct OrderedTask {
 	int64_t priority;
 	TaskPriority taskID;
 	Task* task;
+	double readyTime = 0; // Set by ReadyQueue::push()
 	OrderedTask(int64_t priority, TaskPriority taskID, Task* task) : priority(priority), taskID(taskID), task(task) {}
 	bool operator<(OrderedTask const& rhs) const { return priority < rhs.priority; }
 };
 
-template <class T>
-class ReadyQueue : public std::priority_queue<T, std::vector<T>> {
+// The tasks ready to run, in a FIFO queue per TaskPriority. A process only uses a few dozen distinct priorities, so
+// finding the highest priority queue with tasks is cheaper than keeping every ready task in a heap.
+//
+// The next task to run is the oldest task of the highest priority, unless RUN_LOOP_PRIORITY_BUDGETS guarantees a band
+// of lower priorities a share of the time spent running tasks and that band has used less than its share over the last
+// one to two RUN_LOOP_BUDGET_WINDOWs. The oldest task of the highest priority of that band runs instead, so that
+// low priority work such as making storage durable keeps making progress while higher priority work saturates the
+// run loop.
+class ReadyQueue {
 public:
-	typedef typename std::priority_queue<T, std::vector<T>>::size_type size_type;
-	ReadyQueue(size_type capacity = 0) { reserve(capacity); };
-	void reserve(size_type capacity) { this->c.reserve(capacity); }
+	ReadyQueue(std::string const& budgets, double budgetWindow, bool queueDelayHistograms);
+
+	bool empty() const { return count == 0; }
+	size_t size() const { return count; }
+
+	void push(OrderedTask task, double now);
+
+	// The oldest task of the highest priority
+	OrderedTask const& top();
+
+	// Removes and returns the next task to run
+	OrderedTask pop(double now);
+
+	// Whether the last task popped was not top() but a task of a band owed its budget
+	bool lastPopWasBudgeted() const { return lastBudgeted; }
+
+	// Charges the time spent running the last task popped to its band
+	void charge(double runTime);
+
+	// Drops every ready task without running or destroying it
+	void clear();
+
+private:
+	struct Band {
+		int64_t maxPriority;
+		double share;
+		int64_t queued = 0;
+		double used = 0;
+		double previousUsed = 0;
+	};
+	struct Bucket {
+		int64_t priority;
+		int band; // -1 if above every band
+		size_t index; // in buckets
+		Deque<OrderedTask> tasks;
+		Reference<Histogram> queueDelay;
+	};
+
+	Bucket& bucket(TaskPriority priority);
+	Bucket* owedBucket(Bucket const& top, double now);
+
+	std::vector<std::unique_ptr<Bucket>> buckets; // In decreasing order of priority
+	std::unordered_map<int64_t, Bucket*> bucketByPriority;
+	size_t highest = 0; // Every bucket before this index is empty
+	size_t count = 0;
+
+	std::vector<Band> bands; // In decreasing order of maxPriority
+	double budgetWindow;
+	double windowStart = 0;
+	double used = 0;
+	double previousUsed = 0;
+	int lastBand = -1;
+	bool lastBudgeted = false;
+	bool queueDelayHistograms;
 };
 
+ReadyQueue::ReadyQueue(std::string const& budgets, double budgetWindow, bool queueDelayHistograms)
+  : budgetWindow(budgetWindow), queueDelayHistograms(queueDelayHistograms) {
+	// A comma separated list of MAXPRIORITY:SHARE, where a band holds the priorities from its MAXPRIORITY down to the
+	// MAXPRIORITY of the next band
+	StringRef remaining(budgets);
+	while (remaining.size()) {
+		std::string band = remaining.eat(","_sr).toString();
+		int64_t maxPriority;
+		double share;
+		int len = 0;
+		if (sscanf(band.c_str(), "%" SCNd64 ":%lf%n", &maxPriority, &share, &len) != 2 || len != band.size() ||
+		    share < 0 || share > 1) {
+			TraceEvent(SevWarnAlways, "RunLoopPriorityBudgetInvalid").detail("Budget", band);
+			continue;
+		}
+		bands.push_back(Band{ maxPriority, share });
+	}
+	std::sort(bands.begin(), bands.end(), [](Band const& a, Band const& b) { return a.maxPriority > b.maxPriority; });
+}
+
+ReadyQueue::Bucket& ReadyQueue::bucket(TaskPriority priority) {
+	auto it = bucketByPriority.find(static_cast<int64_t>(priority));
+	if (it != bucketByPriority.end()) {
+		return *it->second;
+	}
+
+	auto b = std::make_unique<Bucket>();
+	b->priority = static_cast<int64_t>(priority);
+	b->band = -1;
+	while (b->band + 1 < bands.size() && bands[b->band + 1].maxPriority >= b->priority) {
+		++b->band;
+	}
+	// Inserting an empty bucket keeps every bucket before highest empty
+	auto pos = std::find_if(buckets.begin(), buckets.end(), [&](auto const& o) { return o->priority < b->priority; });
+	pos = buckets.insert(pos, std::move(b));
+	for (auto i = pos; i != buckets.end(); ++i) {
+		(*i)->index = i - buckets.begin();
+	}
+	return *(bucketByPriority[static_cast<int64_t>(priority)] = pos->get());
+}
+
+void ReadyQueue::push(OrderedTask task, double now) {
+	Bucket& b = bucket(task.taskID);
+	task.readyTime = now;
+	b.tasks.push_back(task);
+	++count;
+	if (b.band >= 0) {
+		++bands[b.band].queued;
+	}
+	highest = std::min(highest, b.index);
+}
+
+OrderedTask const& ReadyQueue::top() {
+	ASSERT(count > 0);
+	while (buckets[highest]->tasks.empty()) {
+		++highest;
+	}
+	return buckets[highest]->tasks.front();
+}
+
+ReadyQueue::Bucket* ReadyQueue::owedBucket(Bucket const& top, double now) {
+	if (now - windowStart >= budgetWindow) {
+		for (auto& band : bands) {
+			band.previousUsed = band.used;
+			band.used = 0;
+		}
+		previousUsed = used;
+		used = 0;
+		windowStart = now;
+	}
+	// Only the bands below the band of top can be starved by it
+	for (int i = top.band + 1; i < bands.size(); i++) {
+		Band const& band = bands[i];
+		if (band.queued > 0 && band.used + band.previousUsed < band.share * (used + previousUsed)) {
+			for (size_t j = top.index + 1; j < buckets.size(); j++) {
+				if (buckets[j]->band == i && !buckets[j]->tasks.empty()) {
+					return buckets[j].get();
+				}
+			}
+		}
+	}
+	return nullptr;
+}
+
+OrderedTask ReadyQueue::pop(double now) {
+	top();
+	Bucket* b = buckets[highest].get();
+	Bucket* owed = bands.empty() ? nullptr : owedBucket(*b, now);
+	lastBudgeted = owed != nullptr;
+	if (owed) {
+		b = owed;
+	}
+
+	OrderedTask task = b->tasks.front();
+	b->tasks.pop_front();
+	--count;
+	lastBand = b->band;
+	if (b->band >= 0) {
+		--bands[b->band].queued;
+	}
+
+	// Created on first use rather than in push(), which may run before g_network is set
+	if (queueDelayHistograms && !b->queueDelay.isValid()) {
+		b->queueDelay = Histogram::getHistogram(
+		    "RunLoopQueueDelay"_sr, StringRef(format("Priority%" PRId64, b->priority)), Histogram::Unit::microseconds);
+	}
+	if (b->queueDelay.isValid()) {
+		b->queueDelay->sampleSeconds(std::max(0.0, now - task.readyTime));
+	}
+	return task;
+}
+
+void ReadyQueue::charge(double runTime) {
+	if (bands.empty()) {
+		return;
+	}
+	used += runTime;
+	if (lastBand >= 0) {
+		bands[lastBand].used += runTime;
+	}
+}
+
+void ReadyQueue::clear() {
+	for (auto& b : buckets) {
+		b->tasks = Deque<OrderedTask>();
+	}
+	for (auto& band : bands) {
+		band.queued = 0;
+	}
+	count = 0;
+}
+
 thread_local INetwork* thread_network = 0;
 
 class Net2 final : public INetwork, public INetworkConnections {
@@ -266,14 +461,19 @@ public:
 
 	NetworkMetrics::PriorityStats* lastPriorityStats;
 
-	ReadyQueue<OrderedTask> ready;
+	ReadyQueue ready;
 	ThreadSafeQueue<OrderedTask> threadReady;
 
 	struct DelayedTask : OrderedTask {
 		double at;
 		DelayedTask(double at, int64_t priority, TaskPriority taskID, Task* task)
 		  : OrderedTask(priority, taskID, task), at(at) {}
-		bool operator<(DelayedTask const& rhs) const { return at > rhs.at; } // Ordering is reversed for priority_queue
+		// Ordering is reversed for priority_queue. Timers that expire together become ready in priority order and,
+		// within a priority, in the order they were created, which keeps orderedDelay() ordered now that the tasks of
+		// a priority run in the order they became ready.
+		bool operator<(DelayedTask const& rhs) const {
+			return at > rhs.at || (at == rhs.at && priority < rhs.priority);
+		}
 	};
 	std::priority_queue<DelayedTask, std::vector<DelayedTask>> timers;
 
@@ -287,8 +487,7 @@ public:
 		__lsan_do_leak_check();
 #endif
 		stopped = true;
-		decltype(ready) _1;
-		ready.swap(_1);
+		ready.clear();
 		decltype(timers) _2;
 		timers.swap(_2);
 	}
@@ -311,6 +510,7 @@ public:
 	Int64MetricHandle countTimers;
 	Int64MetricHandle countTasks;
 	Int64MetricHandle countYields;
+	Int64MetricHandle countBudgetedTasks;
 	Int64MetricHandle countYieldBigStack;
 	Int64MetricHandle countYieldCalls;
 	Int64MetricHandle countYieldCallsTrue;
@@ -1218,7 +1418,10 @@ Net2::Net2(const TLSConfig& tlsConfig, bool useThreadPool, bool useMetrics)
     sslHandshakerThreadsStarted(0), sslPoolHandshakesInProgress(0), tlsConfig(tlsConfig),
     tlsInitializedState(ETLSInitState::NONE), network(this), tscBegin(0), tscEnd(0), taskBegin(0),
     currentTaskID(TaskPriority::DefaultYield), tasksIssued(0), stopped(false), started(false), numYields(0),
-    lastPriorityStats(nullptr), ready(FLOW_KNOBS->READY_QUEUE_RESERVED_SIZE) {
+    lastPriorityStats(nullptr),
+    ready(FLOW_KNOBS->RUN_LOOP_PRIORITY_BUDGETS,
+          FLOW_KNOBS->RUN_LOOP_BUDGET_WINDOW,
+          FLOW_KNOBS->RUN_LOOP_QUEUE_DELAY_HISTOGRAMS) {
 	// Until run() is called, yield() will always yield
 	TraceEvent("Net2Starting").log();
 
@@ -1403,6 +1606,7 @@ void Net2::initMetrics() {
 	countTimers.init(LiteralStringRef("Net2.CountTimers"));
 	countTasks.init(LiteralStringRef("Net2.CountTasks"));
 	countYields.init(LiteralStringRef("Net2.CountYields"));
+	countBudgetedTasks.init(LiteralStringRef("Net2.CountBudgetedTasks"));
 	countYieldBigStack.init(LiteralStringRef("Net2.CountYieldBigStack"));
 	countYieldCalls.init(LiteralStringRef("Net2.CountYieldCalls"));
 	countASIOEvents.init(LiteralStringRef("Net2.CountASIOEvents"));
@@ -1519,7 +1723,7 @@ void Net2::run() {
 		while (!timers.empty() && timers.top().at < now) {
 			++numTimers;
 			++countTimers;
-			ready.push(timers.top());
+			ready.push(timers.top(), now);
 			timers.pop();
 		}
 		// FIXME: Is this double counting?
@@ -1538,10 +1742,16 @@ void Net2::run() {
 		FDB_TRACE_PROBE(run_loop_tasks_start, queueSize);
 		while (!ready.empty()) {
 			++countTasks;
-			currentTaskID = ready.top().taskID;
+			OrderedTask next = ready.pop(taskBegin);
+			if (ready.lastPopWasBudgeted()) {
+				++countBudgetedTasks;
+			}
+			currentTaskID = next.taskID;
 			priorityMetric = static_cast<int64_t>(currentTaskID);
-			Task* task = ready.top().task;
-			ready.pop();
+#if defined(__linux__) || defined(__FreeBSD__)
+			net2CurrentTaskPriority = static_cast<int64_t>(currentTaskID);
+#endif
+			Task* task = next.task;
 
 			try {
 				++tasksSinceReact;
@@ -1568,6 +1778,7 @@ void Net2::run() {
 
 			double tscNow = timestampCounter();
 			double newTaskBegin = timer_monotonic();
+			ready.charge(newTaskBegin - taskBegin);
 			if (check_yield(TaskPriority::Max, tscNow)) {
 				checkForSlowTask(tscBegin, tscNow, newTaskBegin - taskBegin, currentTaskID);
 				taskBegin = newTaskBegin;
@@ -1581,6 +1792,9 @@ void Net2::run() {
 		}
 
 		trackAtPriority(TaskPriority::RunLoop, taskBegin);
+#if defined(__linux__) || defined(__FreeBSD__)
+		net2CurrentTaskPriority = static_cast<int64_t>(TaskPriority::RunLoop);
+#endif
 
 		queueSize = ready.size();
 		FDB_TRACE_PROBE(run_loop_done, queueSize);
@@ -1618,10 +1832,15 @@ void Net2::run() {
 				size_t iter_offset = 0;
 				while (iter_offset < other_offset) {
 					ProfilingSample* ps = (ProfilingSample*)(other_backtraces + iter_offset);
+					// Actor is only known while the slow task or heap profiler is enabled
 					TraceEvent(SevWarn, "Net2RunLoopTrace")
 					    .detailf("TraceTime", "%.6f", ps->timestamp)
+					    .detail("Actor", SlowTaskProfiler::actorName(ps->actorTypeName))
+					    .detail("Priority", ps->priority)
 					    .detail("Trace", platform::format_backtrace(ps->frames, ps->length));
-					iter_offset += ps->length + 2;
+					SlowTaskProfiler::instance().addSample(
+					    ps->timestamp, ps->priority, ps->actorTypeName, ps->frames, ps->length);
+					iter_offset += ps->length + PROFILING_SAMPLE_HEADER_WORDS;
 				}
 			}
 
@@ -1705,7 +1924,7 @@ void Net2::processThreadReady() {
 			break;
 		t.get().priority -= ++tasksIssued;
 		ASSERT(t.get().task != 0);
-		ready.push(t.get());
+		ready.push(t.get(), taskBegin);
 		++numReady;
 	}
 	FDB_TRACE_PROBE(run_loop_thread_ready, numReady);
@@ -1794,7 +2013,7 @@ Future<class Void> Net2::yield(TaskPriority taskID) {
 Future<Void> Net2::delay(double seconds, TaskPriority taskId) {
 	if (seconds <= 0.) {
 		PromiseTask* t = new PromiseTask;
-		this->ready.push(OrderedTask((int64_t(taskId) << 32) - (++tasksIssued), taskId, t));
+		this->ready.push(OrderedTask((int64_t(taskId) << 32) - (++tasksIssued), taskId, t), taskBegin);
 		return t->promise.getFuture();
 	}
 	if (seconds >=
@@ -1820,7 +2039,7 @@ void Net2::onMainThread(Promise<Void>&& signal, TaskPriority taskID) {
 
 	if (thread_network == this) {
 		processThreadReady();
-		this->ready.push(OrderedTask(priority - (++tasksIssued), taskID, p));
+		this->ready.push(OrderedTask(priority - (++tasksIssued), taskID, p), taskBegin);
 	} else {
 		if (threadReady.push(OrderedTask(priority, taskID, p)))
 			reactor.wake();
@@ -2164,6 +2383,63 @@ TEST_CASE("/flow/Net2/ThreadSafeQueue/Interface") {
 	return Void();
 }
 
+TEST_CASE("/flow/Net2/ReadyQueue/order") {
+	N2::ReadyQueue ready("", 0.1, false);
+	// The reference order: decreasing priority, and the order tasks became ready within a priority
+	std::map<TaskPriority, std::deque<intptr_t>, std::greater<>> expected;
+	std::vector<TaskPriority> priorities = {
+		TaskPriority::Max, TaskPriority::DefaultEndpoint, TaskPriority::UpdateStorage, TaskPriority::Zero
+	};
+	intptr_t nextTask = 1;
+	int queued = 0;
+	for (int i = 0; i < 10000; i++) {
+		if (queued == 0 || deterministicRandom()->random01() < 0.5) {
+			TaskPriority priority = deterministicRandom()->randomChoice(priorities);
+			ready.push(N2::OrderedTask(int64_t(priority) << 32, priority, (N2::Task*)nextTask), i);
+			expected[priority].push_back(nextTask++);
+			++queued;
+		} else {
+			auto first = expected.begin();
+			while (first->second.empty()) {
+				++first;
+			}
+			ASSERT(ready.top().taskID == first->first);
+			N2::OrderedTask task = ready.pop(i);
+			ASSERT(!ready.lastPopWasBudgeted());
+			ASSERT((intptr_t)task.task == first->second.front());
+			first->second.pop_front();
+			--queued;
+		}
+		ASSERT(ready.size() == queued && ready.empty() == (queued == 0));
+	}
+	ready.clear();
+	ASSERT(ready.empty());
+	return Void();
+}
+
+TEST_CASE("/flow/Net2/ReadyQueue/budgets") {
+	// The priorities up to UpdateStorage are guaranteed a quarter of the time spent running tasks
+	N2::ReadyQueue ready(format("%d:0.25", (int)TaskPriority::UpdateStorage), 1.0, false);
+	N2::OrderedTask high(int64_t(TaskPriority::DefaultEndpoint) << 32, TaskPriority::DefaultEndpoint, nullptr);
+	N2::OrderedTask low(int64_t(TaskPriority::FetchKeys) << 32, TaskPriority::FetchKeys, nullptr);
+	ready.push(high, 0);
+	ready.push(low, 0);
+
+	// Both priorities always have a task ready, so without a budget the lower one would never run
+	int lowTasks = 0;
+	int tasks = 10000;
+	for (int i = 0; i < tasks; i++) {
+		double now = i * 0.001;
+		N2::OrderedTask task = ready.pop(now);
+		ASSERT(ready.lastPopWasBudgeted() == (task.taskID == TaskPriority::FetchKeys));
+		lowTasks += task.taskID == TaskPriority::FetchKeys;
+		ready.charge(0.001);
+		ready.push(task, now);
+	}
+	ASSERT(lowTasks > 0.2 * tasks && lowTasks < 0.3 * tasks);
+	return Void();
+}
+
 // A helper struct used by queueing tests which use multiple threads.
 struct QueueTestThreadState {
 	QueueTestThreadState(int threadId, int toProduce) : threadId(threadId), toProduce(toProduce) {}
@@ -3666,6 +3666,8 @@ extern volatile bool net2backtraces_overflow;
 extern volatile int net2backtraces_count;
 extern std::atomic<int64_t> net2RunLoopIterations;
 extern std::atomic<int64_t> net2RunLoopSleeps;
+extern volatile int64_t net2CurrentTaskPriority;
+extern thread_local const char* currentActorTypeName;
 extern void initProfiling();
 
 std::atomic<double> checkThreadTime;
@@ -3721,13 +3723,16 @@ void profileHandler(int sig) {
 	// We can only read the check thread time in a signal handler if the atomic is lock free.
 	// We can't get the time from a timer() call because it's not signal safe.
 	ps->timestamp = checkThreadTime.is_lock_free() ? checkThreadTime.load() : 0;
+	ps->actorTypeName = currentActorTypeName;
+	ps->priority = net2CurrentTaskPriority;
 
 	// SOMEDAY: should we limit the maximum number of frames from backtrace beyond just available space?
-	size_t size = platform::raw_backtrace(ps->frames, net2backtraces_max - net2backtraces_offset - 2);
+	size_t size = platform::raw_backtrace(
+	    ps->frames, net2backtraces_max - net2backtraces_offset - PROFILING_SAMPLE_HEADER_WORDS);
 
 	ps->length = size;
 
-	net2backtraces_offset += size + 2;
+	net2backtraces_offset += size + PROFILING_SAMPLE_HEADER_WORDS;
 #else
 	// No slow task profiling for other platforms!
 #endif
@@ -0,0 +1,222 @@
+/*
+ * SlowTaskProfiler.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include <boost/core/demangle.hpp>
+
+#include "flow/SlowTaskProfiler.h"
+#include "flow/flow.h"
+#include "flow/Knobs.h"
+#include "flow/Platform.h"
+#include "flow/Trace.h"
+#include "flow/UnitTest.h"
+
+SlowTaskProfiler::SlowTaskProfiler(int capacity) : capacity(std::max(capacity, 1)) {}
+
+SlowTaskProfiler& SlowTaskProfiler::instance() {
+	// Outlives main
+	static SlowTaskProfiler* profiler = new SlowTaskProfiler(FLOW_KNOBS->SLOWTASK_PROFILER_SAMPLES);
+	return *profiler;
+}
+
+void SlowTaskProfiler::enable() {
+	if (FLOW_KNOBS->RUN_LOOP_PROFILING_INTERVAL <= 0) {
+		TraceEvent(SevWarnAlways, "SlowTaskProfilerRunLoopProfilingDisabled").log();
+	}
+	TraceEvent("SlowTaskProfilerEnabled").detail("Capacity", capacity);
+	if (!enabled) {
+		++actorTypeNameReaders;
+	}
+	enabled = true;
+}
+
+std::vector<SlowTaskProfiler::Sample> SlowTaskProfiler::disable() {
+	std::vector<Sample> result = getSamples();
+	TraceEvent("SlowTaskProfilerDisabled").detail("Samples", result.size());
+	if (enabled) {
+		--actorTypeNameReaders;
+	}
+	enabled = false;
+	samples.clear();
+	next = 0;
+	return result;
+}
+
+void SlowTaskProfiler::addSample(double time,
+                                 int64_t priority,
+                                 const char* actorTypeName,
+                                 void* const* frames,
+                                 size_t length) {
+	if (!enabled) {
+		return;
+	}
+	Sample sample{ time, priority, actorTypeName, std::vector<void*>(frames, frames + length) };
+	if (samples.size() < capacity) {
+		samples.push_back(std::move(sample));
+	} else {
+		samples[next] = std::move(sample);
+	}
+	next = (next + 1) % capacity;
+}
+
+std::vector<SlowTaskProfiler::Sample> SlowTaskProfiler::getSamples() const {
+	if (samples.size() < capacity) {
+		return samples;
+	}
+	std::vector<Sample> result(samples.begin() + next, samples.end());
+	result.insert(result.end(), samples.begin(), samples.begin() + next);
+	return result;
+}
+
+std::string SlowTaskProfiler::actorName(const char* actorTypeName) {
+	if (actorTypeName == nullptr) {
+		return "";
+	}
+	// Type names are string literals, so they can be cached by address
+	static std::unordered_map<const char*, std::string> names;
+	auto it = names.find(actorTypeName);
+	if (it != names.end()) {
+		return it->second;
+	}
+
+	// The actor compiler names the class of ACTOR fooBar FooBarActor, or FooBarActor1 and so on if the name is taken
+	std::string name = boost::core::demangle(actorTypeName);
+	const std::string anonymous = "(anonymous namespace)::";
+	for (size_t pos; (pos = name.find(anonymous)) != std::string::npos;) {
+		name.erase(pos, anonymous.size());
+	}
+	size_t end = std::min(name.find('<'), name.size());
+	size_t digits = end;
+	while (digits > 0 && isdigit(name[digits - 1])) {
+		--digits;
+	}
+	const std::string suffix = "Actor";
+	if (digits >= suffix.size() && name.compare(digits - suffix.size(), suffix.size(), suffix) == 0) {
+		name.erase(digits - suffix.size(), end - digits + suffix.size());
+	}
+	return names[actorTypeName] = name;
+}
+
+std::string SlowTaskProfiler::toPprof(std::vector<Sample> const& samples,
+                                      double samplingPeriod,
+                                      std::string const& mappings) {
+	std::map<std::vector<void*>, uintptr_t> stacks;
+	for (auto const& sample : samples) {
+		++stacks[sample.frames];
+	}
+
+	std::vector<uintptr_t> words = { 0, 3, 0, uintptr_t(samplingPeriod * 1e6), 0 };
+	for (auto const& [frames, count] : stacks) {
+		words.push_back(count);
+		words.push_back(frames.size());
+		for (void* frame : frames) {
+			words.push_back(reinterpret_cast<uintptr_t>(frame));
+		}
+	}
+	words.insert(words.end(), { 0, 1, 0 });
+
+	std::string profile(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uintptr_t));
+	return profile + mappings;
+}
+
+void SlowTaskProfiler::writeProfile(std::vector<Sample> const& samples, std::string const& outputFile) {
+	std::string mappings;
+#ifdef __linux__
+	std::ifstream maps("/proc/self/maps");
+	std::stringstream ss;
+	ss << maps.rdbuf();
+	mappings = ss.str();
+#endif
+	writeFile(outputFile, toPprof(samples, FLOW_KNOBS->RUN_LOOP_PROFILING_INTERVAL, mappings));
+	TraceEvent("SlowTaskProfileWritten").detail("File", outputFile).detail("Samples", samples.size());
+
+	std::map<std::pair<std::string, int64_t>, int> counts;
+	for (auto const& sample : samples) {
+		++counts[std::make_pair(actorName(sample.actorTypeName), sample.priority)];
+	}
+	std::vector<std::pair<int, std::pair<std::string, int64_t>>> busiest;
+	for (auto const& [actorAndPriority, count] : counts) {
+		busiest.emplace_back(count, actorAndPriority);
+	}
+	std::sort(busiest.begin(), busiest.end(), std::greater<>());
+	for (int i = 0; i < busiest.size() && i < FLOW_KNOBS->SLOWTASK_PROFILER_SUMMARY_ACTORS; i++) {
+		auto const& [count, actorAndPriority] = busiest[i];
+		TraceEvent("SlowTaskProfileActor")
+		    .detail("Actor", actorAndPriority.first)
+		    .detail("Priority", actorAndPriority.second)
+		    .detail("Samples", count)
+		    .detail("Fraction", double(count) / samples.size());
+	}
+}
+
+namespace {
+struct SlowTaskProfilerTestActor {};
+template <class T>
+struct SlowTaskProfilerTestActor2 {};
+} // namespace
+
+TEST_CASE("/flow/SlowTaskProfiler/ringBuffer") {
+	int capacity = deterministicRandom()->randomInt(1, 100);
+	int count = deterministicRandom()->randomInt(0, 300);
+	SlowTaskProfiler profiler(capacity);
+
+	void* frames[] = { (void*)0x1000, (void*)0x2000, (void*)0x3000 };
+	profiler.addSample(0, 0, nullptr, frames, 3);
+	ASSERT(profiler.getSamples().empty());
+
+	profiler.enable();
+	for (int i = 0; i < count; i++) {
+		profiler.addSample(i, i, nullptr, frames, 1 + i % 3);
+	}
+	std::vector<SlowTaskProfiler::Sample> samples = profiler.disable();
+	ASSERT(samples.size() == std::min(capacity, count));
+	for (int i = 0; i < samples.size(); i++) {
+		int expected = count - samples.size() + i;
+		ASSERT(samples[i].time == expected && samples[i].priority == expected);
+		ASSERT(samples[i].frames.size() == 1 + expected % 3);
+	}
+	ASSERT(!profiler.isEnabled() && profiler.getSamples().empty());
+	return Void();
+}
+
+TEST_CASE("/flow/SlowTaskProfiler/pprof") {
+	void* frames[] = { (void*)0x1000, (void*)0x2000, (void*)0x3000 };
+	std::vector<SlowTaskProfiler::Sample> samples = { { 0, 0, nullptr, { frames[0], frames[1] } },
+		                                              { 0, 0, nullptr, { frames[2] } },
+		                                              { 0, 0, nullptr, { frames[0], frames[1] } } };
+	std::string profile = SlowTaskProfiler::toPprof(samples, 0.125, "maps");
+
+	// A header, each distinct stack with its count, a trailer and then the mappings
+	std::vector<uintptr_t> expected = { 0, 3, 0, 125000, 0, 2, 2, 0x1000, 0x2000, 1, 1, 0x3000, 0, 1, 0 };
+	ASSERT(profile.size() == expected.size() * sizeof(uintptr_t) + 4);
+	ASSERT(memcmp(profile.data(), expected.data(), expected.size() * sizeof(uintptr_t)) == 0);
+	ASSERT(profile.substr(expected.size() * sizeof(uintptr_t)) == "maps");
+
+	ASSERT(SlowTaskProfiler::actorName(nullptr) == "");
+	ASSERT(SlowTaskProfiler::actorName(typeid(SlowTaskProfilerTestActor).name()) == "SlowTaskProfilerTest");
+	ASSERT(SlowTaskProfiler::actorName(typeid(SlowTaskProfilerTestActor2<int>).name()) ==
+	       "SlowTaskProfilerTest<int>");
+	return Void();
+}
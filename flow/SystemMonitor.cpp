@@ -46,6 +46,13 @@ void systemMonitor() {
 #if !DEBUG_DETERMINISM
 	customSystemMonitor("ProcessMetrics", &statState, true);
 #endif
+
+	// Memory that stayed free in the FastAllocator pools for a whole interval is returned to the OS
+	static double lastTrim = now();
+	if (FLOW_KNOBS->FAST_ALLOC_TRIM_INTERVAL > 0 && now() - lastTrim >= FLOW_KNOBS->FAST_ALLOC_TRIM_INTERVAL) {
+		trimFastAllocators();
+		lastTrim = now();
+	}
 }
 
 SystemStatistics getSystemStatistics() {
@@ -65,7 +72,10 @@ SystemStatistics getSystemStatistics() {
 #define DETAILALLOCATORMEMUSAGE(size)                                                                                  \
 	detail("TotalMemory" #size, FastAllocator<size>::getTotalMemory())                                                 \
 	    .detail("ApproximateUnusedMemory" #size, FastAllocator<size>::getApproximateMemoryUnused())                    \
-	    .detail("ActiveThreads" #size, FastAllocator<size>::getActiveThreads())
+	    .detail("ActiveThreads" #size, FastAllocator<size>::getActiveThreads())                                        \
+	    .detail("InUseMemory" #size,                                                                                   \
+	            FastAllocator<size>::getTotalMemory() - FastAllocator<size>::getApproximateMemoryUnused())             \
+	    .detail("ReleasedMemory" #size, FastAllocator<size>::getReleasedMemory())
 
 SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsState* statState, bool machineMetrics) {
 	const IPAddress ipAddr = machineState.ip.present() ? machineState.ip.get() : IPAddress();
@@ -206,6 +216,7 @@ SystemStatistics customSystemMonitor(std::string const& eventName, StatisticsSta
 			    .detail("CantSleep", netData.countCantSleep - statState->networkState.countCantSleep)
 			    .detail("WontSleep", netData.countWontSleep - statState->networkState.countWontSleep)
 			    .detail("Yields", netData.countYields - statState->networkState.countYields)
+			    .detail("BudgetedTasks", netData.countBudgetedTasks - statState->networkState.countBudgetedTasks)
 			    .detail("YieldCalls", netData.countYieldCalls - statState->networkState.countYieldCalls)
 			    .detail("YieldCallsTrue", netData.countYieldCallsTrue - statState->networkState.countYieldCallsTrue)
 			    .detail("RunLoopProfilingSignals",
@@ -440,6 +440,47 @@ TEST_CASE("/flow/FlatBuffers/struct") {
 	return Void();
 }
 
+TEST_CASE("/flow/FlatBuffers/fixedLayout") {
+	Arena arena;
+	TestContext context{ arena };
+	int x1 = 1;
+	Table3 t1{ 2, 3, 4, 5 };
+	std::tuple<int16_t, bool, int64_t> s1 = { 6, true, 7 };
+	auto root1 = detail::fake_root(x1, t1, s1);
+	auto* layout = detail::get_fixed_layout(root1, context);
+	ASSERT(layout->fixed);
+
+	// The first message computes the layout, and later ones are written with it
+	const uint8_t* first = detail::save(context, root1, FileIdentifier{});
+	ASSERT(layout->size == (int)arena.get_size(first));
+	int x2 = 8;
+	Table3 t2{ 9, 10, 11, 12 };
+	std::tuple<int16_t, bool, int64_t> s2 = { 13, false, 14 };
+	auto root2 = detail::fake_root(x2, t2, s2);
+	const uint8_t* fast = detail::save(context, root2, FileIdentifier{});
+
+	// ... to the same bytes as the generic path
+	layout->fixed = false;
+	layout->size = 0;
+	const uint8_t* generic = detail::save(context, root2, FileIdentifier{});
+	ASSERT(arena.get_size(fast) == arena.get_size(generic));
+	ASSERT(memcmp(fast, generic, arena.get_size(fast)) == 0);
+	layout->fixed = true;
+
+	int x3;
+	Table3 t3;
+	std::tuple<int16_t, bool, int64_t> s3;
+	load_members(fast, context, x3, t3, s3);
+	ASSERT(x3 == x2 && s3 == s2);
+	ASSERT(t3.m_asbehdlquj == 9 && t3.m_k == 10 && t3.m_jib == 11 && t3.m_n == 12);
+
+	// Messages with strings, vectors or unions take the generic path
+	Table2 t4;
+	auto root4 = detail::fake_root(x1, t4);
+	ASSERT(!detail::get_fixed_layout(root4, context)->fixed);
+	return Void();
+}
+
 TEST_CASE("/flow/FlatBuffers/file_identifier") {
 	Arena arena;
 	TestContext context{ arena };
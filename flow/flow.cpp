@@ -34,6 +34,8 @@
 std::atomic<bool> startSampling = false;
 LineageReference rootLineage;
 thread_local LineageReference* currentLineage = &rootLineage;
+thread_local const char* currentActorTypeName = nullptr;
+std::atomic<int> actorTypeNameReaders(0);
 
 LineagePropertiesBase::~LineagePropertiesBase() {}
 
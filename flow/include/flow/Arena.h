@@ -206,6 +206,30 @@ inline void* operator new[](size_t size, Arena& p) {
 }
 inline void operator delete[](void*, Arena& p) {}
 
+// The ArenaBlocks created by the calling thread, and how many of them reused a block of 512 to 8192 bytes that the
+// thread had recycled instead of allocating memory
+struct ArenaBlockCounts {
+	int64_t created = 0;
+	int64_t recycled = 0;
+};
+ArenaBlockCounts getArenaBlockCounts();
+
+// Learns how many bytes one call site (for instance the replies to one kind of request) tends to put in an arena, so
+// that the next arena can be created with a single block big enough for its contents instead of growing through a
+// chain of increasingly large blocks. Sizes are recorded by the caller, since Arena::getSize() also counts the arenas
+// an arena depends on. Not thread safe.
+class ArenaSizeHint {
+public:
+	// The recent average size plus two mean deviations, or 0 before any size has been recorded
+	size_t reservedSize() const;
+	void record(size_t size);
+
+private:
+	bool recorded = false;
+	double average = 0;
+	double deviation = 0;
+};
+
 template <class Archive>
 inline void load(Archive& ar, Arena& p) {
 	p = ar.arena();
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "flow/Error.h"
+#include "flow/HeapProfiler.h"
 #include "flow/Platform.h"
 #include "flow/config.h"
 
@@ -115,6 +116,11 @@ public:
 	static long long getTotalMemory();
 	static long long getApproximateMemoryUnused();
 	static long long getActiveThreads();
+	static long long getReleasedMemory();
+
+	// Returns to the OS the blocks whose items are all in magazines that stayed in the global pool since the last
+	// call, examining at most maxItems free items. Returns the number of bytes released.
+	static long long trim(int maxItems);
 
 #ifdef ALLOC_INSTRUMENTATION
 	static volatile int32_t pageCount;
@@ -168,6 +174,7 @@ private:
 	}
 	static void* freelist;
 
+	static void** allocateBlock();
 	static void getMagazine();
 	static void releaseMagazine(void*);
 };
@@ -176,6 +183,8 @@ extern std::atomic<int64_t> g_hugeArenaMemory;
 void hugeArenaSample(int size);
 void releaseAllThreadMagazines();
 int64_t getTotalUnusedAllocatedMemory();
+// Trims every FastAllocator, see FastAllocator::trim(). Returns the number of bytes released.
+int64_t trimFastAllocators();
 
 inline constexpr int nextFastAllocatedSize(int x) {
 	assert(x > 0 && x <= 16384);
@@ -249,7 +258,9 @@ public:
 		return FastAllocator<128>::allocate();
 	if (size <= 256)
 		return FastAllocator<256>::allocate();
-	return new uint8_t[size];
+	void* ptr = new uint8_t[size];
+	HeapProfiler::allocated(ptr, size);
+	return ptr;
 }
 
 inline void freeFast(int size, void* ptr) {
@@ -265,6 +276,7 @@ inline void freeFast(int size, void* ptr) {
 		return FastAllocator<128>::release(ptr);
 	if (size <= 256)
 		return FastAllocator<256>::release(ptr);
+	HeapProfiler::released(ptr);
 	delete[](uint8_t*) ptr;
 }
 
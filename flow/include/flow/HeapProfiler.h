@@ -0,0 +1,78 @@
+/*
+ * HeapProfiler.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_HEAP_PROFILER_H
+#define FLOW_HEAP_PROFILER_H
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// While enabled, samples the allocations made through FastAllocator, ArenaBlock and allocateFast, on average one per
+// sampleBytes allocated, together with their backtrace and the actor that was running (see currentActorTypeName).
+// Sampled allocations are tracked until they are freed, so the samples estimate the live bytes of every call site and
+// actor. When disabled, the allocation hooks cost a single relaxed load.
+class HeapProfiler {
+public:
+	struct Site {
+		uint32_t stackId; // A hash of frames
+		const char* actorTypeName;
+		std::vector<void*> frames;
+		double liveBytes; // Estimated from the samples
+		double liveAllocations; // Estimated from the samples
+		int64_t samples;
+	};
+
+	static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+	static void enable(int64_t sampleBytes);
+	static void disable();
+
+	static void allocated(void* ptr, size_t size) {
+		if (isEnabled()) {
+			sampleAllocation(ptr, size);
+		}
+	}
+	static void released(void* ptr) {
+		if (isEnabled()) {
+			sampleRelease(ptr);
+		}
+	}
+
+	// Returns the call sites and actors with live sampled allocations, those with the most live bytes first
+	static std::vector<Site> getLiveSites();
+
+	// Serializes sites in the legacy heap profile text format, which pprof reads along with the binary. mappings
+	// should be the contents of /proc/self/maps, which pprof uses to symbolize the frames.
+	static std::string toPprof(std::vector<Site> const& sites, std::string const& mappings);
+
+	// Writes sites as a heap profile to outputFile, and logs the call sites and actors with the most live bytes
+	static void writeProfile(std::vector<Site> const& sites, std::string const& outputFile);
+
+private:
+	static std::atomic<bool> enabled;
+
+	static void sampleAllocation(void* ptr, size_t size);
+	static void sampleRelease(void* ptr);
+};
+
+#endif
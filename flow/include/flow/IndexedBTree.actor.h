@@ -0,0 +1,51 @@
+/*
+ * IndexedBTree.actor.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// When actually compiled (NO_INTELLISENSE), include the generated version of this file.  In intellisense use the source
+// version.
+#if defined(NO_INTELLISENSE) && !defined(FLOW_INDEXEDBTREE_ACTOR_G_H)
+#define FLOW_INDEXEDBTREE_ACTOR_G_H
+#include "flow/IndexedBTree.actor.g.h"
+#elif !defined(FLOW_INDEXEDBTREE_ACTOR_H)
+#define FLOW_INDEXEDBTREE_ACTOR_H
+
+#include <memory>
+#include <vector>
+
+#include "flow/flow.h"
+#include "flow/actorcompiler.h" // This must be the last #include.
+
+ACTOR template <class T>
+[[flow_allow_discard]] Future<Void> IBTFreeItems(std::shared_ptr<std::vector<T>> toFree) {
+	// Destroys the elements erased from an IndexedBTree, yielding periodically so that freeing a large range of
+	// elements doesn't block the run loop.
+	loop {
+		toFree->resize(toFree->size() - std::min<size_t>(toFree->size(), 1000));
+		if (toFree->empty())
+			break;
+		wait(yield());
+	}
+	return Void();
+}
+
+#include "flow/unactorcompiler.h"
+#endif
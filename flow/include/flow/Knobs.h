@@ -131,6 +131,8 @@ public:
 
 	int RANDOMSEED_RETRY_LIMIT;
 	double FAST_ALLOC_LOGGING_BYTES;
+	double FAST_ALLOC_TRIM_INTERVAL; // The idle time after which free FastAllocator blocks are returned to the OS
+	int FAST_ALLOC_TRIM_MAX_ITEMS; // The most free items of a size class examined by a trim
 	double HUGE_ARENA_LOGGING_BYTES;
 	double HUGE_ARENA_LOGGING_INTERVAL;
 
@@ -155,6 +157,10 @@ public:
 	double SATURATION_PROFILING_LOG_INTERVAL;
 	double SATURATION_PROFILING_MAX_LOG_INTERVAL;
 	double SATURATION_PROFILING_LOG_BACKOFF;
+	int SLOWTASK_PROFILER_SAMPLES; // The most recent run loop profiling samples the slow task profiler keeps
+	int SLOWTASK_PROFILER_SUMMARY_ACTORS; // The number of actor and priority pairs logged when a profile is written
+	int64_t HEAP_PROFILER_SAMPLE_BYTES; // The average number of bytes allocated between heap profiler samples
+	int HEAP_PROFILER_SUMMARY_SITES; // The number of call site and actor pairs logged when a heap profile is written
 
 	// connectionMonitor
 	double CONNECTION_MONITOR_LOOP_TIME;
@@ -177,6 +183,10 @@ public:
 	double PING_LOGGING_INTERVAL;
 	int PING_SAMPLE_AMOUNT;
 	int NETWORK_CONNECT_SAMPLE_AMOUNT;
+	bool ENDPOINT_LATENCY_TRACKING; // record the request count and latencies of every request stream endpoint
+	double ENDPOINT_LATENCY_LOGGING_INTERVAL;
+	double ENDPOINT_LATENCY_ERROR_GUARANTEE; // the relative error of the endpoint latency percentiles
+	int ENDPOINT_LATENCY_STATUS_TYPES; // the number of busiest request types reported in status
 
 	int TLS_CERT_REFRESH_DELAY_SECONDS;
 	double TLS_SERVER_CONNECTION_THROTTLE_TIMEOUT;
@@ -257,7 +267,9 @@ public:
 	int64_t REACTOR_FLAGS;
 	double MIN_LOGGED_PRIORITY_BUSY_FRACTION;
 	int CERT_FILE_MAX_SIZE;
-	int READY_QUEUE_RESERVED_SIZE;
+	std::string RUN_LOOP_PRIORITY_BUDGETS; // MAXPRIORITY:SHARE,... guaranteed shares of the time spent running tasks
+	double RUN_LOOP_BUDGET_WINDOW; // The window over which RUN_LOOP_PRIORITY_BUDGETS are enforced, in seconds
+	bool RUN_LOOP_QUEUE_DELAY_HISTOGRAMS; // Record the time tasks wait in the ready queue per priority
 	int TASKS_PER_REACTOR_CHECK;
 
 	// Network
@@ -447,9 +447,14 @@ private:
 typedef struct {
 	double timestamp;
 	size_t length;
+	const char* actorTypeName; // currentActorTypeName when the sample was taken
+	int64_t priority; // TaskPriority of the running task
 	void* frames[];
 } ProfilingSample;
 
+// The number of backtrace buffer words a ProfilingSample uses in addition to its frames
+constexpr size_t PROFILING_SAMPLE_HEADER_WORDS = sizeof(ProfilingSample) / sizeof(void*);
+
 dev_t getDeviceId(std::string path);
 #endif
 
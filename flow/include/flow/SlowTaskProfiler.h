@@ -0,0 +1,75 @@
+/*
+ * SlowTaskProfiler.h
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FLOW_SLOW_TASK_PROFILER_H
+#define FLOW_SLOW_TASK_PROFILER_H
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// While enabled, keeps the most recent stacks captured by the run loop profiler (see setupRunLoopProfiler()) when the
+// run loop is blocked by a slow task or saturated, together with the actor and task priority that were running. The
+// samples can be written as a CPU profile that pprof reads, and summarized by actor and priority in trace events.
+class SlowTaskProfiler {
+public:
+	struct Sample {
+		double time;
+		int64_t priority;
+		const char* actorTypeName; // currentActorTypeName when the sample was taken
+		std::vector<void*> frames;
+	};
+
+	explicit SlowTaskProfiler(int capacity);
+
+	// The profiler of the run loop of this process
+	static SlowTaskProfiler& instance();
+
+	bool isEnabled() const { return enabled; }
+	void enable();
+
+	// Stops recording and returns the recorded samples, oldest first
+	std::vector<Sample> disable();
+
+	void addSample(double time, int64_t priority, const char* actorTypeName, void* const* frames, size_t length);
+
+	// Returns the recorded samples, oldest first
+	std::vector<Sample> getSamples() const;
+
+	// Returns the name of the ACTOR whose generated class has the given type name, or "" for nullptr
+	static std::string actorName(const char* actorTypeName);
+
+	// Serializes samples in the gperftools CPU profile format, which pprof reads along with the binary. mappings
+	// should be the contents of /proc/self/maps, which pprof uses to symbolize the frames.
+	static std::string toPprof(std::vector<Sample> const& samples, double samplingPeriod, std::string const& mappings);
+
+	// Writes samples as a CPU profile to outputFile, and logs the actors and priorities sampled most often
+	static void writeProfile(std::vector<Sample> const& samples, std::string const& outputFile);
+
+private:
+	bool enabled = false;
+	int capacity;
+	// A ring buffer of the most recent samples; next is where the next sample will be written
+	std::vector<Sample> samples;
+	size_t next = 0;
+};
+
+#endif
@@ -65,6 +65,7 @@ struct NetworkData {
 	int64_t countTimers;
 	int64_t countTasks;
 	int64_t countYields;
+	int64_t countBudgetedTasks;
 	int64_t countYieldBigStack;
 	int64_t countYieldCalls;
 	int64_t countASIOEvents;
@@ -107,6 +108,7 @@ struct NetworkData {
 		countTimers = Int64Metric::getValueOrDefault(LiteralStringRef("Net2.CountTimers"));
 		countTasks = Int64Metric::getValueOrDefault(LiteralStringRef("Net2.CountTasks"));
 		countYields = Int64Metric::getValueOrDefault(LiteralStringRef("Net2.CountYields"));
+		countBudgetedTasks = Int64Metric::getValueOrDefault(LiteralStringRef("Net2.CountBudgetedTasks"));
 		countYieldBigStack = Int64Metric::getValueOrDefault(LiteralStringRef("Net2.CountYieldBigStack"));
 		countYieldCalls = Int64Metric::getValueOrDefault(LiteralStringRef("Net2.CountYieldCalls"));
 		countASIOEvents = Int64Metric::getValueOrDefault(LiteralStringRef("Net2.CountASIOEvents"));
@@ -782,6 +782,65 @@ const VTableSet* get_vtableset(const Root& root, const Context& context) {
 	return &result;
 }
 
+// Saving a message takes a pass to compute the size of the buffer and where each part goes, and another to write the
+// parts. If the message, and every table in it, only has scalar and struct members, then every message of its type
+// has the same layout, and the first pass is only needed for the first message.
+struct FixedLayout {
+	bool fixed = true;
+	int size = 0; // 0 until the layout has been computed
+	int vtable_start = 0;
+	std::vector<int> writeToOffsets;
+};
+
+template <class Context>
+struct FixedLayoutLambda : Context {
+	FixedLayoutLambda(const Context& context, FixedLayout& layout) : Context(context), layout(layout) {}
+	static constexpr bool isDeserializing = false;
+	static constexpr bool isSerializing = false;
+	static constexpr bool is_fb_visitor = true;
+	FixedLayout& layout;
+
+	template <class... Members>
+	void operator()(const Members&... members) {
+		for_each([&](const auto& member) { check(member); }, members...);
+	}
+
+private:
+	template <class Member>
+	void check(const Member& member) {
+		if constexpr (expect_serialize_member<Member>) {
+			if (!layout.fixed) {
+				return;
+			}
+			if constexpr (serializable_traits<Member>::value) {
+				serializable_traits<Member>::serialize(*this, const_cast<Member&>(member));
+			} else {
+				const_cast<Member&>(member).serialize(*this);
+			}
+		} else if constexpr (!is_scalar<Member> && !is_struct_like<Member>) {
+			layout.fixed = false;
+		}
+	}
+};
+
+template <class Root, class Context>
+FixedLayout get_fixed_layout_impl(const Root& root, const Context& context) {
+	FixedLayout layout;
+	FixedLayoutLambda<Context> lambda{ context, layout };
+	if constexpr (serializable_traits<Root>::value) {
+		serializable_traits<Root>::serialize(lambda, const_cast<Root&>(root));
+	} else {
+		const_cast<Root&>(root).serialize(lambda);
+	}
+	return layout;
+}
+
+template <class Root, class Context>
+FixedLayout* get_fixed_layout(const Root& root, const Context& context) {
+	static thread_local FixedLayout result = get_fixed_layout_impl(root, context);
+	return &result;
+}
+
 constexpr static std::array<uint8_t, 8> zeros{};
 
 template <class Root, class Writer, class Context>
@@ -1294,9 +1353,23 @@ auto fake_root(Members&... members) {
 template <class Context, class Root>
 uint8_t* save(Context& context, const Root& root, FileIdentifier file_identifier) {
 	const auto* vtableset = get_vtableset(root, context);
-	PrecomputeSize<Context> precompute_size(context);
+	auto* fixedLayout = get_fixed_layout(root, context);
 	int vtable_start;
+	if (fixedLayout->size > 0) {
+		uint8_t* out = context.allocate(fixedLayout->size);
+		WriteToBuffer writeToBuffer{
+			context, fixedLayout->size, fixedLayout->vtable_start, out, fixedLayout->writeToOffsets.begin()
+		};
+		save_with_vtables(root, vtableset, writeToBuffer, &vtable_start, file_identifier, context);
+		return out;
+	}
+	PrecomputeSize<Context> precompute_size(context);
 	save_with_vtables(root, vtableset, precompute_size, &vtable_start, file_identifier, context);
+	if (fixedLayout->fixed) {
+		fixedLayout->size = precompute_size.current_buffer_size;
+		fixedLayout->vtable_start = vtable_start;
+		fixedLayout->writeToOffsets = precompute_size.writeToOffsets;
+	}
 	uint8_t* out = context.allocate(precompute_size.current_buffer_size);
 	WriteToBuffer writeToBuffer{
 		context, precompute_size.current_buffer_size, vtable_start, out, precompute_size.writeToOffsets.begin()
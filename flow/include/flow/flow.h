@@ -41,6 +41,7 @@
 #include <iostream>
 #include <string>
 #include <string_view>
+#include <typeinfo>
 #include <utility>
 #include <algorithm>
 #include <memory>
@@ -578,6 +579,30 @@ LineageReference getCurrentLineage();
 #endif
 void replaceLineage(LineageReference* lineage);
 
+// The mangled type name of the actor whose callback is running on this thread, or nullptr outside of actor callbacks.
+// Read by the run loop profiler's signal handler to attribute slow task samples to actors. Only maintained while
+// actorTypeNameReaders is nonzero, so that actor callbacks cost a single relaxed load when no profiler needs it.
+extern thread_local const char* currentActorTypeName;
+
+// The number of enabled profilers that read currentActorTypeName
+extern std::atomic<int> actorTypeNameReaders;
+
+struct ActorNameScope {
+	const char* oldName;
+	bool active;
+	explicit ActorNameScope(const char* name) : active(actorTypeNameReaders.load(std::memory_order_relaxed) > 0) {
+		if (active) {
+			oldName = currentActorTypeName;
+			currentActorTypeName = name;
+		}
+	}
+	~ActorNameScope() {
+		if (active) {
+			currentActorTypeName = oldName;
+		}
+	}
+};
+
 struct StackLineage : LineageProperties<StackLineage> {
 	static const std::string_view name;
 	StringRef actorName;
@@ -1310,12 +1335,14 @@ struct ActorCallback : Callback<ValueType> {
 #ifdef ENABLE_SAMPLING
 		LineageScope _(static_cast<ActorType*>(this)->lineageAddr());
 #endif
+		ActorNameScope actorName(typeid(ActorType).name());
 		static_cast<ActorType*>(this)->a_callback_fire(this, value);
 	}
 	virtual void error(Error e) override {
 #ifdef ENABLE_SAMPLING
 		LineageScope _(static_cast<ActorType*>(this)->lineageAddr());
 #endif
+		ActorNameScope actorName(typeid(ActorType).name());
 		static_cast<ActorType*>(this)->a_callback_error(this, e);
 	}
 };
@@ -1326,18 +1353,21 @@ struct ActorSingleCallback : SingleCallback<ValueType> {
 #ifdef ENABLE_SAMPLING
 		LineageScope _(static_cast<ActorType*>(this)->lineageAddr());
 #endif
+		ActorNameScope actorName(typeid(ActorType).name());
 		static_cast<ActorType*>(this)->a_callback_fire(this, value);
 	}
 	void fire(ValueType&& value) override {
 #ifdef ENABLE_SAMPLING
 		LineageScope _(static_cast<ActorType*>(this)->lineageAddr());
 #endif
+		ActorNameScope actorName(typeid(ActorType).name());
 		static_cast<ActorType*>(this)->a_callback_fire(this, std::move(value));
 	}
 	void error(Error e) override {
 #ifdef ENABLE_SAMPLING
 		LineageScope _(static_cast<ActorType*>(this)->lineageAddr());
 #endif
+		ActorNameScope actorName(typeid(ActorType).name());
 		static_cast<ActorType*>(this)->a_callback_error(this, e);
 	}
 };
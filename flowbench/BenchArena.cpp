@@ -0,0 +1,65 @@
+/*
+ * BenchArena.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/FDBTypes.h"
+#include "flow/Arena.h"
+#include "flowbench/GlobalData.h"
+
+static constexpr bool HINTED = true;
+static constexpr bool NOT_HINTED = false;
+
+// Benchmarks building the arena of a range read reply, as the storage server does, with and without sizing the arena
+// and the rows array from an ArenaSizeHint. Reports the arena blocks created per reply, and how many of them had to be
+// allocated rather than reused from the blocks recycled by the thread.
+template <bool hinted>
+static void bench_arena_reply(benchmark::State& state) {
+	size_t rows = state.range(0);
+	auto kv = getKV(16, state.range(1));
+	ArenaSizeHint arenaHint, rowsHint;
+	ArenaBlockCounts before = getArenaBlockCounts();
+	while (state.KeepRunning()) {
+		Arena arena(hinted ? arenaHint.reservedSize() : 0);
+		VectorRef<KeyValueRef> data;
+		if (hinted) {
+			data.reserve(arena, rowsHint.reservedSize() / sizeof(KeyValueRef));
+		}
+		for (int i = 0; i < rows; ++i) {
+			data.push_back_deep(arena, kv);
+		}
+		arenaHint.record(data.expectedSize());
+		rowsHint.record(data.size() * sizeof(KeyValueRef));
+		benchmark::DoNotOptimize(data);
+	}
+	ArenaBlockCounts after = getArenaBlockCounts();
+	double iterations = state.iterations();
+	state.counters["BlocksPerReply"] = (after.created - before.created) / iterations;
+	state.counters["AllocationsPerReply"] =
+	    (after.created - before.created - (after.recycled - before.recycled)) / iterations;
+	state.SetItemsProcessed(rows * static_cast<long>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(bench_arena_reply, NOT_HINTED)
+    ->Ranges({ { 1, 1 << 12 }, { 16, 1 << 10 } })
+    ->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_arena_reply, HINTED)
+    ->Ranges({ { 1, 1 << 12 }, { 16, 1 << 10 } })
+    ->ReportAggregatesOnly(true);
@@ -0,0 +1,108 @@
+/*
+ * BenchMetricSample.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/FDBTypes.h"
+#include "flow/IndexedBTree.h"
+#include "flow/IndexedSet.h"
+#include "flow/TreeBenchmark.h"
+
+// Benchmarks the containers that can hold a storage metric sample (such as the storage server's byte sample) with the
+// operations the storage server and data distribution perform on it.
+
+using SampleSet = IndexedSet<Key, int64_t>;
+using SampleBTree = IndexedBTree<Key, int64_t>;
+
+static std::vector<Key> sampleKeys(int count) {
+	Arena arena;
+	std::vector<Key> keys;
+	keys.reserve(count);
+	for (int i = 0; i < count; i++) {
+		keys.emplace_back(randomStr(arena));
+	}
+	return keys;
+}
+
+template <class Sample>
+static void populate(Sample& sample, const std::vector<Key>& keys) {
+	for (const auto& key : keys) {
+		sample.insert(key, deterministicRandom()->randomInt(1, 1000));
+	}
+}
+
+// Replaces and removes sampled keys, as StorageServer::byteSampleApplySet() does for sets of sampled keys
+template <class Sample>
+static void bench_metric_sample_update(benchmark::State& state) {
+	auto keys = sampleKeys(state.range(0));
+	Sample sample;
+	populate(sample, keys);
+	int i = 0;
+	while (state.KeepRunning()) {
+		const Key& key = keys[i++ % keys.size()];
+		auto old = sample.find(key);
+		int64_t delta = old != sample.end() ? -sample.getMetric(old) : 0;
+		if (deterministicRandom()->coinflip()) {
+			delta += 500;
+			sample.insert(key, 500);
+		} else {
+			sample.erase(old);
+		}
+		benchmark::DoNotOptimize(delta);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+// Estimates the metric of random ranges, as StorageMetricSample::getEstimate() does
+template <class Sample>
+static void bench_metric_sample_estimate(benchmark::State& state) {
+	auto keys = sampleKeys(state.range(0));
+	Sample sample;
+	populate(sample, keys);
+	int i = 0;
+	while (state.KeepRunning()) {
+		KeyRef a = keys[i++ % keys.size()];
+		KeyRef b = keys[i++ % keys.size()];
+		benchmark::DoNotOptimize(sample.sumRange(std::min(a, b), std::max(a, b)));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+// Finds the key at a metric offset from a random key, as StorageMetricSample::splitEstimate() and
+// StorageServerMetrics::getSplitPoints() do
+template <class Sample>
+static void bench_metric_sample_split(benchmark::State& state) {
+	auto keys = sampleKeys(state.range(0));
+	Sample sample;
+	populate(sample, keys);
+	int i = 0;
+	while (state.KeepRunning()) {
+		const Key& key = keys[i++ % keys.size()];
+		benchmark::DoNotOptimize(sample.index(sample.sumTo(sample.lower_bound(key)) + 100000));
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+}
+
+BENCHMARK_TEMPLATE(bench_metric_sample_update, SampleSet)->Range(1 << 10, 1 << 20)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_metric_sample_update, SampleBTree)->Range(1 << 10, 1 << 20)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_metric_sample_estimate, SampleSet)->Range(1 << 10, 1 << 20)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_metric_sample_estimate, SampleBTree)->Range(1 << 10, 1 << 20)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_metric_sample_split, SampleSet)->Range(1 << 10, 1 << 20)->ReportAggregatesOnly(true);
+BENCHMARK_TEMPLATE(bench_metric_sample_split, SampleBTree)->Range(1 << 10, 1 << 20)->ReportAggregatesOnly(true);
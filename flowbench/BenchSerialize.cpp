@@ -0,0 +1,147 @@
+/*
+ * BenchSerialize.cpp
+ *
+ * This source file is part of the FoundationDB open source project
+ *
+ * Copyright 2013-2022 Apple Inc. and the FoundationDB project authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "fdbclient/CommitProxyInterface.h"
+#include "fdbclient/StorageServerInterface.h"
+#include "flow/ObjectSerializer.h"
+#include "flow/ThreadHelper.actor.h"
+#include "flowbench/GlobalData.h"
+
+// Saving a request serializes its ReplyPromise, which registers an endpoint with FlowTransport, so messages are saved
+// on the network thread. Replies are sent as ErrorOr<EnsureTable<T>>, which is what is measured for them.
+template <class T>
+static void benchSave(benchmark::State& state, T const& msg) {
+	size_t size = 0;
+	onMainThread([&]() -> Future<Void> {
+		for (auto _ : state) {
+			Standalone<StringRef> value = ObjectWriter::toValue(msg, Unversioned());
+			size = value.size();
+			benchmark::DoNotOptimize(value);
+		}
+		return Void();
+	}).blockUntilReady();
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.counters["Size"] = size;
+}
+
+template <class T>
+static void benchSaveLoadReply(benchmark::State& state, T const& msg) {
+	ErrorOr<EnsureTable<T>> reply(msg);
+	Standalone<StringRef> value = ObjectWriter::toValue(reply, Unversioned());
+	for (auto _ : state) {
+		Standalone<StringRef> saved = ObjectWriter::toValue(reply, Unversioned());
+		ErrorOr<EnsureTable<T>> loaded;
+		ObjectReader reader(saved.begin(), Unversioned());
+		reader.deserialize(loaded);
+		benchmark::DoNotOptimize(loaded);
+	}
+	state.SetItemsProcessed(static_cast<long>(state.iterations()));
+	state.counters["Size"] = value.size();
+}
+
+static void bench_serialize_get_value_request(benchmark::State& state) {
+	GetValueRequest req(SpanContext(),
+	                    TenantInfo(),
+	                    getKey(state.range(0)),
+	                    1000,
+	                    Optional<TagSet>(),
+	                    Optional<UID>(),
+	                    VersionVector());
+	benchSave(state, req);
+}
+
+static void bench_serialize_get_value_reply(benchmark::State& state) {
+	benchSaveLoadReply(state, GetValueReply(Value(getKey(state.range(0))), false));
+}
+
+static void bench_serialize_get_key_request(benchmark::State& state) {
+	GetKeyRequest req(SpanContext(),
+	                  TenantInfo(),
+	                  firstGreaterOrEqual(getKey(state.range(0))),
+	                  1000,
+	                  Optional<TagSet>(),
+	                  Optional<UID>(),
+	                  VersionVector());
+	benchSave(state, req);
+}
+
+static void bench_serialize_get_key_reply(benchmark::State& state) {
+	Key key = getKey(state.range(0));
+	benchSaveLoadReply(state, GetKeyReply(firstGreaterOrEqual(key), false));
+}
+
+static void bench_serialize_get_key_values_request(benchmark::State& state) {
+	GetKeyValuesRequest req;
+	req.begin = firstGreaterOrEqual(KeyRef(req.arena, getKey(state.range(0))));
+	req.end = firstGreaterOrEqual(KeyRef(req.arena, getKey(state.range(0)).withSuffix("\xff"_sr)));
+	req.version = 1000;
+	req.limit = 1000;
+	req.limitBytes = 80000;
+	benchSave(state, req);
+}
+
+static void bench_serialize_get_key_values_reply(benchmark::State& state) {
+	GetKeyValuesReply reply;
+	for (int i = 0; i < state.range(0); i++) {
+		reply.data.push_back_deep(reply.arena, getKV(16, 100));
+	}
+	reply.version = 1000;
+	benchSaveLoadReply(state, reply);
+	state.counters["Rows"] = state.range(0);
+}
+
+static void bench_serialize_commit_request(benchmark::State& state) {
+	CommitTransactionRequest req;
+	for (int i = 0; i < state.range(0); i++) {
+		KeyValueRef kv = getKV(16, 100);
+		req.transaction.mutations.push_back_deep(req.arena, MutationRef(MutationRef::SetValue, kv.key, kv.value));
+		req.transaction.write_conflict_ranges.push_back_deep(req.arena, singleKeyRange(kv.key));
+	}
+	req.transaction.read_snapshot = 1000;
+	benchSave(state, req);
+	state.counters["Mutations"] = state.range(0);
+}
+
+static void bench_serialize_commit_id(benchmark::State& state) {
+	benchSaveLoadReply(state, CommitID(1000, 1, Optional<Value>()));
+}
+
+static void bench_serialize_get_read_version_request(benchmark::State& state) {
+	benchSave(state, GetReadVersionRequest(SpanContext(), 1, TransactionPriority::DEFAULT, 1000));
+}
+
+static void bench_serialize_get_read_version_reply(benchmark::State& state) {
+	GetReadVersionReply reply;
+	reply.version = 1000;
+	benchSaveLoadReply(state, reply);
+}
+
+BENCHMARK(bench_serialize_get_value_request)->Arg(16)->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_get_value_reply)->Ranges({ { 1, 1 << 12 } })->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_get_key_request)->Arg(16)->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_get_key_reply)->Arg(16)->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_get_key_values_request)->Arg(16)->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_get_key_values_reply)->Ranges({ { 1, 1 << 10 } })->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_commit_request)->Ranges({ { 1, 1 << 8 } })->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_commit_id)->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_get_read_version_request)->ReportAggregatesOnly(true);
+BENCHMARK(bench_serialize_get_read_version_reply)->ReportAggregatesOnly(true);